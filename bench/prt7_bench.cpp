@@ -0,0 +1,481 @@
+/**
+ * @file prt7_bench.cpp
+ * @brief Banco de pruebas de rendimiento del camino crítico del decodificador
+ *
+ * Genera un flujo sintético de tramas PRT-7 y mide por separado cada etapa:
+ * análisis de líneas, RotorDeMapeo::rotar, RotorDeMapeo::getMapeo,
+ * ListaDeCarga::insertarAlFinal, los reportes de salida y la decodificación
+ * completa con Decodificador::alimentar. Los resultados se emiten en CSV o
+ * JSON para poder comparar corridas.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <streambuf>
+
+#include "prt7/prt7.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+// ============================================================================
+// CONTEO DE ASIGNACIONES
+// ============================================================================
+
+static unsigned long long bytesAsignados = 0;   ///< Bytes pedidos a operator new
+static unsigned long long asignaciones = 0;     ///< Llamadas a operator new
+
+void* operator new(std::size_t tamano) {
+    bytesAsignados += tamano;
+    asignaciones++;
+    void* p = std::malloc(tamano ? tamano : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t tamano) {
+    return operator new(tamano);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief Memoria residente máxima del proceso hasta el momento
+ * @return Kilobytes del pico de RSS
+ */
+static long picoResidenteKB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS contadores;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &contadores, sizeof(contadores))) {
+        return static_cast<long>(contadores.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    #ifdef __APPLE__
+        return uso.ru_maxrss / 1024;
+    #else
+        return uso.ru_maxrss;
+    #endif
+#endif
+}
+
+// ============================================================================
+// GENERADOR DE FLUJOS SINTÉTICOS
+// ============================================================================
+
+/**
+ * @struct ParametrosBanco
+ * @brief Forma del flujo sintético y de la corrida
+ */
+struct ParametrosBanco {
+    long cargas;           ///< Tramas LOAD (longitud del mensaje)
+    double proporcionMap;  ///< Fracción de tramas MAP sobre el total (0 a <1)
+    long rotacionMaxima;   ///< Magnitud máxima de cada rotación
+    int repeticiones;      ///< Corridas por etapa (se informa la más rápida)
+    unsigned semilla;      ///< Semilla del generador
+    bool json;             ///< true para JSON, false para CSV
+
+    /**
+     * @brief Constructor con valores por defecto
+     */
+    ParametrosBanco()
+        : cargas(1000000), proporcionMap(0.1), rotacionMaxima(25), repeticiones(3),
+          semilla(12345), json(false) {}
+};
+
+/**
+ * @struct FlujoSintetico
+ * @brief Flujo generado en texto y en tramas ya analizadas
+ */
+struct FlujoSintetico {
+    char* texto;          ///< Texto PRT-7 (una trama por línea, termina en END)
+    size_t longitud;      ///< Bytes del texto
+    Trama* tramas;        ///< Las mismas tramas por valor (sin END)
+    char* crudos;         ///< Caracteres de las tramas LOAD, contiguos
+    long cantidad;        ///< Cantidad de tramas en el arreglo
+    long cargas;          ///< Tramas LOAD
+    long mapeos;          ///< Tramas MAP
+
+    FlujoSintetico() : texto(nullptr), longitud(0), tramas(nullptr), crudos(nullptr), cantidad(0), cargas(0), mapeos(0) {}
+
+    ~FlujoSintetico() {
+        delete[] texto;
+        delete[] tramas;
+        delete[] crudos;
+    }
+};
+
+/**
+ * @brief Generador xorshift32 (determinista y sin estado global)
+ * @param estado Estado del generador
+ * @return Siguiente valor pseudoaleatorio
+ */
+static unsigned siguienteAleatorio(unsigned& estado) {
+    estado ^= estado << 13;
+    estado ^= estado >> 17;
+    estado ^= estado << 5;
+    return estado;
+}
+
+/**
+ * @brief Genera el flujo sintético
+ * @param p Parámetros de la corrida
+ * @param flujo Flujo de salida
+ */
+static void generarFlujo(const ParametrosBanco& p, FlujoSintetico& flujo) {
+    long mapeos = static_cast<long>(p.cargas * p.proporcionMap / (1.0 - p.proporcionMap));
+    long total = p.cargas + mapeos;
+
+    flujo.tramas = new Trama[total];
+    flujo.texto = new char[total * 16 + 8];
+    flujo.crudos = new char[p.cargas];
+    flujo.cantidad = total;
+
+    unsigned estado = p.semilla ? p.semilla : 1;
+    long cargasRestantes = p.cargas;
+    long mapeosRestantes = mapeos;
+    size_t pos = 0;
+
+    for (long i = 0; i < total; i++) {
+        bool esMapeo = mapeosRestantes > 0 &&
+                       (cargasRestantes == 0 ||
+                        siguienteAleatorio(estado) % static_cast<unsigned>(cargasRestantes + mapeosRestantes) <
+                            static_cast<unsigned>(mapeosRestantes));
+
+        if (esMapeo) {
+            long magnitud = static_cast<long>(siguienteAleatorio(estado) % (p.rotacionMaxima + 1));
+            int rotacion = static_cast<int>((siguienteAleatorio(estado) & 1) ? magnitud : -magnitud);
+            flujo.tramas[i] = Trama::mapeo(rotacion);
+            pos += snprintf(flujo.texto + pos, 16, "M,%d\n", rotacion);
+            mapeosRestantes--;
+        } else {
+            unsigned r = siguienteAleatorio(estado) % 27;
+            char c = r == 26 ? ' ' : static_cast<char>('A' + r);
+            flujo.tramas[i] = Trama::carga(c);
+            flujo.crudos[p.cargas - cargasRestantes] = c;
+            if (c == ' ') {
+                memcpy(flujo.texto + pos, "L,Space\n", 8);
+                pos += 8;
+            } else {
+                flujo.texto[pos++] = 'L';
+                flujo.texto[pos++] = ',';
+                flujo.texto[pos++] = c;
+                flujo.texto[pos++] = '\n';
+            }
+            cargasRestantes--;
+        }
+    }
+
+    memcpy(flujo.texto + pos, "END\n", 4);
+    flujo.longitud = pos + 4;
+    flujo.cargas = p.cargas;
+    flujo.mapeos = mapeos;
+}
+
+// ============================================================================
+// MEDICIÓN DE ETAPAS
+// ============================================================================
+
+/**
+ * @class BufferNulo
+ * @brief streambuf que descarta todo, para medir la salida sin la consola
+ */
+class BufferNulo : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        return n;
+    }
+};
+
+/**
+ * @struct Resultado
+ * @brief Medición de una etapa
+ */
+struct Resultado {
+    const char* etapa;                 ///< Nombre de la etapa
+    long tramas;                       ///< Tramas (u operaciones) procesadas por corrida
+    double segundos;                   ///< Tiempo de la corrida más rápida
+    unsigned long long bytes;          ///< Bytes asignados en la corrida más rápida
+    unsigned long long asignaciones;   ///< Asignaciones en la corrida más rápida
+    long picoKB;                       ///< Pico de RSS del proceso tras la etapa
+};
+
+static volatile unsigned sumidero = 0;  ///< Evita que el compilador elimine el trabajo medido
+
+/**
+ * @brief Mide una etapa repitiéndola y conservando la corrida más rápida
+ * @param etapa Nombre de la etapa
+ * @param tramas Operaciones por corrida
+ * @param repeticiones Corridas
+ * @param cuerpo Función con el trabajo de la etapa
+ * @param contexto Datos para la función
+ * @return Medición
+ */
+static Resultado medir(const char* etapa, long tramas, int repeticiones,
+                       void (*cuerpo)(const FlujoSintetico&), const FlujoSintetico& contexto) {
+    Resultado r;
+    r.etapa = etapa;
+    r.tramas = tramas;
+    r.segundos = -1;
+    r.bytes = 0;
+    r.asignaciones = 0;
+
+    for (int i = 0; i < repeticiones; i++) {
+        unsigned long long bytesAntes = bytesAsignados;
+        unsigned long long asignacionesAntes = asignaciones;
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+
+        cuerpo(contexto);
+
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        if (r.segundos < 0 || segundos < r.segundos) {
+            r.segundos = segundos;
+            r.bytes = bytesAsignados - bytesAntes;
+            r.asignaciones = asignaciones - asignacionesAntes;
+        }
+    }
+
+    r.picoKB = picoResidenteKB();
+    return r;
+}
+
+/// Etapa: análisis de cada línea del texto
+static void etapaAnalisis(const FlujoSintetico& f) {
+    const char* datos = f.texto;
+    size_t inicio = 0;
+    unsigned acumulado = 0;
+    Trama t;
+
+    for (size_t i = 0; i < f.longitud; i++) {
+        if (datos[i] == '\n') {
+            if (analizarTrama(datos + inicio, static_cast<int>(i - inicio), t) == TRAMA_VALIDA) {
+                acumulado += static_cast<unsigned>(t.tipo);
+            }
+            inicio = i + 1;
+        }
+    }
+    sumidero = acumulado;
+}
+
+/// Etapa: RotorDeMapeo::rotar con todas las tramas MAP
+static void etapaRotar(const FlujoSintetico& f) {
+    RotorDeMapeo rotor;
+    for (long i = 0; i < f.cantidad; i++) {
+        if (f.tramas[i].tipo == TRAMA_MAP) {
+            rotor.rotar(f.tramas[i].rotacion);
+        }
+    }
+    sumidero = static_cast<unsigned>(rotor.getDesplazamiento());
+}
+
+/// Etapa: RotorDeMapeo::getMapeo con todas las tramas LOAD
+static void etapaMapeo(const FlujoSintetico& f) {
+    RotorDeMapeo rotor;
+    rotor.rotar(7);
+    unsigned acumulado = 0;
+    for (long i = 0; i < f.cantidad; i++) {
+        if (f.tramas[i].tipo == TRAMA_LOAD) {
+            acumulado += static_cast<unsigned char>(rotor.getMapeo(f.tramas[i].caracter));
+        }
+    }
+    sumidero = acumulado;
+}
+
+/// Etapa: RotorDeMapeo::mapearBloque y ListaDeCarga::insertarBloque sobre los LOAD contiguos
+static void etapaBloque(const FlujoSintetico& f) {
+    RotorDeMapeo rotor;
+    rotor.rotar(7);
+    ListaDeCarga carga;
+    char bloque[4096];
+    for (long i = 0; i < f.cargas; i += sizeof(bloque)) {
+        size_t n = f.cargas - i < static_cast<long>(sizeof(bloque)) ? f.cargas - i : sizeof(bloque);
+        rotor.mapearBloque(f.crudos + i, bloque, n);
+        carga.insertarBloque(bloque, n);
+    }
+    sumidero = carga.getCola() ? static_cast<unsigned>(carga.getCola()->usados) : 0;
+}
+
+/// Etapa: ListaDeCarga::insertarAlFinal con todas las tramas LOAD
+static void etapaInsertar(const FlujoSintetico& f) {
+    ListaDeCarga carga;
+    for (long i = 0; i < f.cantidad; i++) {
+        if (f.tramas[i].tipo == TRAMA_LOAD) {
+            carga.insertarAlFinal(f.tramas[i].caracter);
+        }
+    }
+    sumidero = carga.getCola() ? static_cast<unsigned>(carga.getCola()->usados) : 0;
+}
+
+/// Etapa: reportes por trama (nivel delta) hacia un flujo nulo
+static void etapaSalida(const FlujoSintetico& f) {
+    BufferNulo nulo;
+    std::ostream flujo(&nulo);
+    EscritorSalida salida(DETALLE_DELTA, flujo);
+    for (long i = 0; i < f.cantidad; i++) {
+        if (f.tramas[i].tipo == TRAMA_LOAD) {
+            reportarCarga(f.tramas[i].caracter, f.tramas[i].caracter, nullptr, salida);
+        } else {
+            reportarMapeo(f.tramas[i].rotacion, salida);
+        }
+    }
+    salida.vaciar();
+}
+
+/// Etapa: decodificación completa del texto, sin reportes
+static void etapaCompleta(const FlujoSintetico& f) {
+    Decodificador* decodificador = new Decodificador(DETALLE_SILENCIOSO);
+    decodificador->alimentar(f.texto, f.longitud);
+    decodificador->finalizar();
+    sumidero = static_cast<unsigned>(decodificador->getTramasRecibidas());
+    delete decodificador;
+}
+
+// ============================================================================
+// REPORTE
+// ============================================================================
+
+/**
+ * @brief Escribe los resultados
+ * @param p Parámetros de la corrida
+ * @param f Flujo medido
+ * @param resultados Mediciones
+ * @param cantidad Cantidad de mediciones
+ */
+static void reportar(const ParametrosBanco& p, const FlujoSintetico& f,
+                     const Resultado* resultados, int cantidad) {
+    if (p.json) {
+        std::printf("{\n  \"cargas\": %ld, \"mapeos\": %ld, \"bytes\": %lu, \"rotacion_maxima\": %ld,\n",
+                    f.cargas, f.mapeos, static_cast<unsigned long>(f.longitud), p.rotacionMaxima);
+        std::printf("  \"nucleo\": \"%s\",\n", nucleoMapeoVectorial());
+        std::printf("  \"etapas\": [\n");
+    } else {
+        std::printf("etapa,tramas,segundos,tramas_por_s,ns_por_trama,bytes_asignados,asignaciones,pico_rss_kb\n");
+    }
+
+    for (int i = 0; i < cantidad; i++) {
+        const Resultado& r = resultados[i];
+        double porSegundo = r.segundos > 0 ? r.tramas / r.segundos : 0;
+        double nsPorTrama = r.tramas > 0 ? r.segundos * 1e9 / r.tramas : 0;
+
+        if (p.json) {
+            std::printf("    {\"etapa\": \"%s\", \"tramas\": %ld, \"segundos\": %.6f, "
+                        "\"tramas_por_s\": %.0f, \"ns_por_trama\": %.3f, \"bytes_asignados\": %llu, "
+                        "\"asignaciones\": %llu, \"pico_rss_kb\": %ld}%s\n",
+                        r.etapa, r.tramas, r.segundos, porSegundo, nsPorTrama, r.bytes,
+                        r.asignaciones, r.picoKB, i + 1 < cantidad ? "," : "");
+        } else {
+            std::printf("%s,%ld,%.6f,%.0f,%.3f,%llu,%llu,%ld\n", r.etapa, r.tramas, r.segundos,
+                        porSegundo, nsPorTrama, r.bytes, r.asignaciones, r.picoKB);
+        }
+    }
+
+    if (p.json) {
+        std::printf("  ]\n}\n");
+    }
+}
+
+/**
+ * @brief Muestra las opciones del banco de pruebas
+ * @param programa Nombre del ejecutable
+ */
+static void mostrarUso(const char* programa) {
+    std::printf("Uso: %s [opciones]\n", programa);
+    std::printf("  --loads <n>         Tramas LOAD / longitud del mensaje (por defecto 1000000)\n");
+    std::printf("  --map-ratio <r>     Fraccion de tramas MAP, 0 a 0.99 (por defecto 0.1)\n");
+    std::printf("  --max-rotation <n>  Magnitud maxima de cada rotacion (por defecto 25)\n");
+    std::printf("  --repeat <n>        Corridas por etapa (por defecto 3)\n");
+    std::printf("  --seed <n>          Semilla del generador\n");
+    std::printf("  --format <f>        csv (por defecto) o json\n");
+}
+
+/**
+ * @brief Punto de entrada del banco de pruebas
+ * @param argc Cantidad de argumentos
+ * @param argv Argumentos (ver mostrarUso())
+ * @return 0 si la corrida terminó
+ */
+int main(int argc, char* argv[]) {
+    ParametrosBanco p;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opcion = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(opcion, "--help") == 0) {
+            mostrarUso(argv[0]);
+            return 0;
+        }
+        if (!valor) {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+        i++;
+
+        if (strcmp(opcion, "--loads") == 0) {
+            p.cargas = std::atol(valor);
+        } else if (strcmp(opcion, "--map-ratio") == 0) {
+            p.proporcionMap = std::atof(valor);
+        } else if (strcmp(opcion, "--max-rotation") == 0) {
+            p.rotacionMaxima = std::atol(valor);
+        } else if (strcmp(opcion, "--repeat") == 0) {
+            p.repeticiones = std::atoi(valor);
+        } else if (strcmp(opcion, "--seed") == 0) {
+            p.semilla = static_cast<unsigned>(std::strtoul(valor, nullptr, 10));
+        } else if (strcmp(opcion, "--format") == 0 && (strcmp(valor, "csv") == 0 || strcmp(valor, "json") == 0)) {
+            p.json = strcmp(valor, "json") == 0;
+        } else {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+    }
+
+    if (p.cargas < 1 || p.proporcionMap < 0 || p.proporcionMap >= 1 || p.rotacionMaxima < 0 ||
+        p.rotacionMaxima > 2147483647L || p.repeticiones < 1) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+
+    FlujoSintetico flujo;
+    generarFlujo(p, flujo);
+
+    Resultado resultados[7];
+    int n = 0;
+    resultados[n++] = medir("analisis", flujo.cantidad + 1, p.repeticiones, etapaAnalisis, flujo);
+    resultados[n++] = medir("rotar", flujo.mapeos, p.repeticiones, etapaRotar, flujo);
+    resultados[n++] = medir("getMapeo", flujo.cargas, p.repeticiones, etapaMapeo, flujo);
+    resultados[n++] = medir("insertarAlFinal", flujo.cargas, p.repeticiones, etapaInsertar, flujo);
+    resultados[n++] = medir("mapearBloque", flujo.cargas, p.repeticiones, etapaBloque, flujo);
+    resultados[n++] = medir("salida", flujo.cantidad, p.repeticiones, etapaSalida, flujo);
+    resultados[n++] = medir("completo", flujo.cantidad + 1, p.repeticiones, etapaCompleta, flujo);
+
+    reportar(p, flujo, resultados, n);
+    return 0;
+}
@@ -0,0 +1,449 @@
+/**
+ * @file prt7_stress.cpp
+ * @brief Generador de flujos hostiles y medición del analizador con ellos
+ *
+ * Un puerto serial ruidoso o un emisor defectuoso entrega líneas que no
+ * siguen la gramática: bytes al azar, tramas cortadas, rotaciones con
+ * cientos de dígitos, líneas sin fin. Este programa genera flujos de cada
+ * tipo, los decodifica completos y mide cuánto tarda cada uno, para
+ * comprobar que el camino rápido sigue siéndolo cuando casi todo lo que
+ * llega es basura. Además verifica que los contadores cuadren y que el
+ * rotor siga siendo una permutación tras rotaciones extremas; una
+ * inconsistencia termina con código 2. Con --min-mbps, un flujo más lento
+ * que el umbral termina con código 1, para usarlo como control en CI.
+ */
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "prt7/prt7.h"
+
+// ============================================================================
+// GENERADOR DE FLUJOS HOSTILES
+// ============================================================================
+
+/**
+ * @struct ParametrosEstres
+ * @brief Forma de los flujos y de la corrida
+ */
+struct ParametrosEstres {
+    size_t bytes;       ///< Bytes aproximados de cada flujo
+    double ruido;       ///< Fracción de líneas mal formadas en el flujo "mixto"
+    int repeticiones;   ///< Corridas por flujo (se informa la más rápida)
+    unsigned semilla;   ///< Semilla del generador
+    double minimoMBs;   ///< Rendimiento mínimo aceptado en MB/s (0 = sin control)
+    bool json;          ///< true para JSON, false para CSV
+
+    /**
+     * @brief Constructor con valores por defecto
+     */
+    ParametrosEstres()
+        : bytes(16u << 20), ruido(0.5), repeticiones(3), semilla(12345), minimoMBs(0), json(false) {}
+};
+
+/**
+ * @enum TipoFlujo
+ * @brief Clases de flujo que se generan
+ */
+enum TipoFlujo {
+    FLUJO_LIMPIO,     ///< Sólo tramas válidas, como referencia
+    FLUJO_MIXTO,      ///< Tramas válidas intercaladas con líneas mal formadas
+    FLUJO_BASURA,     ///< Bytes al azar (incluidos '\0' y bytes altos)
+    FLUJO_DIGITOS,    ///< Rotaciones con muchos dígitos, ceros a la izquierda y desbordes
+    FLUJO_LARGAS,     ///< Líneas más largas que cualquier buffer de línea
+    FLUJO_CORTADAS,   ///< Prefijos de tramas válidas ("L,", "M,-", "EN", "L,Spac")
+    FLUJO_BINARIO,    ///< Bytes al azar decodificados como FORMATO_BINARIO
+    CANTIDAD_FLUJOS
+};
+
+/// Nombres de los flujos en el reporte
+static const char* const NOMBRES_FLUJOS[CANTIDAD_FLUJOS] = {
+    "limpio", "mixto", "basura", "digitos", "largas", "cortadas", "binario"
+};
+
+/**
+ * @brief Generador xorshift32 (determinista y sin estado global)
+ * @param estado Estado del generador
+ * @return Siguiente valor pseudoaleatorio
+ */
+static unsigned siguienteAleatorio(unsigned& estado) {
+    estado ^= estado << 13;
+    estado ^= estado >> 17;
+    estado ^= estado << 5;
+    return estado;
+}
+
+/**
+ * @brief Escribe una trama válida al azar
+ * @param destino Donde escribirla (al menos 24 bytes libres)
+ * @param estado Estado del generador
+ * @return Bytes escritos, con el fin de línea
+ */
+static int escribirValida(char* destino, unsigned& estado) {
+    unsigned r = siguienteAleatorio(estado);
+    if (r % 5 == 0) {
+        int rotacion = static_cast<int>(siguienteAleatorio(estado) % 51) - 25;
+        return snprintf(destino, 24, "M,%d\n", rotacion);
+    }
+    if (r % 37 == 1) {
+        memcpy(destino, "L,Space\n", 8);
+        return 8;
+    }
+    destino[0] = 'L';
+    destino[1] = ',';
+    destino[2] = static_cast<char>('A' + siguienteAleatorio(estado) % 26);
+    destino[3] = '\n';
+    return 4;
+}
+
+/**
+ * @brief Escribe una línea mal formada de la clase indicada
+ * @param tipo Clase de flujo
+ * @param destino Donde escribirla
+ * @param libres Bytes disponibles
+ * @param estado Estado del generador
+ * @return Bytes escritos, con el fin de línea
+ */
+static size_t escribirHostil(TipoFlujo tipo, char* destino, size_t libres, unsigned& estado) {
+    static const char* const CORTADAS[] = {"L,", "L", "M,", "M,-", "M,+", "M,1,", "M,,", "E", "EN", "ENDX",
+                                            "L,Spac", "L,Spacex", "L,AB", "X,1", ",", "M,1,2,3"};
+    static const int CANTIDAD_CORTADAS = sizeof(CORTADAS) / sizeof(CORTADAS[0]);
+    size_t n = 0;
+
+    switch (tipo) {
+        case FLUJO_MIXTO:
+        case FLUJO_CORTADAS:
+            if (tipo == FLUJO_MIXTO && siguienteAleatorio(estado) % 2 == 0) {
+                // La mitad del ruido mixto son líneas de bytes al azar
+                n = 1 + siguienteAleatorio(estado) % 40;
+                for (size_t i = 0; i < n; i++) {
+                    char c = static_cast<char>(siguienteAleatorio(estado));
+                    destino[i] = (c == '\n' || c == '\r') ? '#' : c;
+                }
+                break;
+            }
+            {
+                const char* s = CORTADAS[siguienteAleatorio(estado) % CANTIDAD_CORTADAS];
+                n = strlen(s);
+                memcpy(destino, s, n);
+            }
+            break;
+
+        case FLUJO_DIGITOS: {
+            // Entre 10 y 300 dígitos: desbordan o se rechazan por largos
+            size_t digitos = 10 + siguienteAleatorio(estado) % 291;
+            destino[n++] = 'M';
+            destino[n++] = ',';
+            if (siguienteAleatorio(estado) & 1) destino[n++] = '-';
+            for (size_t i = 0; i < digitos; i++) {
+                destino[n++] = static_cast<char>('0' + siguienteAleatorio(estado) % 10);
+            }
+            break;
+        }
+
+        case FLUJO_LARGAS: {
+            // Hasta 3 veces el buffer del lector sin un solo fin de línea
+            size_t largo = LONGITUD_MAXIMA_TRAMA + siguienteAleatorio(estado) % (3 * LectorSerial::CAPACIDAD);
+            if (largo > libres - 1) largo = libres - 1;
+            destino[n++] = 'L';
+            destino[n++] = ',';
+            memset(destino + n, 'A' + siguienteAleatorio(estado) % 26, largo - n);
+            n = largo;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    destino[n++] = '\n';
+    return n;
+}
+
+/**
+ * @brief Genera un flujo de una clase
+ * @param tipo Clase de flujo
+ * @param p Parámetros de la corrida
+ * @param longitud Bytes generados
+ * @return Flujo (liberar con delete[])
+ */
+static char* generarFlujo(TipoFlujo tipo, const ParametrosEstres& p, size_t& longitud) {
+    // Margen para la última línea larga y el END final
+    size_t capacidad = p.bytes + 4 * LectorSerial::CAPACIDAD;
+    char* flujo = new char[capacidad];
+    unsigned estado = (p.semilla ? p.semilla : 1) + static_cast<unsigned>(tipo) * 7919u;
+    size_t pos = 0;
+
+    if (tipo == FLUJO_BASURA || tipo == FLUJO_BINARIO) {
+        for (; pos < p.bytes; pos++) {
+            flujo[pos] = static_cast<char>(siguienteAleatorio(estado) >> 7);
+        }
+        if (tipo == FLUJO_BASURA) {
+            // Sin 'E' no puede formarse al azar un END que corte el flujo
+            for (size_t i = 0; i < pos; i++) {
+                if (flujo[i] == 'E') flujo[i] = 'e';
+            }
+        } else {
+            // Sin la etiqueta de END, el flujo binario se decodifica entero
+            for (size_t i = 0; i < pos; i++) {
+                if (flujo[i] == static_cast<char>(AnalizadorBinario::ETIQUETA_FIN)) flujo[i] = 0;
+            }
+        }
+        longitud = pos;
+        return flujo;
+    }
+
+    // Fracción de líneas mal formadas: 0 en el limpio, p.ruido en el mixto, casi todas en el resto
+    unsigned umbral = tipo == FLUJO_LIMPIO ? 0 : (tipo == FLUJO_MIXTO ? static_cast<unsigned>(p.ruido * 1000) : 900);
+    while (pos < p.bytes) {
+        if (siguienteAleatorio(estado) % 1000 < umbral) {
+            pos += escribirHostil(tipo, flujo + pos, capacidad - pos - 8, estado);
+        } else {
+            pos += escribirValida(flujo + pos, estado);
+        }
+    }
+    memcpy(flujo + pos, "END\n", 4);
+    longitud = pos + 4;
+    return flujo;
+}
+
+// ============================================================================
+// MEDICIÓN
+// ============================================================================
+
+/**
+ * @struct Resultado
+ * @brief Medición de un flujo
+ */
+struct Resultado {
+    const char* flujo;       ///< Nombre del flujo
+    size_t bytes;            ///< Bytes del flujo
+    long long recibidas;     ///< Tramas válidas
+    long long malformadas;   ///< Líneas o tramas descartadas
+    double segundos;         ///< Tiempo de la corrida más rápida
+};
+
+/**
+ * @brief Termina con código 2 si no se cumple una condición
+ * @param condicion Condición esperada
+ * @param descripcion Qué se esperaba
+ */
+static void verificar(bool condicion, const char* descripcion) {
+    if (!condicion) {
+        fprintf(stderr, "prt7_stress: %s\n", descripcion);
+        exit(2);
+    }
+}
+
+/**
+ * @brief Decodifica un flujo varias veces y conserva la corrida más rápida
+ * @param tipo Clase de flujo
+ * @param p Parámetros de la corrida
+ * @return Medición
+ */
+static Resultado medirFlujo(TipoFlujo tipo, const ParametrosEstres& p) {
+    size_t longitud = 0;
+    char* flujo = generarFlujo(tipo, p, longitud);
+
+    Resultado r;
+    r.flujo = NOMBRES_FLUJOS[tipo];
+    r.bytes = longitud;
+    r.segundos = -1;
+
+    for (int i = 0; i < p.repeticiones; i++) {
+        Decodificador* d = new Decodificador(DETALLE_SILENCIOSO);
+        d->setFormato(tipo == FLUJO_BINARIO ? FORMATO_BINARIO : FORMATO_TEXTO);
+
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        // Por bloques como llegan de un puerto, para pasar también por la línea partida
+        for (size_t pos = 0; pos < longitud; pos += LectorSerial::CAPACIDAD) {
+            size_t n = longitud - pos < static_cast<size_t>(LectorSerial::CAPACIDAD) ? longitud - pos
+                                                                                      : LectorSerial::CAPACIDAD;
+            if (!d->alimentar(flujo + pos, n)) break;
+        }
+        d->finalizar();
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        verificar(static_cast<long long>(d->getCarga().getLongitud()) == d->getTramasCarga(),
+                  "el mensaje no tiene un caracter por trama LOAD");
+        verificar(tipo == FLUJO_BINARIO || tipo == FLUJO_BASURA || d->haTerminado(), "no se reconocio el END final");
+
+        if (r.segundos < 0 || segundos < r.segundos) {
+            r.segundos = segundos;
+        }
+        r.recibidas = d->getTramasRecibidas();
+        r.malformadas = d->getTramasMalformadas();
+        delete d;
+    }
+
+    delete[] flujo;
+    return r;
+}
+
+/**
+ * @brief Rota el rotor con valores extremos y comprueba que siga siendo una permutación
+ * @param p Parámetros de la corrida
+ * @return Medición (bytes = rotaciones aplicadas)
+ */
+static Resultado medirRotaciones(const ParametrosEstres& p) {
+    static const int EXTREMOS[] = {INT_MIN, INT_MIN + 1, -1, 0, 1, INT_MAX - 1, INT_MAX,
+                                   RotorDeMapeo::TAMANO_ANILLO, -RotorDeMapeo::TAMANO_ANILLO};
+    static const int CANTIDAD_EXTREMOS = sizeof(EXTREMOS) / sizeof(EXTREMOS[0]);
+    long cantidad = static_cast<long>(p.bytes / 4);
+
+    Resultado r;
+    r.flujo = "rotaciones";
+    r.bytes = static_cast<size_t>(cantidad);
+    r.recibidas = cantidad;
+    r.malformadas = 0;
+    r.segundos = -1;
+
+    for (int i = 0; i < p.repeticiones; i++) {
+        RotorDeMapeo rotor;
+        unsigned estado = p.semilla ? p.semilla : 1;
+        long long esperado = 0;
+
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        for (long k = 0; k < cantidad; k++) {
+            unsigned a = siguienteAleatorio(estado);
+            int n = (a & 3) == 0 ? EXTREMOS[(a >> 2) % CANTIDAD_EXTREMOS] : static_cast<int>(a);
+            rotor.rotar(n);
+            esperado = (esperado + n % RotorDeMapeo::TAMANO_ANILLO + RotorDeMapeo::TAMANO_ANILLO) %
+                       RotorDeMapeo::TAMANO_ANILLO;
+        }
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        // La posición final debe ser la suma módulo el anillo y el mapeo una permutación
+        bool vistos[RotorDeMapeo::TAMANO_ANILLO];
+        memset(vistos, 0, sizeof(vistos));
+        for (int c = 0; c < RotorDeMapeo::TAMANO_ANILLO; c++) {
+            char m = rotor.getMapeo(static_cast<char>('A' + c));
+            verificar(m >= 'A' && m <= 'Z' && !vistos[m - 'A'], "el rotor dejo de ser una permutacion");
+            vistos[m - 'A'] = true;
+        }
+        verificar(rotor.getMapeo('A') == static_cast<char>('A' + esperado), "el rotor no quedo en la suma de las rotaciones");
+
+        if (r.segundos < 0 || segundos < r.segundos) {
+            r.segundos = segundos;
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief Escribe los resultados
+ * @param p Parámetros de la corrida
+ * @param resultados Mediciones
+ * @param cantidad Cantidad de mediciones
+ */
+static void reportar(const ParametrosEstres& p, const Resultado* resultados, int cantidad) {
+    if (p.json) {
+        std::printf("{\n  \"ruido\": %.3f, \"semilla\": %u,\n  \"flujos\": [\n", p.ruido, p.semilla);
+    } else {
+        std::printf("flujo,bytes,validas,malformadas,segundos,mb_por_s,lineas_por_s\n");
+    }
+
+    for (int i = 0; i < cantidad; i++) {
+        const Resultado& r = resultados[i];
+        double mbs = r.segundos > 0 ? r.bytes / r.segundos / 1e6 : 0;
+        double lineas = r.segundos > 0 ? (r.recibidas + r.malformadas) / r.segundos : 0;
+
+        if (p.json) {
+            std::printf("    {\"flujo\": \"%s\", \"bytes\": %lu, \"validas\": %lld, \"malformadas\": %lld, "
+                        "\"segundos\": %.6f, \"mb_por_s\": %.1f, \"lineas_por_s\": %.0f}%s\n",
+                        r.flujo, static_cast<unsigned long>(r.bytes), r.recibidas, r.malformadas, r.segundos,
+                        mbs, lineas, i + 1 < cantidad ? "," : "");
+        } else {
+            std::printf("%s,%lu,%lld,%lld,%.6f,%.1f,%.0f\n", r.flujo, static_cast<unsigned long>(r.bytes),
+                        r.recibidas, r.malformadas, r.segundos, mbs, lineas);
+        }
+    }
+
+    if (p.json) {
+        std::printf("  ]\n}\n");
+    }
+}
+
+/**
+ * @brief Muestra las opciones del generador
+ * @param programa Nombre del ejecutable
+ */
+static void mostrarUso(const char* programa) {
+    std::printf("Uso: %s [opciones]\n", programa);
+    std::printf("  --bytes <n>         Bytes de cada flujo (por defecto 16777216)\n");
+    std::printf("  --noise <r>         Fraccion de lineas mal formadas del flujo mixto, 0 a 1 (por defecto 0.5)\n");
+    std::printf("  --repeat <n>        Corridas por flujo (por defecto 3)\n");
+    std::printf("  --seed <n>          Semilla del generador\n");
+    std::printf("  --min-mbps <x>      Termina con codigo 1 si algun flujo rinde menos de x MB/s\n");
+    std::printf("  --format <f>        csv (por defecto) o json\n");
+}
+
+/**
+ * @brief Punto de entrada del generador
+ * @param argc Cantidad de argumentos
+ * @param argv Argumentos (ver mostrarUso())
+ * @return 0 si todo cuadró, 1 si algún flujo quedó bajo --min-mbps, 2 ante una inconsistencia
+ */
+int main(int argc, char* argv[]) {
+    ParametrosEstres p;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opcion = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(opcion, "--help") == 0) {
+            mostrarUso(argv[0]);
+            return 0;
+        }
+        if (!valor) {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+        i++;
+
+        if (strcmp(opcion, "--bytes") == 0) {
+            p.bytes = static_cast<size_t>(std::strtoull(valor, nullptr, 10));
+        } else if (strcmp(opcion, "--noise") == 0) {
+            p.ruido = std::atof(valor);
+        } else if (strcmp(opcion, "--repeat") == 0) {
+            p.repeticiones = std::atoi(valor);
+        } else if (strcmp(opcion, "--seed") == 0) {
+            p.semilla = static_cast<unsigned>(std::strtoul(valor, nullptr, 10));
+        } else if (strcmp(opcion, "--min-mbps") == 0) {
+            p.minimoMBs = std::atof(valor);
+        } else if (strcmp(opcion, "--format") == 0 && (strcmp(valor, "csv") == 0 || strcmp(valor, "json") == 0)) {
+            p.json = strcmp(valor, "json") == 0;
+        } else {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+    }
+
+    if (p.bytes < 1024 || p.ruido < 0 || p.ruido > 1 || p.repeticiones < 1 || p.minimoMBs < 0) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+
+    Resultado resultados[CANTIDAD_FLUJOS + 1];
+    int n = 0;
+    for (int t = 0; t < CANTIDAD_FLUJOS; t++) {
+        resultados[n++] = medirFlujo(static_cast<TipoFlujo>(t), p);
+    }
+    resultados[n++] = medirRotaciones(p);
+
+    reportar(p, resultados, n);
+
+    int codigo = 0;
+    // Las rotaciones no se miden en bytes: el umbral sólo se aplica a los flujos
+    for (int i = 0; i < CANTIDAD_FLUJOS && p.minimoMBs > 0; i++) {
+        double mbs = resultados[i].segundos > 0 ? resultados[i].bytes / resultados[i].segundos / 1e6 : 0;
+        if (mbs < p.minimoMBs) {
+            fprintf(stderr, "prt7_stress: %s rinde %.1f MB/s, por debajo de %.1f\n", resultados[i].flujo, mbs, p.minimoMBs);
+            codigo = 1;
+        }
+    }
+    return codigo;
+}
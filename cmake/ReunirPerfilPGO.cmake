@@ -0,0 +1,41 @@
+# Reúne el perfil de una compilación instrumentada de PGO para la compilación optimizada.
+#
+# Se ejecuta con cmake -P desde el objetivo prt7_perfil_pgo (PRT7_PGO=ON):
+#   ORIGEN             Directorio de la compilación instrumentada ya entrenada
+#   DESTINO            Directorio de la compilación optimizada
+#   DIRECTORIO_PERFIL  PRT7_PGO_DIR, donde Clang dejó los .profraw
+#   COMPILADOR         CMAKE_CXX_COMPILER_ID
+#
+# GCC escribe un .gcda junto a cada objeto y lo busca en el mismo lugar al
+# optimizar: como ambas compilaciones tienen los mismos objetivos, basta con
+# copiar el árbol de .gcda. Clang escribe .profraw que se combinan en un
+# único prt7.profdata con llvm-profdata.
+
+if(COMPILADOR MATCHES "Clang")
+    find_program(LLVM_PROFDATA NAMES llvm-profdata llvm-profdata-19 llvm-profdata-18 llvm-profdata-17
+                                     llvm-profdata-16 llvm-profdata-15 llvm-profdata-14)
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "No se encontró llvm-profdata para combinar el perfil de PGO")
+    endif()
+
+    file(GLOB crudos "${DIRECTORIO_PERFIL}/*.profraw")
+    if(NOT crudos)
+        message(FATAL_ERROR "El entrenamiento no dejó perfiles en ${DIRECTORIO_PERFIL}")
+    endif()
+    execute_process(COMMAND ${LLVM_PROFDATA} merge -o "${DIRECTORIO_PERFIL}/prt7.profdata" ${crudos}
+                    RESULT_VARIABLE resultado)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "llvm-profdata merge falló (${resultado})")
+    endif()
+else()
+    file(GLOB_RECURSE perfiles RELATIVE "${ORIGEN}" "${ORIGEN}/CMakeFiles/*.gcda")
+    if(NOT perfiles)
+        message(FATAL_ERROR "El entrenamiento no dejó archivos .gcda en ${ORIGEN}")
+    endif()
+    foreach(perfil ${perfiles})
+        get_filename_component(directorio "${DESTINO}/${perfil}" DIRECTORY)
+        file(COPY "${ORIGEN}/${perfil}" DESTINATION "${directorio}")
+    endforeach()
+    list(LENGTH perfiles cantidad)
+    message(STATUS "Perfil de PGO: ${cantidad} archivos .gcda copiados")
+endif()
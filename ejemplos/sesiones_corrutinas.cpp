@@ -0,0 +1,121 @@
+/**
+ * @file sesiones_corrutinas.cpp
+ * @brief Ejemplo: varias sesiones PRT-7 en un solo hilo con poll() y co_await
+ *
+ * Cada argumento es un puerto, una tubería o una captura. Un único bucle
+ * poll() vigila todos los descriptores y avisa a la SesionAsincrona que
+ * tenga datos; una corrutina por sesión cuenta las tramas con EsperaTrama
+ * y, con EsperaMensaje, muestra el mensaje al terminar. Ningún hilo queda
+ * bloqueado en la lectura de un puerto en particular.
+ *
+ * Uso: prt7_sesiones_corrutinas <flujo> [<flujo> ...]
+ */
+
+#include <cstdio>
+#include <exception>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "prt7/prt7.h"
+
+#ifndef PRT7_CORRUTINAS
+    #error "Este ejemplo requiere C++20 con soporte de corrutinas"
+#endif
+
+/**
+ * @struct Tarea
+ * @brief Corrutina que arranca enseguida y se libera sola al terminar
+ *
+ * Es el tipo de tarea más simple posible; una aplicación real usaría el de
+ * su propio bucle de eventos.
+ */
+struct Tarea {
+    struct promise_type {
+        Tarea get_return_object() { return Tarea(); }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/**
+ * @brief Consume una sesión: cuenta sus tramas y muestra el mensaje
+ * @param sesion Sesión a consumir
+ * @param nombre Nombre del flujo para el reporte
+ * @param activas Sesiones aún sin terminar (se descuenta al final)
+ */
+static Tarea consumir(SesionAsincrona& sesion, const char* nombre, int& activas) {
+    long long cargas = 0;
+    long long mapeos = 0;
+    Trama trama;
+
+    while (co_await EsperaTrama(sesion, trama)) {
+        if (trama.tipo == TRAMA_LOAD) cargas++;
+        else if (trama.tipo == TRAMA_MAP) mapeos++;
+    }
+
+    ListaDeCarga& mensaje = co_await EsperaMensaje(sesion);
+    printf("%s: %lld LOAD, %lld MAP, %zu caracteres: ", nombre, cargas, mapeos, mensaje.getLongitud());
+    for (int b = 0; b < mensaje.getCantidadBloques(); b++) {
+        const char* datos;
+        size_t cantidad = mensaje.getBloque(b, datos);
+        fwrite(datos, 1, cantidad, stdout);
+    }
+    printf("\n");
+    activas--;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s <flujo> [<flujo> ...]\n", argv[0]);
+        return 1;
+    }
+
+    int cantidad = argc - 1;
+    Decodificador* decodificadores = new Decodificador[cantidad];
+    SesionAsincrona** sesiones = new SesionAsincrona*[cantidad];
+    struct pollfd* fds = new struct pollfd[cantidad];
+    int activas = 0;
+
+    for (int i = 0; i < cantidad; i++) {
+        int fd = open(argv[i + 1], O_RDONLY | O_NONBLOCK);
+        if (fd < 0) {
+            perror(argv[i + 1]);
+        }
+        sesiones[i] = new SesionAsincrona(decodificadores[i], fd, true);
+        fds[i].fd = fd;
+        fds[i].events = POLLIN;
+        if (fd >= 0) {
+            activas++;
+            consumir(*sesiones[i], argv[i + 1], activas);
+        }
+    }
+
+    while (activas > 0) {
+        if (poll(fds, cantidad, -1) < 0) {
+            perror("poll");
+            break;
+        }
+        for (int i = 0; i < cantidad; i++) {
+            if (fds[i].fd < 0 || fds[i].revents == 0) continue;
+
+            if (!sesiones[i]->atenderLectura()) {
+                // Terminada: la corrutina ya se reanudó; sacar el descriptor del bucle
+                close(fds[i].fd);
+                fds[i].fd = -1;
+            }
+        }
+    }
+
+    for (int i = 0; i < cantidad; i++) {
+        if (fds[i].fd >= 0) close(fds[i].fd);
+        delete sesiones[i];
+    }
+    delete[] fds;
+    delete[] sesiones;
+    delete[] decodificadores;
+    return 0;
+}
@@ -0,0 +1,423 @@
+/**
+ * @file prt7_fuzz.cpp
+ * @brief Objetivo de fuzzing del analizador de tramas y de la sesión de decodificación
+ *
+ * Cada entrada se trata como flujo de texto y como flujo binario, y se
+ * comprueba que caminos que deben coincidir coincidan:
+ * - cada trama válida, escrita de nuevo en su forma canónica, se vuelve a
+ *   analizar igual;
+ * - alimentar la sesión de una vez, en bloques de tamaño arbitrario o a
+ *   través de un LectorSerial da el mismo mensaje y los mismos contadores;
+ * - el camino silencioso (rachas agrupadas) y el de reportes (trama por
+ *   trama) dan el mismo mensaje, con el rotor único y con una cadena;
+ * - el mensaje tiene un carácter por trama LOAD y el rotor sigue siendo
+ *   una permutación del alfabeto después de cualquier rotación, con
+ *   getInverso() como su inversa;
+ * - la entrada, tomada como mensaje, sale igual de la ida y vuelta por el
+ *   codificador cuando todos sus caracteres son representables;
+ * - una sesión guardada con PuntoControl al final de un prefijo (cortado a
+ *   mitad de una línea o de una trama) y retomada con la entrada completa
+ *   da lo mismo que decodificarla de una vez, desde una captura en memoria
+ *   y desde un flujo.
+ *
+ * Cualquier diferencia aborta con una descripción, para que el fuzzer la
+ * guarde como caída. Con Clang se enlaza con libFuzzer (-DPRT7_FUZZ=ON);
+ * con otros compiladores se genera un main() que ejecuta los archivos
+ * recibidos como argumento (o la entrada estándar), útil para AFL y para
+ * reproducir una caída.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+
+#include "prt7/prt7.h"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+/// Mayor entrada que se analiza (libFuzzer usa 4096 por defecto)
+static const size_t TAMANO_MAXIMO_ENTRADA = 1 << 16;
+
+/// Rotores de la cadena con la que se compara el camino silencioso
+static const int ROTORES_CADENA = 3;
+
+/**
+ * @brief Aborta con un mensaje si no se cumple una condición
+ * @param condicion Condición esperada
+ * @param descripcion Qué se esperaba
+ */
+static void verificar(bool condicion, const char* descripcion) {
+    if (!condicion) {
+        fprintf(stderr, "prt7_fuzz: %s\n", descripcion);
+        abort();
+    }
+}
+
+/**
+ * @class BufferNulo
+ * @brief streambuf que descarta los reportes del camino trama por trama
+ */
+class BufferNulo : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        return n;
+    }
+};
+
+/**
+ * @struct ResultadoSesion
+ * @brief Lo que debe coincidir entre dos formas de decodificar la misma entrada
+ */
+struct ResultadoSesion {
+    long long recibidas;    ///< Tramas válidas
+    long long malformadas;  ///< Líneas o tramas descartadas
+    long long cargas;       ///< Tramas LOAD
+    bool fin;               ///< true si llegó END
+    char* mensaje;          ///< Copia del mensaje
+    size_t longitud;        ///< Caracteres del mensaje
+
+    ResultadoSesion() : recibidas(0), malformadas(0), cargas(0), fin(false), mensaje(nullptr), longitud(0) {}
+
+    ~ResultadoSesion() {
+        delete[] mensaje;
+    }
+
+    /**
+     * @brief Copia contadores y mensaje de una sesión ya finalizada
+     * @param d Sesión a copiar
+     */
+    void tomar(Decodificador& d) {
+        recibidas = d.getTramasRecibidas();
+        malformadas = d.getTramasMalformadas();
+        cargas = d.getTramasCarga();
+        fin = d.haTerminado();
+        longitud = d.getCarga().getLongitud();
+        mensaje = new char[longitud + 1];
+        d.getCarga().copiar(0, mensaje, longitud);
+
+        verificar(static_cast<long long>(longitud) == cargas, "el mensaje no tiene un caracter por trama LOAD");
+    }
+
+    /**
+     * @brief Indica si otra forma de decodificar dio lo mismo
+     * @param otro Resultado a comparar
+     * @param conContadores false para comparar sólo el mensaje
+     * @return true si coinciden
+     */
+    bool igual(const ResultadoSesion& otro, bool conContadores) const {
+        if (conContadores && (recibidas != otro.recibidas || malformadas != otro.malformadas ||
+                              cargas != otro.cargas || fin != otro.fin)) {
+            return false;
+        }
+        return longitud == otro.longitud && memcmp(mensaje, otro.mensaje, longitud) == 0;
+    }
+};
+
+/**
+ * @brief Decodifica una entrada con una configuración dada
+ * @param datos Entrada
+ * @param longitud Bytes de la entrada
+ * @param formato Codificación de las tramas
+ * @param nivel DETALLE_SILENCIOSO (rachas agrupadas) o DETALLE_DELTA (trama por trama)
+ * @param rotores Rotores de la cadena (0 = rotor único)
+ * @param bloque Bytes por llamada a alimentar() (0 = todo de una vez)
+ * @param resultado Resultado de la sesión
+ */
+static void decodificar(const char* datos, size_t longitud, FormatoTramas formato, NivelDetalle nivel,
+                        int rotores, size_t bloque, ResultadoSesion& resultado) {
+    BufferNulo nulo;
+    std::ostream flujo(&nulo);
+    Decodificador d(nivel, flujo);
+    d.setFormato(formato);
+    if (rotores > 0) {
+        d.configurarRotores(rotores, true);
+    }
+
+    if (bloque == 0) {
+        d.alimentar(datos, longitud);
+    } else {
+        for (size_t i = 0; i < longitud; i += bloque) {
+            if (!d.alimentar(datos + i, longitud - i < bloque ? longitud - i : bloque)) break;
+        }
+    }
+    d.finalizar();
+    resultado.tomar(d);
+}
+
+#ifndef _WIN32
+/**
+ * @brief Decodifica una entrada pasándola por un LectorSerial sobre una tubería
+ * @param datos Entrada
+ * @param longitud Bytes de la entrada
+ * @param d Sesión que recibe las tramas, ya configurada
+ * @param puntoControl Punto de control de la sesión, o nullptr
+ * @return false si no pudo crearse la tubería o la entrada no cabe en ella
+ */
+static bool decodificarPorLector(const char* datos, size_t longitud, Decodificador& d, PuntoControl* puntoControl) {
+    int extremos[2];
+    if (pipe(extremos) != 0) {
+        return false;
+    }
+    fcntl(extremos[1], F_SETFL, O_NONBLOCK);
+    ssize_t escritos = longitud > 0 ? write(extremos[1], datos, longitud) : 0;
+    close(extremos[1]);
+    if (escritos != static_cast<ssize_t>(longitud)) {
+        close(extremos[0]);
+        return false;
+    }
+
+    LectorSerial lector(extremos[0]);
+    lector.setFormato(d.getFormato());
+    decodificarFlujo(lector, d, 0, puntoControl);
+    close(extremos[0]);
+    return true;
+}
+
+/**
+ * @brief Borra los archivos de un punto de control
+ * @param ruta Archivo de la instantánea
+ */
+static void borrarPuntoControl(const char* ruta) {
+    char carga[64];
+    snprintf(carga, sizeof(carga), "%s.carga", ruta);
+    remove(ruta);
+    remove(carga);
+}
+
+/**
+ * @brief Corta la entrada, guarda la sesión al final del corte y la retoma con la entrada completa
+ * @param datos Entrada
+ * @param longitud Bytes de la entrada
+ * @param corte Bytes del prefijo que decodifica la primera sesión
+ * @param formato Codificación de las tramas
+ * @param porLector true para pasar por decodificarFlujo(); false para reproducirConPuntoControl()
+ * @param resultado Resultado de la sesión retomada
+ * @return false si la comparación no pudo hacerse (tubería llena, disco)
+ *
+ * Por un flujo, la sesión retomada recibe sólo lo que sigue al corte, como
+ * la entrada estándar al reanudar; una captura se vuelve a pasar entera.
+ */
+static bool decodificarReanudando(const char* datos, size_t longitud, size_t corte, FormatoTramas formato,
+                                  bool porLector, ResultadoSesion& resultado) {
+    char ruta[64];
+    snprintf(ruta, sizeof(ruta), "/tmp/prt7_fuzz_%d", static_cast<int>(getpid()));
+    borrarPuntoControl(ruta);
+
+    bool correcto;
+    {
+        Decodificador d(DETALLE_SILENCIOSO);
+        d.setFormato(formato);
+        PuntoControl puntoControl(ruta, 1 << 30);
+        correcto = puntoControl.cargar(d) == PUNTO_CONTROL_AUSENTE;
+        if (correcto && porLector) {
+            correcto = decodificarPorLector(datos, corte, d, &puntoControl);
+        } else if (correcto) {
+            reproducirConPuntoControl(datos, corte, d, puntoControl);
+        }
+        correcto = correcto && puntoControl.getFallos() == 0;
+    }
+    if (correcto) {
+        Decodificador d(DETALLE_SILENCIOSO);
+        d.setFormato(formato);
+        PuntoControl puntoControl(ruta, 1 << 30);
+        correcto = puntoControl.cargar(d) == PUNTO_CONTROL_RESTAURADO;
+        if (correcto && porLector) {
+            correcto = decodificarPorLector(datos + corte, longitud - corte, d, &puntoControl);
+        } else if (correcto) {
+            reproducirConPuntoControl(datos, longitud, d, puntoControl);
+        }
+        if (correcto) {
+            resultado.tomar(d);
+        }
+    }
+    borrarPuntoControl(ruta);
+    return correcto;
+}
+#endif
+
+/**
+ * @brief Comprueba cada línea por separado con el analizador de texto
+ * @param datos Entrada
+ * @param longitud Bytes de la entrada
+ */
+static void verificarLineas(const char* datos, size_t longitud) {
+    RotorDeMapeo rotor;
+    size_t inicio = 0;
+
+    for (size_t i = 0; i <= longitud; i++) {
+        if (i < longitud && datos[i] != '\n' && datos[i] != '\r') continue;
+
+        const char* linea = datos + inicio;
+        int largo = static_cast<int>(i - inicio);
+        inicio = i + 1;
+
+        Trama t;
+        ErrorTrama error = analizarTrama(linea, largo, t);
+        verificar(descripcionError(error) != nullptr, "codigo de error sin descripcion");
+        if (error != TRAMA_VALIDA) continue;
+
+        // Forma canónica de la trama, que debe analizarse igual
+        char canonica[32];
+        int n = 0;
+        switch (t.tipo) {
+            case TRAMA_LOAD:
+                verificar(t.caracter == ' ' || t.caracter == linea[2], "LOAD con caracter distinto del recibido");
+                n = t.caracter == ' ' ? snprintf(canonica, sizeof(canonica), "L,Space")
+                                      : snprintf(canonica, sizeof(canonica), "L,%c", t.caracter);
+                break;
+            case TRAMA_MAP:
+                n = snprintf(canonica, sizeof(canonica), "M,%d,%d", t.rotor, t.rotacion);
+                rotor.rotar(t.rotacion);
+                break;
+            case TRAMA_FIN:
+                n = snprintf(canonica, sizeof(canonica), "END");
+                break;
+        }
+        Trama otra;
+        verificar(analizarTrama(canonica, n, otra) == TRAMA_VALIDA, "la forma canonica no es valida");
+        verificar(otra.tipo == t.tipo && otra.caracter == t.caracter && otra.rotor == t.rotor &&
+                  otra.rotacion == t.rotacion, "la forma canonica se analiza distinto");
+    }
+
+    // El rotor debe seguir siendo una permutación y mapearBloque coincidir con getMapeo
+    char alfabeto[RotorDeMapeo::TAMANO_ANILLO];
+    char mapeado[RotorDeMapeo::TAMANO_ANILLO];
+    bool vistos[RotorDeMapeo::TAMANO_ANILLO];
+    memset(vistos, 0, sizeof(vistos));
+    for (int i = 0; i < RotorDeMapeo::TAMANO_ANILLO; i++) {
+        alfabeto[i] = static_cast<char>('A' + i);
+    }
+    rotor.mapearBloque(alfabeto, mapeado, RotorDeMapeo::TAMANO_ANILLO);
+    for (int i = 0; i < RotorDeMapeo::TAMANO_ANILLO; i++) {
+        char c = rotor.getMapeo(alfabeto[i]);
+        verificar(c == mapeado[i], "mapearBloque difiere de getMapeo");
+        verificar(c >= 'A' && c <= 'Z' && !vistos[c - 'A'], "el rotor dejo de ser una permutacion");
+        vistos[c - 'A'] = true;
+        verificar(rotor.getInverso(c) == alfabeto[i], "getInverso no invierte getMapeo");
+    }
+}
+
+/**
+ * @brief Codifica la entrada como mensaje y comprueba que se decodifique igual
+ * @param datos Mensaje
+ * @param longitud Cantidad de caracteres
+ * @param semilla Semilla de las rotaciones intercaladas
+ */
+static void verificarIdaVueltaEntrada(const char* datos, size_t longitud, unsigned semilla) {
+    for (int f = 0; f < 2; f++) {
+        FormatoTramas formato = f == 0 ? FORMATO_TEXTO : FORMATO_BINARIO;
+        for (int c = 0; c < 2; c++) {
+            int rotores = c == 0 ? 1 : ROTORES_CADENA;
+            ResultadoVerificacion r = verificarIdaVuelta(datos, longitud, formato, rotores, c == 1,
+                                                         1 + static_cast<int>(semilla % 7), semilla);
+            verificar(r.tramasMalformadas == 0, "el codificador genero una trama mal formada");
+            verificar(r.noRepresentables > 0 || r.coincide, "la ida y vuelta por el codificador no coincide");
+        }
+    }
+}
+
+/**
+ * @brief Punto de entrada de libFuzzer: recibe una entrada y la verifica
+ * @param entrada Bytes generados por el fuzzer
+ * @param tamano Cantidad de bytes
+ * @return 0 (libFuzzer no admite otro valor)
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* entrada, size_t tamano) {
+    if (tamano > TAMANO_MAXIMO_ENTRADA) {
+        return 0;
+    }
+    const char* datos = reinterpret_cast<const char*>(entrada);
+    // Un tamaño de bloque que dependa de la entrada recorre todos los cortes posibles
+    size_t bloque = tamano > 0 ? 1 + entrada[0] % 31 : 1;
+    // Lo mismo con el punto en que se corta la sesión antes de retomarla
+    size_t corte = tamano > 0 ? (static_cast<size_t>(entrada[tamano - 1]) * 257 + tamano / 2) % (tamano + 1) : 0;
+
+    verificarLineas(datos, tamano);
+    verificarIdaVueltaEntrada(datos, tamano, static_cast<unsigned>(bloque));
+
+    for (int f = 0; f < 2; f++) {
+        FormatoTramas formato = f == 0 ? FORMATO_TEXTO : FORMATO_BINARIO;
+
+        ResultadoSesion entero;
+        decodificar(datos, tamano, formato, DETALLE_SILENCIOSO, 0, 0, entero);
+
+        ResultadoSesion partido;
+        decodificar(datos, tamano, formato, DETALLE_SILENCIOSO, 0, bloque, partido);
+        verificar(entero.igual(partido, true), "alimentar por bloques difiere de alimentar de una vez");
+
+        ResultadoSesion porTrama;
+        decodificar(datos, tamano, formato, DETALLE_DELTA, 0, 0, porTrama);
+        verificar(entero.igual(porTrama, true), "el camino silencioso difiere del camino con reportes");
+
+        ResultadoSesion cadena;
+        ResultadoSesion cadenaPorTrama;
+        decodificar(datos, tamano, formato, DETALLE_SILENCIOSO, ROTORES_CADENA, bloque, cadena);
+        decodificar(datos, tamano, formato, DETALLE_DELTA, ROTORES_CADENA, 0, cadenaPorTrama);
+        verificar(cadena.igual(cadenaPorTrama, true), "la cadena silenciosa difiere de la cadena con reportes");
+
+#ifndef _WIN32
+        ResultadoSesion lector;
+        Decodificador porLector;
+        porLector.setFormato(formato);
+        // Si la entrada no cabe en la tubería las comparaciones por lector se omiten
+        bool hayLector = decodificarPorLector(datos, tamano, porLector, nullptr);
+        if (hayLector) {
+            lector.tomar(porLector);
+            // Un flujo binario descarta sin contarla la trama a medias del final
+            verificar(entero.igual(lector, formato == FORMATO_TEXTO), "LectorSerial difiere de Decodificador::alimentar");
+        }
+
+        ResultadoSesion reanudada;
+        if (decodificarReanudando(datos, tamano, corte, formato, false, reanudada)) {
+            verificar(entero.igual(reanudada, true), "retomar una captura cortada difiere de decodificarla entera");
+        }
+        ResultadoSesion reanudadaPorLector;
+        if (hayLector && decodificarReanudando(datos, tamano, corte, formato, true, reanudadaPorLector)) {
+            verificar(lector.igual(reanudadaPorLector, true), "retomar un flujo cortado difiere de decodificarlo entero");
+        }
+#endif
+    }
+    return 0;
+}
+
+#ifndef PRT7_LIBFUZZER
+/**
+ * @brief Ejecuta el objetivo sobre archivos, sin libFuzzer (AFL o reproducción de caídas)
+ * @param argc Cantidad de argumentos
+ * @param argv Archivos a ejecutar; sin argumentos se lee la entrada estándar
+ * @return 0 si todas las entradas pasaron (una falla aborta)
+ */
+int main(int argc, char* argv[]) {
+    uint8_t* datos = new uint8_t[TAMANO_MAXIMO_ENTRADA];
+
+    if (argc < 2) {
+        size_t tamano = fread(datos, 1, TAMANO_MAXIMO_ENTRADA, stdin);
+        LLVMFuzzerTestOneInput(datos, tamano);
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE* archivo = fopen(argv[i], "rb");
+        if (!archivo) {
+            perror(argv[i]);
+            continue;
+        }
+        size_t tamano = fread(datos, 1, TAMANO_MAXIMO_ENTRADA, archivo);
+        fclose(archivo);
+
+        LLVMFuzzerTestOneInput(datos, tamano);
+        printf("%s: %zu bytes, ok\n", argv[i], tamano);
+    }
+
+    delete[] datos;
+    return 0;
+}
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file AgrupadorTramas.h
+ * @brief Agrupación de rachas de tramas que se aplican como una sola operación
+ */
+
+#ifndef PRT7_AGRUPADOR_TRAMAS_H
+#define PRT7_AGRUPADOR_TRAMAS_H
+
+#include "prt7/RotorDeMapeo.h"
+#include "prt7/Trama.h"
+
+/// Caracteres repetidos a partir de los cuales conviene rellenar en lugar de mapear uno por uno
+static const int RACHA_MINIMA_RELLENO = 16;
+
+/**
+ * @brief Mide una racha de tramas MAP consecutivas dirigidas al mismo rotor
+ * @param tramas Tramas a examinar; la primera debe ser MAP
+ * @param cantidad Tramas disponibles (al menos 1)
+ * @param rotacionNeta Suma de las rotaciones, reducida a 0..TAMANO_ANILLO - 1
+ * @return Tramas de la racha (al menos 1)
+ *
+ * Rotar una vez la rotación neta deja el rotor en la misma posición que
+ * aplicar cada trama, así que una ráfaga como M,1 x 50 cuesta un solo
+ * movimiento. La suma se reduce en cada paso y no desborda.
+ */
+inline int agruparMapeos(const Trama* tramas, int cantidad, int& rotacionNeta) {
+    const int anillo = RotorDeMapeo::TAMANO_ANILLO;
+    unsigned char rotor = tramas[0].rotor;
+    int neta = 0;
+    int n = 0;
+
+    while (n < cantidad && tramas[n].tipo == TRAMA_MAP && tramas[n].rotor == rotor) {
+        neta = (neta + tramas[n].rotacion % anillo + anillo) % anillo;
+        n++;
+    }
+
+    rotacionNeta = neta;
+    return n;
+}
+
+/**
+ * @brief Mide una racha de tramas LOAD con el mismo carácter
+ * @param tramas Tramas a examinar; la primera debe ser LOAD
+ * @param cantidad Tramas disponibles (al menos 1)
+ * @return Tramas de la racha (al menos 1)
+ *
+ * Con el rotor quieto todos se decodifican al mismo carácter, que puede
+ * agregarse de una vez con ListaDeCarga::rellenar().
+ */
+inline int agruparRepetidos(const Trama* tramas, int cantidad) {
+    char caracter = tramas[0].caracter;
+    int n = 1;
+
+    while (n < cantidad && tramas[n].tipo == TRAMA_LOAD && tramas[n].caracter == caracter) {
+        n++;
+    }
+    return n;
+}
+
+#endif // PRT7_AGRUPADOR_TRAMAS_H
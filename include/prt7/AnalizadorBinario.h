@@ -0,0 +1,170 @@
+/**
+ * @file AnalizadorBinario.h
+ * @brief Analizador por flujo de la codificación binaria compacta de PRT-7
+ */
+
+#ifndef PRT7_ANALIZADOR_BINARIO_H
+#define PRT7_ANALIZADOR_BINARIO_H
+
+#include <cstddef>
+
+#include "prt7/Trama.h"
+
+/**
+ * @enum FormatoTramas
+ * @brief Codificación de las tramas en el enlace
+ */
+enum FormatoTramas {
+    FORMATO_TEXTO,   ///< Una línea de texto por trama (L,X / M,N / END)
+    FORMATO_BINARIO  ///< Etiqueta de un byte más carga útil (ver AnalizadorBinario)
+};
+
+/**
+ * @class AnalizadorBinario
+ * @brief Máquina de estados que convierte bytes binarios en tramas
+ *
+ * Cada trama empieza con una etiqueta de un byte:
+ *
+ * | Etiqueta | Carga útil                         | Equivale a        |
+ * |----------|------------------------------------|-------------------|
+ * | 0x01     | 1 byte: carácter                   | L,X               |
+ * | 0x02     | varint zigzag: rotación            | M,N               |
+ * | 0x03     | 1 byte: rotor, varint zigzag       | M,R,N             |
+ * | 0x04     | varint: cantidad n >= 1, n bytes   | n tramas L,X      |
+ * | 0x05     | (nada)                             | END               |
+ * | 0x06     | 8 bytes: instante, little endian   | (comentario)      |
+ *
+ * Los varint son LEB128 (7 bits por byte, el bit alto indica que sigue otro)
+ * y la rotación va en zigzag (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...). Una
+ * racha de n caracteres cuesta n + 2 bytes en vez de 4n en texto. La
+ * etiqueta 0x06 no la envía el emisor: es la marca de tiempo que agrega un
+ * GrabadorCaptura, y se salta igual que una línea de comentario en texto.
+ *
+ * El estado se conserva entre llamadas, así que una trama puede quedar
+ * partida en cualquier byte entre dos bloques. Una etiqueta desconocida o un
+ * varint inválido cuentan como una trama mal formada y el análisis sigue en
+ * el byte siguiente.
+ */
+class AnalizadorBinario {
+public:
+    static const unsigned char ETIQUETA_CARGA = 0x01;        ///< Un carácter
+    static const unsigned char ETIQUETA_MAPEO = 0x02;        ///< Rotación del primer rotor
+    static const unsigned char ETIQUETA_MAPEO_ROTOR = 0x03;  ///< Rotación de un rotor de la cadena
+    static const unsigned char ETIQUETA_RACHA = 0x04;        ///< Racha de caracteres
+    static const unsigned char ETIQUETA_FIN = 0x05;          ///< Fin de la transmisión
+    static const unsigned char ETIQUETA_MARCA_TIEMPO = 0x06; ///< Marca de tiempo de una captura
+
+    static const int BYTES_MARCA_TIEMPO = 8;                 ///< Carga útil de ETIQUETA_MARCA_TIEMPO
+
+    static const int BYTES_MAXIMOS_VARINT = 5;               ///< Un int de 32 bits en LEB128
+
+    /**
+     * @struct EstadoGuardado
+     * @brief Trama a medias, para guardarla y continuarla en otro proceso
+     */
+    struct EstadoGuardado {
+        int estado;                   ///< Parte de la trama que se espera
+        unsigned long long acumulado; ///< Valor parcial del varint
+        int bytesVarint;              ///< Bytes del varint ya leídos
+        int rotor;                    ///< Rotor de la trama MAP en curso
+        unsigned long long restantes; ///< Caracteres que faltan de la racha en curso
+    };
+
+private:
+    /**
+     * @enum Estado
+     * @brief Parte de la trama que se espera a continuación
+     */
+    enum Estado {
+        ESPERA_ETIQUETA,   ///< Próximo byte: etiqueta
+        CARACTER_CARGA,    ///< Próximo byte: carácter de ETIQUETA_CARGA
+        ROTOR_MAPEO,       ///< Próximo byte: rotor de ETIQUETA_MAPEO_ROTOR
+        VARINT_ROTACION,   ///< Bytes del varint de una rotación
+        VARINT_RACHA,      ///< Bytes del varint de la longitud de una racha
+        CARACTERES_RACHA,  ///< Caracteres de una racha
+        BYTES_MARCA        ///< Bytes de una marca de tiempo (se descartan)
+    };
+
+    Estado estado;                ///< Estado actual
+    unsigned long long acumulado; ///< Valor parcial del varint
+    int bytesVarint;              ///< Bytes del varint ya leídos
+    int rotor;                    ///< Rotor de la trama MAP en curso
+    unsigned long long restantes; ///< Caracteres que faltan de la racha (o bytes de la marca) en curso
+
+public:
+    /**
+     * @brief Constructor en espera de una etiqueta
+     */
+    AnalizadorBinario() {
+        reiniciar();
+    }
+
+    /**
+     * @brief Descarta la trama parcial y vuelve a esperar una etiqueta
+     */
+    void reiniciar() {
+        estado = ESPERA_ETIQUETA;
+        acumulado = 0;
+        bytesVarint = 0;
+        rotor = 0;
+        restantes = 0;
+    }
+
+    /**
+     * @brief Indica si quedó una trama a medias
+     * @return true si faltan bytes de la trama en curso
+     */
+    bool enTrama() const {
+        return estado != ESPERA_ETIQUETA;
+    }
+
+    /**
+     * @brief Copia el estado de la trama en curso
+     * @param destino Estado a completar
+     */
+    void capturar(EstadoGuardado& destino) const {
+        destino.estado = estado;
+        destino.acumulado = acumulado;
+        destino.bytesVarint = bytesVarint;
+        destino.rotor = rotor;
+        destino.restantes = restantes;
+    }
+
+    /**
+     * @brief Continúa la trama de un estado guardado con capturar()
+     * @param origen Estado guardado
+     * @return false si el estado no es válido (el analizador queda reiniciado)
+     */
+    bool restaurar(const EstadoGuardado& origen) {
+        reiniciar();
+        // Tras un varint de BYTES_MAXIMOS_VARINT bytes la cuenta queda en ese valor
+        if (origen.estado < ESPERA_ETIQUETA || origen.estado > BYTES_MARCA ||
+            origen.bytesVarint < 0 || origen.bytesVarint > BYTES_MAXIMOS_VARINT) {
+            return false;
+        }
+        estado = static_cast<Estado>(origen.estado);
+        acumulado = origen.acumulado;
+        bytesVarint = origen.bytesVarint;
+        rotor = origen.rotor;
+        restantes = origen.restantes;
+        return true;
+    }
+
+    /**
+     * @brief Analiza bytes hasta agotarlos, llenar el arreglo o encontrar END
+     * @param datos Bytes recibidos
+     * @param longitud Cantidad de bytes
+     * @param consumidos Bytes analizados (el resto queda para la próxima llamada)
+     * @param tramas Arreglo donde dejar las tramas válidas
+     * @param maximo Capacidad del arreglo
+     * @param malformadas Contador al que se suman las tramas descartadas
+     * @return Cantidad de tramas escritas en el arreglo
+     *
+     * Se detiene justo después de END para que quien llama no consuma lo
+     * que venga detrás.
+     */
+    int analizar(const char* datos, size_t longitud, size_t& consumidos,
+                 Trama* tramas, int maximo, int& malformadas);
+};
+
+#endif // PRT7_ANALIZADOR_BINARIO_H
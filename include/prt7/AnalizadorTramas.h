@@ -0,0 +1,60 @@
+/**
+ * @file AnalizadorTramas.h
+ * @brief Analizador de la gramática de texto de las tramas PRT-7
+ */
+
+#ifndef PRT7_ANALIZADOR_TRAMAS_H
+#define PRT7_ANALIZADOR_TRAMAS_H
+
+#include "prt7/Trama.h"
+
+/// Bytes que puede ocupar una línea válida, sin el fin de línea
+static const int LONGITUD_MAXIMA_TRAMA = 255;
+
+/// Primer carácter de una línea de comentario (ej. las marcas de tiempo de una captura grabada)
+static const char MARCA_COMENTARIO = '#';
+
+/**
+ * @enum ErrorTrama
+ * @brief Resultado del análisis de una línea
+ */
+enum ErrorTrama {
+    TRAMA_VALIDA,            ///< La línea es una trama correcta
+    TRAMA_COMENTARIO,        ///< La línea empieza con MARCA_COMENTARIO: se ignora sin ser un error
+    ERROR_TRAMA_VACIA,       ///< La línea no tiene contenido
+    ERROR_TIPO_DESCONOCIDO,  ///< El primer carácter no es L, M ni E
+    ERROR_FORMATO,           ///< La línea no sigue la gramática de su tipo
+    ERROR_DESBORDAMIENTO,    ///< La rotación de una trama MAP no cabe en un int
+    ERROR_LINEA_LARGA        ///< La línea supera LONGITUD_MAXIMA_TRAMA
+};
+
+/**
+ * @brief Descripción legible de un código de error
+ * @param error Código a describir
+ * @return Texto estático con la descripción
+ */
+const char* descripcionError(ErrorTrama error);
+
+/**
+ * @brief Analiza una línea con la gramática de tramas PRT-7
+ * @param linea Inicio de la línea (no necesita terminar en '\\0')
+ * @param longitud Bytes de la línea, sin el fin de línea
+ * @param trama Trama resultante; sólo es válida si se devuelve TRAMA_VALIDA
+ * @return Código de resultado
+ *
+ * Reconoce `L,<carácter>`, `L,Space`, `M,<entero>`, `M,<rotor>,<entero>` y
+ * `END` recorriendo la línea una sola vez con una máquina de estados, sin
+ * copiarla. El índice de rotor no lleva signo y va de 0 a 255.
+ *
+ * Una línea de más de LONGITUD_MAXIMA_TRAMA bytes se rechaza aunque siga la
+ * gramática (ej. una rotación con cientos de ceros a la izquierda): quien
+ * lee por bloques sólo puede conservar ese principio, y la trama no debe
+ * ser válida o no según dónde haya caído el corte entre bloques.
+ *
+ * Por la misma razón, una línea que empieza con MARCA_COMENTARIO es un
+ * comentario sea cual sea su longitud: basta su primer byte para saberlo.
+ * Quien cuenta las líneas mal formadas no debe contar los comentarios.
+ */
+ErrorTrama analizarTrama(const char* linea, int longitud, Trama& trama);
+
+#endif // PRT7_ANALIZADOR_TRAMAS_H
@@ -0,0 +1,79 @@
+/**
+ * @file ArchivoMapeado.h
+ * @brief Capturas PRT-7 mapeadas en memoria para la reproducción
+ */
+
+#ifndef PRT7_ARCHIVO_MAPEADO_H
+#define PRT7_ARCHIVO_MAPEADO_H
+
+#include <cstddef>
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
+/**
+ * @class ArchivoMapeado
+ * @brief Captura PRT-7 mapeada en memoria de sólo lectura
+ *
+ * Usa mmap en POSIX y CreateFileMapping/MapViewOfFile en Windows, de modo
+ * que la reproducción recorre el archivo sin copiarlo a un buffer propio.
+ */
+class ArchivoMapeado {
+private:
+    const char* datos;  ///< Inicio del contenido mapeado
+    size_t tamano;      ///< Tamaño del contenido en bytes
+#ifdef _WIN32
+    HANDLE archivo;     ///< Handle del archivo
+    HANDLE mapeo;       ///< Objeto de mapeo del archivo
+#else
+    int fd;             ///< Descriptor del archivo
+#endif
+    bool propio;        ///< true si el descriptor debe cerrarse (no es la entrada estándar)
+
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+public:
+    /**
+     * @brief Constructor de un mapeo vacío
+     */
+    ArchivoMapeado();
+
+    /**
+     * @brief Destructor que deshace el mapeo
+     */
+    ~ArchivoMapeado();
+
+    /**
+     * @brief Mapea un archivo completo
+     * @param ruta Ruta del archivo, o "-" para la entrada estándar
+     * @return true si el archivo quedó mapeado (un archivo vacío también cuenta)
+     *
+     * Falla si la ruta no es un archivo regular, por ejemplo una tubería.
+     */
+    bool abrir(const char* ruta);
+
+    /**
+     * @brief Deshace el mapeo y cierra el archivo
+     */
+    void cerrar();
+
+    /**
+     * @brief Obtiene el contenido mapeado
+     * @return Inicio del contenido (nullptr si el archivo está vacío)
+     */
+    const char* getDatos() const {
+        return datos;
+    }
+
+    /**
+     * @brief Obtiene el tamaño del contenido
+     * @return Bytes mapeados
+     */
+    size_t getTamano() const {
+        return tamano;
+    }
+};
+
+#endif // PRT7_ARCHIVO_MAPEADO_H
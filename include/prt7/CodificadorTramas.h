@@ -0,0 +1,210 @@
+/**
+ * @file CodificadorTramas.h
+ * @brief Codificador de mensajes en tramas PRT-7 y verificación de ida y vuelta
+ */
+
+#ifndef PRT7_CODIFICADOR_TRAMAS_H
+#define PRT7_CODIFICADOR_TRAMAS_H
+
+#include <cstddef>
+
+#include "prt7/AnalizadorBinario.h"
+#include "prt7/RotorCompuesto.h"
+#include "prt7/SumideroCarga.h"
+
+/**
+ * @class CodificadorTramas
+ * @brief Hace el trabajo del emisor: convierte un mensaje en un flujo de tramas
+ *
+ * Lleva una copia del rotor (o de la cadena de rotores) del decodificador y
+ * por cada carácter del mensaje envía la trama LOAD cuyo mapeo lo produce,
+ * que se obtiene de la tabla inversa del desplazamiento actual
+ * (RotorDeMapeo::getInverso()). Cada getIntervaloMapeo() caracteres
+ * intercala una trama MAP con una rotación pseudoaleatoria, dirigida por
+ * turnos a cada rotor de la cadena, para que el flujo ejercite el rotor
+ * igual que uno real; con avance, la cadena se mueve tras cada LOAD igual
+ * que en el decodificador.
+ *
+ * El flujo sale por bloques hacia un SumideroCarga, en texto (una línea por
+ * trama) o en la codificación binaria, donde las cargas consecutivas van en
+ * una sola racha 0x04. Hay caracteres que el decodificador no puede
+ * producir: las minúsculas (el rotor entrega mayúsculas) se envían como su
+ * mayúscula, y los fines de línea en texto se omiten porque cortarían la
+ * trama. Ambos se cuentan en getNoRepresentables().
+ */
+class CodificadorTramas {
+public:
+    static const int CAPACIDAD = 65536;    ///< Bytes del buffer de salida
+    static const int MAXIMO_RACHA = 4096;  ///< Cargas por trama de racha en binario
+    static const int ROTACION_MAXIMA = 51; ///< Magnitud máxima de las rotaciones intercaladas
+
+private:
+    FormatoTramas formato;      ///< Codificación del flujo
+    SumideroCarga& destino;     ///< Destino del flujo
+    RotorDeMapeo rotor;         ///< Copia del rotor único del decodificador
+    RotorCompuesto* cadena;     ///< Copia de la cadena de rotores, o nullptr con el rotor único
+    int intervaloMapeo;         ///< Caracteres entre tramas MAP (0 = ninguna)
+    int hastaMapeo;             ///< Caracteres que faltan para la próxima trama MAP
+    unsigned estado;            ///< Estado del generador de rotaciones (xorshift32)
+    int siguienteRotor;         ///< Rotor de la cadena al que va la próxima trama MAP
+    char buffer[CAPACIDAD];     ///< Bytes pendientes de entregar
+    int usados;                 ///< Bytes ocupados en buffer
+    char racha[MAXIMO_RACHA];   ///< Cargas binarias aún no enviadas
+    int enRacha;                ///< Cargas en racha
+    long long tramas;           ///< Tramas emitidas
+    long long noRepresentables; ///< Caracteres que el decodificador no reproducirá tal cual
+    bool fallo;                 ///< true si el destino rechazó un bloque
+
+    /**
+     * @brief Agrega bytes al buffer, entregándolo al destino cuando se llena
+     * @param datos Bytes a agregar
+     * @param longitud Cantidad de bytes
+     */
+    void escribir(const char* datos, int longitud);
+
+    /**
+     * @brief Agrega un varint LEB128
+     * @param valor Valor a codificar
+     */
+    void escribirVarint(unsigned long long valor);
+
+    /**
+     * @brief Emite las cargas binarias acumuladas (una trama 0x01 o una racha 0x04)
+     */
+    void cerrarRacha();
+
+    /**
+     * @brief Emite una trama LOAD
+     * @param caracter Carácter de la trama (ya invertido)
+     */
+    void emitirCarga(char caracter);
+
+    /**
+     * @brief Emite una trama MAP y la aplica a la copia del rotor
+     * @param indiceRotor Rotor de la cadena (0 con el rotor único)
+     * @param rotacion Posiciones a rotar
+     */
+    void emitirMapeo(int indiceRotor, int rotacion);
+
+    /**
+     * @brief Entrega el buffer al destino
+     */
+    void vaciar();
+
+    CodificadorTramas(const CodificadorTramas&) = delete;
+    CodificadorTramas& operator=(const CodificadorTramas&) = delete;
+
+public:
+    /**
+     * @brief Constructor con el rotor único en la posición cero
+     * @param f Codificación del flujo
+     * @param d Destino del flujo (no pasa a ser del codificador)
+     */
+    CodificadorTramas(FormatoTramas f, SumideroCarga& d);
+
+    /**
+     * @brief Destructor que libera la cadena de rotores
+     */
+    ~CodificadorTramas();
+
+    /**
+     * @brief Usa una cadena de rotores, como Decodificador::configurarRotores()
+     * @param cantidad Rotores encadenados (1 a RotorCompuesto::MAXIMO_ROTORES)
+     * @param avance true si cada carácter mueve la cadena
+     *
+     * Debe llamarse antes de codificar y con los mismos valores que el
+     * decodificador que recibirá el flujo.
+     */
+    void configurarRotores(int cantidad, bool avance);
+
+    /**
+     * @brief Elige cada cuántos caracteres se intercala una trama MAP
+     * @param caracteres Caracteres entre tramas MAP (0 = sólo tramas LOAD)
+     * @param semilla Semilla de las rotaciones (el mismo valor repite el flujo)
+     */
+    void setIntervaloMapeo(int caracteres, unsigned semilla);
+
+    /**
+     * @brief Cada cuántos caracteres se intercala una trama MAP
+     * @return Caracteres entre tramas MAP (0 = ninguna)
+     */
+    int getIntervaloMapeo() const {
+        return intervaloMapeo;
+    }
+
+    /**
+     * @brief Codifica una parte del mensaje
+     * @param mensaje Caracteres a transmitir
+     * @param longitud Cantidad de caracteres
+     *
+     * Se puede llamar varias veces: el flujo continúa donde quedó.
+     */
+    void codificar(const char* mensaje, size_t longitud);
+
+    /**
+     * @brief Emite END y entrega lo pendiente al destino
+     */
+    void finalizar();
+
+    /**
+     * @brief Tramas emitidas hasta ahora (incluida END)
+     * @return Cantidad de tramas
+     */
+    long long getTramas() const {
+        return tramas;
+    }
+
+    /**
+     * @brief Caracteres del mensaje que el decodificador no reproducirá tal cual
+     * @return Minúsculas (llegan como mayúsculas) más fines de línea omitidos en texto
+     */
+    long long getNoRepresentables() const {
+        return noRepresentables;
+    }
+
+    /**
+     * @brief Indica si el destino rechazó algún bloque
+     * @return true si el flujo quedó incompleto
+     */
+    bool huboFallo() const {
+        return fallo;
+    }
+};
+
+/**
+ * @struct ResultadoVerificacion
+ * @brief Resultado de verificarIdaVuelta()
+ */
+struct ResultadoVerificacion {
+    bool coincide;                ///< true si lo decodificado es exactamente el mensaje
+    size_t longitud;              ///< Caracteres del mensaje
+    size_t decodificados;         ///< Caracteres que entregó el decodificador
+    size_t primeraDiferencia;     ///< Posición del primer carácter distinto (longitud si no hay)
+    long long bytesFlujo;         ///< Bytes del flujo de tramas generado
+    long long tramas;             ///< Tramas del flujo
+    long long noRepresentables;   ///< Ver CodificadorTramas::getNoRepresentables()
+    long long tramasMalformadas;  ///< Tramas que el decodificador descartó
+    long long nanosegundos;       ///< Duración de la codificación y la decodificación
+};
+
+/**
+ * @brief Codifica un mensaje y lo decodifica de inmediato, comparando el resultado
+ * @param mensaje Mensaje de referencia
+ * @param longitud Caracteres del mensaje
+ * @param formato Codificación del flujo
+ * @param rotores Rotores encadenados (1 = rotor único)
+ * @param avance true si cada carácter mueve la cadena
+ * @param intervaloMapeo Caracteres entre tramas MAP (ver CodificadorTramas::setIntervaloMapeo())
+ * @param semilla Semilla de las rotaciones
+ * @return Resultado de la comparación
+ *
+ * El flujo no se guarda: cada bloque del codificador alimenta directamente
+ * a un Decodificador silencioso, cuyo mensaje llega por un sumidero que lo
+ * compara contra la referencia a medida que se ensambla. La verificación
+ * corre a la velocidad de una reproducción y su memoria no depende del
+ * tamaño del mensaje.
+ */
+ResultadoVerificacion verificarIdaVuelta(const char* mensaje, size_t longitud, FormatoTramas formato,
+                                         int rotores, bool avance, int intervaloMapeo, unsigned semilla);
+
+#endif // PRT7_CODIFICADOR_TRAMAS_H
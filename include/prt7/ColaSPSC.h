@@ -0,0 +1,209 @@
+/**
+ * @file ColaSPSC.h
+ * @brief Cola circular acotada de un productor y un consumidor, sin bloqueos al pasar datos
+ */
+
+#ifndef PRT7_COLA_SPSC_H
+#define PRT7_COLA_SPSC_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class ColaSPSC
+ * @brief Cola circular para pasar datos entre exactamente dos hilos
+ * @tparam T Tipo de los elementos (se copian por valor)
+ * @tparam CAPACIDAD Cantidad de posiciones; debe ser potencia de dos
+ *
+ * El productor sólo escribe cola y el consumidor sólo escribe cabeza, por lo
+ * que bastan cargas con acquire y almacenamientos con release. Cuando la
+ * cola está llena, encolar() espera al consumidor (contrapresión) y suma una
+ * espera al contador; desencolar() hace lo mismo cuando está vacía.
+ *
+ * Cada espera cede primero el procesador unas pocas veces y después se
+ * bloquea en una variable de condición, así que una etapa ociosa no se
+ * despierta hasta que el otro hilo mueve un índice. El hilo que encola o
+ * desencola sólo toma el cerrojo para avisar si el otro está bloqueado.
+ */
+template <typename T, int CAPACIDAD>
+class ColaSPSC {
+    static_assert(CAPACIDAD > 0 && (CAPACIDAD & (CAPACIDAD - 1)) == 0,
+                  "La capacidad de ColaSPSC debe ser potencia de dos");
+
+private:
+    static const size_t MASCARA = CAPACIDAD - 1;  ///< Índice dentro del arreglo
+    static const int GIROS = 64;                   ///< Reintentos con yield antes de bloquearse
+    static const int LINEA_CACHE = 64;             ///< Bytes de una línea de caché
+
+    T elementos[CAPACIDAD];                        ///< Posiciones de la cola
+
+    // Relleno en lugar de alignas: la cola se crea con new y C++11 no
+    // garantiza la alineación extendida en memoria dinámica
+    char relleno0[LINEA_CACHE];
+    std::atomic<size_t> cabeza;                    ///< Siguiente posición a leer (consumidor)
+    char relleno1[LINEA_CACHE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> cola;                      ///< Siguiente posición a escribir (productor)
+    char relleno2[LINEA_CACHE - sizeof(std::atomic<size_t>)];
+    std::atomic<unsigned long long> esperasLlena;  ///< Veces que el productor esperó
+    std::atomic<unsigned long long> esperasVacia;  ///< Veces que el consumidor esperó
+
+    std::mutex cerrojo;                            ///< Acompaña a las variables de condición
+    std::condition_variable hayLugar;              ///< Despierta al productor bloqueado
+    std::condition_variable hayElementos;          ///< Despierta al consumidor bloqueado
+    std::atomic<bool> productorBloqueado;          ///< true mientras el productor espera en hayLugar
+    std::atomic<bool> consumidorBloqueado;         ///< true mientras el consumidor espera en hayElementos
+
+    /**
+     * @brief Despierta al otro hilo si está bloqueado esperando el índice recién movido
+     * @param bloqueado Indicador del otro hilo
+     * @param condicion Variable de condición en la que espera
+     *
+     * La barrera ordena el índice ya publicado antes de leer el indicador, y
+     * quien se bloquea pone una igual entre su indicador y la última mirada a
+     * la cola: alguno de los dos hilos ve lo que hizo el otro, así que un
+     * aviso no se pierde.
+     */
+    void avisar(std::atomic<bool>& bloqueado, std::condition_variable& condicion) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (bloqueado.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> guardia(cerrojo);
+            condicion.notify_one();
+        }
+    }
+
+    /**
+     * @brief Indica si el productor no tiene lugar (lo usa el productor al esperar)
+     * @return true si la cola está llena
+     */
+    bool estaLlena() const {
+        return cola.load(std::memory_order_relaxed) - cabeza.load(std::memory_order_acquire) ==
+               static_cast<size_t>(CAPACIDAD);
+    }
+
+    /**
+     * @brief Indica si el consumidor no tiene elementos (lo usa el consumidor al esperar)
+     * @return true si la cola está vacía
+     */
+    bool estaVacia() const {
+        return cabeza.load(std::memory_order_relaxed) == cola.load(std::memory_order_acquire);
+    }
+
+    ColaSPSC(const ColaSPSC&) = delete;
+    ColaSPSC& operator=(const ColaSPSC&) = delete;
+
+public:
+    /**
+     * @brief Constructor de una cola vacía
+     */
+    ColaSPSC()
+        : cabeza(0), cola(0), esperasLlena(0), esperasVacia(0),
+          productorBloqueado(false), consumidorBloqueado(false) {}
+
+    /**
+     * @brief Intenta agregar un elemento sin esperar (sólo el productor)
+     * @param elemento Elemento a copiar en la cola
+     * @return false si la cola está llena
+     */
+    bool intentarEncolar(const T& elemento) {
+        size_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabeza.load(std::memory_order_acquire) == static_cast<size_t>(CAPACIDAD)) {
+            return false;
+        }
+        elementos[c & MASCARA] = elemento;
+        cola.store(c + 1, std::memory_order_release);
+        avisar(consumidorBloqueado, hayElementos);
+        return true;
+    }
+
+    /**
+     * @brief Intenta sacar un elemento sin esperar (sólo el consumidor)
+     * @param elemento Destino del elemento
+     * @return false si la cola está vacía
+     */
+    bool intentarDesencolar(T& elemento) {
+        size_t h = cabeza.load(std::memory_order_relaxed);
+        if (h == cola.load(std::memory_order_acquire)) {
+            return false;
+        }
+        elemento = elementos[h & MASCARA];
+        cabeza.store(h + 1, std::memory_order_release);
+        avisar(productorBloqueado, hayLugar);
+        return true;
+    }
+
+    /**
+     * @brief Agrega un elemento, esperando mientras la cola esté llena
+     * @param elemento Elemento a copiar en la cola
+     */
+    void encolar(const T& elemento) {
+        if (intentarEncolar(elemento)) return;
+
+        esperasLlena.fetch_add(1, std::memory_order_relaxed);
+        for (int intento = 0; !intentarEncolar(elemento); intento++) {
+            if (intento < GIROS) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Se reintenta fuera del cerrojo: avisar() lo toma si el otro hilo duerme
+            std::unique_lock<std::mutex> guardia(cerrojo);
+            productorBloqueado.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (estaLlena()) {
+                hayLugar.wait(guardia);
+            }
+            productorBloqueado.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Saca un elemento, esperando mientras la cola esté vacía
+     * @param elemento Destino del elemento
+     */
+    void desencolar(T& elemento) {
+        if (intentarDesencolar(elemento)) return;
+
+        esperasVacia.fetch_add(1, std::memory_order_relaxed);
+        for (int intento = 0; !intentarDesencolar(elemento); intento++) {
+            if (intento < GIROS) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> guardia(cerrojo);
+            consumidorBloqueado.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (estaVacia()) {
+                hayElementos.wait(guardia);
+            }
+            consumidorBloqueado.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Elementos en la cola en este momento (aproximado si otro hilo la usa)
+     * @return Cantidad entre 0 y CAPACIDAD
+     */
+    size_t getOcupacion() const {
+        return cola.load(std::memory_order_relaxed) - cabeza.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Veces que el productor encontró la cola llena
+     * @return Contador de contrapresión
+     */
+    unsigned long long getEsperasLlena() const {
+        return esperasLlena.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Veces que el consumidor encontró la cola vacía
+     * @return Contador de esperas
+     */
+    unsigned long long getEsperasVacia() const {
+        return esperasVacia.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // PRT7_COLA_SPSC_H
@@ -0,0 +1,35 @@
+/**
+ * @file DecodificacionParalela.h
+ * @brief Decodificación de capturas completas repartida entre varios hilos
+ */
+
+#ifndef PRT7_DECODIFICACION_PARALELA_H
+#define PRT7_DECODIFICACION_PARALELA_H
+
+#include <cstddef>
+
+#include "prt7/Decodificador.h"
+
+/**
+ * @brief Decodifica una captura completa en memoria usando varios hilos
+ * @param datos Texto PRT-7 de la captura (por ejemplo, un ArchivoMapeado)
+ * @param longitud Bytes de la captura
+ * @param decodificador Sesión recién creada y con salida silenciosa
+ * @param hilos Hilos a usar (0 = uno por núcleo)
+ * @return Cantidad de tramos en que se dividió la captura
+ *
+ * La única dependencia entre tramas LOAD es el desplazamiento del rotor, y
+ * las rotaciones se componen sumando módulo 26. La captura se corta en
+ * tramos en fines de línea; una primera pasada en paralelo calcula la
+ * rotación neta, las cargas y la posición de END de cada tramo, una suma de
+ * prefijos exclusiva da el desplazamiento inicial de cada uno, y una segunda
+ * pasada en paralelo decodifica cada tramo en su lugar de un buffer común,
+ * que al final se agrega de una vez a la lista de carga.
+ *
+ * El resultado (mensaje, rotor y contadores) es el mismo que con
+ * Decodificador::alimentar() y Decodificador::finalizar(). Si la sesión
+ * reporta cada trama, se decodifica en orden con alimentar().
+ */
+int decodificarEnParalelo(const char* datos, size_t longitud, Decodificador& decodificador, int hilos);
+
+#endif // PRT7_DECODIFICACION_PARALELA_H
@@ -0,0 +1,368 @@
+/**
+ * @file Decodificador.h
+ * @brief Sesión de decodificación PRT-7 para usar la biblioteca sin main()
+ */
+
+#ifndef PRT7_DECODIFICADOR_H
+#define PRT7_DECODIFICADOR_H
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "prt7/AnalizadorBinario.h"
+#include "prt7/EscritorSalida.h"
+#include "prt7/ListaDeCarga.h"
+#include "prt7/PuertoSerial.h"
+#include "prt7/RotorCompuesto.h"
+#include "prt7/RotorDeMapeo.h"
+#include "prt7/Trama.h"
+
+struct InstantaneaSesion;
+class PuntoControl;
+
+/**
+ * @class ObservadorTramas
+ * @brief Interfaz de quien quiere ver cada trama que procesa una sesión
+ */
+class ObservadorTramas {
+public:
+    /**
+     * @brief Destructor virtual
+     */
+    virtual ~ObservadorTramas() {}
+
+    /**
+     * @brief Recibe un lote de tramas justo antes de que la sesión lo aplique
+     * @param tramas Tramas en orden, hasta END inclusive
+     * @param cantidad Cantidad de tramas (al menos 1)
+     *
+     * Las tramas llegan tal como se analizaron: una MAP a un rotor que no
+     * existe se entrega igual y después se cuenta como mal formada.
+     */
+    virtual void tramasRecibidas(const Trama* tramas, int cantidad) = 0;
+};
+
+/**
+ * @class Decodificador
+ * @brief Sesión de decodificación alimentada por bytes
+ *
+ * Agrupa la lista de carga, el rotor y la salida de una transmisión, junto
+ * con sus contadores. Es el motor que comparten el puerto serial, la
+ * reproducción de capturas y cualquier aplicación que enlace la biblioteca:
+ * alimentar() recibe bytes en bloques de cualquier tamaño (una línea puede
+ * quedar partida entre dos llamadas) y finalizar() procesa lo pendiente al
+ * cerrarse el flujo.
+ */
+class Decodificador {
+public:
+    static const int LONGITUD_MAXIMA_LINEA = 256;  ///< Bytes que se conservan de una línea partida
+    static const int ESPERA_PRESUPUESTO_MS = 100;  ///< Pausa de la lectura entre reintentos de derrame
+
+private:
+    ListaDeCarga carga;           ///< Lista donde se ensambla el mensaje
+    RotorDeMapeo rotor;           ///< Rotor de mapeo de la transmisión
+    RotorCompuesto* cadena;       ///< Cadena de rotores, o nullptr para el rotor único
+    EscritorSalida salida;        ///< Destino de los reportes por trama
+    long long tramasRecibidas;    ///< Tramas válidas procesadas
+    long long tramasMalformadas;  ///< Líneas descartadas por el analizador
+    long long tramasCarga;        ///< Tramas LOAD procesadas
+    long long movimientosRotor;   ///< Movimientos de rotor aplicados (MAP y avance de la cadena)
+    bool finTransmision;          ///< true después de recibir END
+    ObservadorTramas* observador; ///< Quien recibe cada lote de tramas, o nullptr
+
+    /**
+     * @struct ResumenPublicado
+     * @brief Contadores ya sumados a RegistroMetricas::global()
+     */
+    struct ResumenPublicado {
+        long long recibidas;     ///< Tramas válidas
+        long long malformadas;   ///< Líneas descartadas
+        long long cargas;        ///< Tramas LOAD
+        long long movimientos;   ///< Movimientos de rotor
+        bool fin;                ///< true si END ya se contó
+    };
+    ResumenPublicado publicado;  ///< Lo publicado hasta ahora
+
+    FormatoTramas formato;        ///< Codificación de los bytes de alimentar()
+    AnalizadorBinario binario;    ///< Estado del análisis en FORMATO_BINARIO
+
+    char pendiente[LONGITUD_MAXIMA_LINEA];  ///< Línea incompleta del bloque anterior
+    int usadosPendiente;                    ///< Bytes ocupados en pendiente
+    bool pendienteTruncado;                 ///< true si la línea pendiente no cupo completa
+
+    /**
+     * @brief Agrega bytes a la línea pendiente
+     * @param datos Bytes a agregar
+     * @param longitud Cantidad de bytes
+     */
+    void acumularPendiente(const char* datos, size_t longitud);
+
+    /**
+     * @brief Procesa la línea pendiente y la vacía
+     */
+    void procesarPendiente();
+
+    /**
+     * @brief Cuerpo de alimentar() en FORMATO_BINARIO
+     * @param datos Bytes recibidos
+     * @param longitud Cantidad de bytes
+     */
+    void alimentarBinario(const char* datos, size_t longitud);
+
+    /**
+     * @brief Procesa un lote de tramas con la cadena de rotores
+     * @param tramas Tramas a procesar en orden
+     * @param cantidad Cantidad de tramas
+     */
+    void procesarConCadena(const Trama* tramas, int cantidad);
+
+    Decodificador(const Decodificador&) = delete;
+    Decodificador& operator=(const Decodificador&) = delete;
+
+public:
+    /**
+     * @brief Constructor con salida a std::cout
+     * @param nivel Nivel de detalle de los reportes por trama
+     */
+    Decodificador(NivelDetalle nivel = DETALLE_SILENCIOSO);
+
+    /**
+     * @brief Constructor con un flujo de salida propio
+     * @param nivel Nivel de detalle de los reportes por trama
+     * @param flujo Flujo donde se escriben los reportes
+     */
+    Decodificador(NivelDetalle nivel, std::ostream& flujo);
+
+    /**
+     * @brief Destructor que libera la cadena de rotores
+     */
+    ~Decodificador();
+
+    /**
+     * @brief Reemplaza el rotor único por una cadena de rotores
+     * @param cantidad Rotores de la cadena (1 a RotorCompuesto::MAXIMO_ROTORES)
+     * @param avance true para que cada carácter mueva la cadena
+     *
+     * Debe llamarse antes de alimentar la sesión. Con una cadena, las tramas
+     * M,<rotor>,<n> mueven el rotor indicado y M,<n> el primero.
+     */
+    void configurarRotores(int cantidad, bool avance);
+
+    /**
+     * @brief Cadena de rotores configurada
+     * @return Cadena, o nullptr si se usa el rotor único
+     */
+    const RotorCompuesto* getCadena() const {
+        return cadena;
+    }
+
+    /**
+     * @brief Elige quién recibe cada lote de tramas antes de aplicarlo
+     * @param o Observador, o nullptr para ninguno (sin costo por trama)
+     */
+    void setObservador(ObservadorTramas* o) {
+        observador = o;
+    }
+
+    /**
+     * @brief Elige la codificación de los bytes que recibe alimentar()
+     * @param f FORMATO_TEXTO (por defecto) o FORMATO_BINARIO
+     *
+     * Debe llamarse antes de alimentar la sesión. procesarLector() usa la
+     * codificación del propio lector (LectorSerial::setFormato()).
+     */
+    void setFormato(FormatoTramas f) {
+        formato = f;
+        binario.reiniciar();
+    }
+
+    /**
+     * @brief Codificación de los bytes que recibe alimentar()
+     * @return Formato configurado
+     */
+    FormatoTramas getFormato() const {
+        return formato;
+    }
+
+    /**
+     * @brief Alimenta la sesión con un bloque de bytes PRT-7 (texto o binario según getFormato())
+     * @param datos Bytes recibidos
+     * @param longitud Cantidad de bytes
+     * @return false si la transmisión ya terminó con END
+     */
+    bool alimentar(const char* datos, size_t longitud);
+
+    /**
+     * @brief Cierra el flujo: procesa una última línea sin fin de línea (o descarta una trama binaria incompleta) y vacía la salida
+     */
+    void finalizar();
+
+    /**
+     * @brief Procesa un lote de tramas ya analizadas
+     * @param tramas Tramas a procesar en orden
+     * @param cantidad Cantidad de tramas
+     */
+    void procesarTramas(const Trama* tramas, int cantidad);
+
+    /**
+     * @brief Analiza y procesa una línea completa
+     * @param linea Inicio de la línea
+     * @param longitud Bytes de la línea sin el fin de línea
+     */
+    void procesarLinea(const char* linea, int longitud);
+
+    /**
+     * @brief Procesa todas las líneas completas que tenga el buffer de un lector
+     * @param lector Lector recién rellenado
+     *
+     * Analiza por lotes, cuenta las líneas mal formadas y vacía la salida una
+     * vez al terminar.
+     */
+    void procesarLector(LectorSerial& lector);
+
+    /**
+     * @brief Suma líneas descartadas por un analizador externo (ej. LectorSerial)
+     * @param cantidad Líneas mal formadas
+     */
+    void contarMalformadas(long long cantidad) {
+        tramasMalformadas += cantidad;
+    }
+
+    /**
+     * @brief Suma el resultado de tramas procesadas fuera de la sesión (ej. en paralelo)
+     * @param recibidas Tramas válidas procesadas, incluido END
+     * @param malformadas Líneas descartadas
+     * @param cargas Tramas LOAD entre las recibidas
+     * @param fin true si entre ellas estaba END
+     */
+    void registrarResultado(long long recibidas, long long malformadas, long long cargas, bool fin) {
+        tramasRecibidas += recibidas;
+        tramasMalformadas += malformadas;
+        tramasCarga += cargas;
+        movimientosRotor += recibidas - cargas - (fin ? 1 : 0);
+        finTransmision = finTransmision || fin;
+    }
+
+    /**
+     * @brief Suma a las métricas globales lo procesado desde la última publicación
+     *
+     * alimentar(), procesarLector() y finalizar() la llaman al terminar cada
+     * bloque; quien llame a procesarTramas() directamente debe llamarla por
+     * su cuenta de vez en cuando.
+     */
+    void publicarMetricas();
+
+    /**
+     * @brief Copia contadores, rotores y línea o trama a medias
+     * @param destino Instantánea a completar (el mensaje no se incluye)
+     */
+    void capturarEstado(InstantaneaSesion& destino) const;
+
+    /**
+     * @brief Continúa una sesión desde una instantánea de capturarEstado()
+     * @param origen Instantánea guardada
+     * @return false si no corresponde a la configuración de rotores o al formato de esta sesión
+     *
+     * Restaura contadores y rotores; la línea o trama a medias se restaura
+     * aparte con restaurarAnalizador(). Lo restaurado no vuelve a sumarse a
+     * las métricas.
+     */
+    bool restaurarEstado(const InstantaneaSesion& origen);
+
+    /**
+     * @brief Continúa la línea o trama a medias de una instantánea
+     * @param origen Instantánea guardada
+     * @return false si el estado del analizador binario no es válido
+     */
+    bool restaurarAnalizador(const InstantaneaSesion& origen);
+
+    /**
+     * @brief Indica si ya se recibió END
+     * @return true si la transmisión terminó
+     */
+    bool haTerminado() const {
+        return finTransmision;
+    }
+
+    /**
+     * @brief Tramas válidas procesadas
+     * @return Contador de tramas
+     */
+    long long getTramasRecibidas() const {
+        return tramasRecibidas;
+    }
+
+    /**
+     * @brief Líneas descartadas por mal formadas
+     * @return Contador de líneas
+     */
+    long long getTramasMalformadas() const {
+        return tramasMalformadas;
+    }
+
+    /**
+     * @brief Tramas LOAD procesadas
+     * @return Contador de tramas LOAD
+     */
+    long long getTramasCarga() const {
+        return tramasCarga;
+    }
+
+    /**
+     * @brief Movimientos de rotor aplicados
+     * @return Tramas MAP aceptadas más los avances de la cadena
+     */
+    long long getMovimientosRotor() const {
+        return movimientosRotor;
+    }
+
+    /**
+     * @brief Deja de leer hasta que la carga vuelva a su presupuesto de memoria
+     *
+     * Sólo espera si un derrame falló (ver ListaDeCarga::configurarPresupuesto()).
+     * Mientras tanto los bytes se acumulan en el driver del puerto, que con
+     * control de flujo frena al emisor, en lugar de crecer la memoria del
+     * proceso. Cada pausa de ESPERA_PRESUPUESTO_MS se cuenta en
+     * METRICA_ESPERAS_PRESUPUESTO.
+     */
+    void esperarPresupuesto();
+
+    /**
+     * @brief Lista con el mensaje ensamblado hasta ahora
+     * @return Lista de carga de la sesión
+     */
+    ListaDeCarga& getCarga() {
+        return carga;
+    }
+
+    /**
+     * @brief Rotor de mapeo de la sesión
+     * @return Rotor en su posición actual (con una cadena, el rotor equivalente a toda ella)
+     */
+    RotorDeMapeo& getRotor() {
+        return cadena ? cadena->getCompuesto() : rotor;
+    }
+
+    /**
+     * @brief Escritor de los reportes por trama
+     * @return Escritor de la sesión
+     */
+    EscritorSalida& getSalida() {
+        return salida;
+    }
+};
+
+/**
+ * @brief Procesa todo lo que entregue un lector hasta END, fin de datos o inactividad
+ * @param lector Lector ya asociado a un puerto o a la entrada estándar
+ * @param decodificador Sesión que recibe las tramas
+ * @param inactividadMs Tiempo máximo sin datos antes de cerrar la sesión (0 = sin límite)
+ * @param puntoControl Punto de control que se guarda periódicamente y al terminar, o nullptr
+ *
+ * El fin de datos es un EOF o un cuelgue que informa el propio lector; no
+ * se consumen bytes del flujo para averiguarlo.
+ */
+void decodificarFlujo(LectorSerial& lector, Decodificador& decodificador, int inactividadMs,
+                      PuntoControl* puntoControl = nullptr);
+
+#endif // PRT7_DECODIFICADOR_H
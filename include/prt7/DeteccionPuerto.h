@@ -0,0 +1,143 @@
+/**
+ * @file DeteccionPuerto.h
+ * @brief Búsqueda del puerto por el que llega una transmisión PRT-7
+ */
+
+#ifndef PRT7_DETECCION_PUERTO_H
+#define PRT7_DETECCION_PUERTO_H
+
+#include "prt7/PuertoSerial.h"
+
+/**
+ * @struct PuertoDetectado
+ * @brief Puerto elegido por DetectorPuertos, listo para decodificar
+ *
+ * El lector conserva los bytes recibidos durante la búsqueda, incluida la
+ * primera trama válida, así que no se pierde nada. Quien lo recibe debe
+ * cerrar el puerto y liberar el lector.
+ */
+struct PuertoDetectado {
+    static const int LONGITUD_NOMBRE = 64;  ///< Bytes del nombre, con el '\0'
+
+    char nombre[LONGITUD_NOMBRE];  ///< Nombre del puerto (ej: "/dev/ttyUSB1" o "COM4")
+    DescriptorPuerto puerto;       ///< Puerto abierto
+    LectorSerial* lector;          ///< Lector del puerto con lo ya recibido
+};
+
+/**
+ * @class DetectorPuertos
+ * @brief Abre a la vez todos los puertos candidatos y elige el primero que transmite
+ *
+ * Los candidatos son /dev/ttyUSB* y /dev/ttyACM* en POSIX, o COM1 a COM32 en
+ * Windows; con un prefijo propio (ej: "/dev/ttyS") se usan los que empiecen
+ * con él. Todos se esperan juntos con poll(), así que la búsqueda termina en
+ * cuanto cualquiera entrega una trama PRT-7 válida, y los demás se cierran
+ * sin esperar a que respondan. La lista se vuelve a recorrer cada
+ * INTERVALO_REESCANEO_MS para incluir dispositivos que aparezcan mientras
+ * tanto, en lugar de salir y depender de un reinicio externo.
+ */
+class DetectorPuertos {
+public:
+    static const int MAXIMO_CANDIDATOS = 64;         ///< Puertos abiertos a la vez
+    static const int INTERVALO_REESCANEO_MS = 500;   ///< Tiempo entre recorridos de la lista
+    static const int ESPERA_MS = 50;                 ///< Espera máxima de cada vuelta
+
+private:
+    /**
+     * @struct Candidato
+     * @brief Puerto abierto durante la búsqueda
+     */
+    struct Candidato {
+        char nombre[PuertoDetectado::LONGITUD_NOMBRE];  ///< Nombre del puerto
+        DescriptorPuerto puerto;                        ///< Puerto abierto
+        LectorSerial* lector;                           ///< Bytes recibidos hasta ahora
+    };
+
+    ConfiguracionSerial config;            ///< Configuración común de los puertos
+    const char* prefijo;                   ///< Prefijo propio de los nombres, o nullptr
+    Candidato candidatos[MAXIMO_CANDIDATOS];  ///< Puertos abiertos
+    int cantidad;                          ///< Candidatos abiertos
+    int probados;                          ///< Aperturas de puertos realizadas
+
+    /**
+     * @brief Indica si un puerto ya está abierto
+     * @param nombre Nombre del puerto
+     * @return true si es uno de los candidatos
+     */
+    bool estaAbierto(const char* nombre) const;
+
+    /**
+     * @brief Abre un puerto y lo agrega a los candidatos (si no lo estaba)
+     * @param nombre Nombre del puerto
+     */
+    void probar(const char* nombre);
+
+    /**
+     * @brief Abre los puertos cuyo nombre empieza con un prefijo
+     * @param inicioNombre Prefijo (ej: "/dev/ttyUSB" o "COM")
+     *
+     * En POSIX se leen las entradas del directorio del prefijo; en Windows
+     * se prueban los números 1 a 32 detrás del prefijo.
+     */
+    void recorrerPrefijo(const char* inicioNombre);
+
+    /**
+     * @brief Recorre la lista de puertos del sistema y abre los nuevos
+     */
+    void reescanear();
+
+    /**
+     * @brief Cierra un candidato y lo quita de la lista
+     * @param indice Posición del candidato
+     */
+    void descartar(int indice);
+
+    /**
+     * @brief Lee lo disponible de un candidato y comprueba si ya transmitió una trama
+     * @param indice Posición del candidato
+     * @param timeoutMs Espera máxima de la lectura
+     * @return 1 si entregó una trama válida, 0 si aún no, -1 si el puerto falló
+     */
+    int atender(int indice, int timeoutMs);
+
+    /**
+     * @brief Entrega un candidato como resultado y cierra todos los demás
+     * @param indice Posición del candidato elegido
+     * @param resultado Puerto a completar
+     */
+    void elegir(int indice, PuertoDetectado& resultado);
+
+    DetectorPuertos(const DetectorPuertos&) = delete;
+    DetectorPuertos& operator=(const DetectorPuertos&) = delete;
+
+public:
+    /**
+     * @brief Constructor
+     * @param base Configuración de los puertos (se ignora base.puerto)
+     * @param prefijoNombres Prefijo de los nombres candidatos, o nullptr para los habituales
+     */
+    DetectorPuertos(const ConfiguracionSerial& base, const char* prefijoNombres);
+
+    /**
+     * @brief Destructor que cierra los candidatos que queden abiertos
+     */
+    ~DetectorPuertos();
+
+    /**
+     * @brief Espera a que algún candidato transmita una trama válida
+     * @param limiteMs Tiempo máximo de búsqueda (0 = sin límite)
+     * @param resultado Puerto elegido
+     * @return false si venció el plazo sin que ningún puerto transmitiera
+     */
+    bool detectar(int limiteMs, PuertoDetectado& resultado);
+
+    /**
+     * @brief Aperturas de puertos realizadas (un puerto que falló y se reabrió cuenta dos veces)
+     * @return Cantidad de aperturas
+     */
+    int getProbados() const {
+        return probados;
+    }
+};
+
+#endif // PRT7_DETECCION_PUERTO_H
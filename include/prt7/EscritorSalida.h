@@ -0,0 +1,147 @@
+/**
+ * @file EscritorSalida.h
+ * @brief Salida con buffer para los reportes por trama
+ */
+
+#ifndef PRT7_ESCRITOR_SALIDA_H
+#define PRT7_ESCRITOR_SALIDA_H
+
+#include <cstring>
+#include <iosfwd>
+
+/**
+ * @enum NivelDetalle
+ * @brief Cantidad de información que se imprime por cada trama
+ */
+enum NivelDetalle {
+    DETALLE_SILENCIOSO,  ///< Sólo el mensaje final
+    DETALLE_DELTA,       ///< Una línea por trama con el fragmento decodificado
+    DETALLE_TRAZA        ///< Como DETALLE_DELTA, más el mensaje acumulado en cada LOAD
+};
+
+/**
+ * @class EscritorSalida
+ * @brief Acumula la salida de consola y la escribe en bloques
+ *
+ * Evita el vaciado de std::endl en cada línea: el contenido se envía al
+ * flujo de destino (std::cout por defecto) cuando el buffer se llena o
+ * cuando se llama a vaciar(), lo que el bucle principal hace al terminar
+ * cada lote de tramas.
+ */
+class EscritorSalida {
+private:
+    static const int CAPACIDAD = 65536;  ///< Tamaño del buffer en bytes
+
+    char buffer[CAPACIDAD];  ///< Texto pendiente de escribir
+    int usados;              ///< Bytes ocupados en el buffer
+    NivelDetalle nivel;      ///< Nivel de detalle de las tramas
+    std::ostream* destino;   ///< Flujo donde se vacía el buffer
+
+    /**
+     * @brief Escribe bytes directamente en el destino
+     * @param texto Bytes a escribir
+     * @param longitud Cantidad de bytes
+     */
+    void escribirDestino(const char* texto, int longitud);
+
+    EscritorSalida(const EscritorSalida&) = delete;
+    EscritorSalida& operator=(const EscritorSalida&) = delete;
+
+public:
+    /**
+     * @brief Constructor que escribe en std::cout
+     * @param n Nivel de detalle inicial
+     */
+    EscritorSalida(NivelDetalle n = DETALLE_DELTA);
+
+    /**
+     * @brief Constructor con un flujo de destino
+     * @param n Nivel de detalle inicial
+     * @param flujo Flujo donde se escribirá la salida
+     */
+    EscritorSalida(NivelDetalle n, std::ostream& flujo);
+
+    /**
+     * @brief Destructor que vacía lo pendiente
+     */
+    ~EscritorSalida();
+
+    /**
+     * @brief Escritor usado por las tramas polimórficas (TramaBase)
+     * @return Escritor compartido del proceso
+     */
+    static EscritorSalida& predeterminado();
+
+    /**
+     * @brief Obtiene el nivel de detalle
+     * @return Nivel actual
+     */
+    NivelDetalle getNivel() const {
+        return nivel;
+    }
+
+    /**
+     * @brief Cambia el nivel de detalle
+     * @param n Nuevo nivel
+     */
+    void setNivel(NivelDetalle n) {
+        nivel = n;
+    }
+
+    /**
+     * @brief Flujo donde se vacía el buffer
+     * @return Flujo de destino
+     */
+    std::ostream& getDestino() const {
+        return *destino;
+    }
+
+    /**
+     * @brief Agrega bytes al buffer
+     * @param texto Bytes a escribir
+     * @param longitud Cantidad de bytes
+     */
+    void escribir(const char* texto, int longitud) {
+        if (usados + longitud > CAPACIDAD) {
+            vaciar();
+            if (longitud > CAPACIDAD) {
+                escribirDestino(texto, longitud);
+                return;
+            }
+        }
+        memcpy(buffer + usados, texto, longitud);
+        usados += longitud;
+    }
+
+    /**
+     * @brief Agrega una cadena terminada en '\\0'
+     * @param texto Cadena a escribir
+     */
+    void escribir(const char* texto) {
+        escribir(texto, static_cast<int>(strlen(texto)));
+    }
+
+    /**
+     * @brief Agrega un carácter
+     * @param c Carácter a escribir
+     */
+    void escribirCaracter(char c) {
+        if (usados == CAPACIDAD) {
+            vaciar();
+        }
+        buffer[usados++] = c;
+    }
+
+    /**
+     * @brief Agrega un entero en base 10
+     * @param valor Entero a escribir
+     */
+    void escribirEntero(long long valor);
+
+    /**
+     * @brief Escribe en el destino todo lo pendiente
+     */
+    void vaciar();
+};
+
+#endif // PRT7_ESCRITOR_SALIDA_H
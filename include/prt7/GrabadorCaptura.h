@@ -0,0 +1,199 @@
+/**
+ * @file GrabadorCaptura.h
+ * @brief Grabación de los bytes recibidos con marcas de tiempo, en un hilo aparte
+ */
+
+#ifndef PRT7_GRABADOR_CAPTURA_H
+#define PRT7_GRABADOR_CAPTURA_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "prt7/AnalizadorBinario.h"
+
+/**
+ * @class GrabadorCaptura
+ * @brief Escribe en un archivo los bytes crudos que lee un LectorSerial
+ *
+ * La captura se puede reproducir tal cual con --input: son los mismos bytes
+ * que llegaron por el puerto, con una marca de tiempo delante de la primera
+ * trama que empieza en cada lectura. La marca es el instante de
+ * relojMonotonicoNs() en que llegó esa lectura. En texto es una línea de
+ * comentario ("#<nanosegundos>"); en binario, una trama
+ * AnalizadorBinario::ETIQUETA_MARCA_TIEMPO. Una lectura en la que no empieza
+ * ninguna trama no lleva marca.
+ *
+ * registrar() sólo copia los bytes a un anillo de un productor y un
+ * consumidor, sin cerrojos ni llamadas al sistema. Un hilo propio vacía el
+ * anillo cada INTERVALO_MS, agrega las marcas y escribe en bloques de hasta
+ * BLOQUE_ESCRITURA bytes. Si el disco no da abasto y el anillo se llena, la
+ * lectura que no cabe se descarta de la captura (y se cuenta en
+ * getPerdidos()) en lugar de demorar la decodificación. Las tramas
+ * alrededor de un hueco pueden reproducirse como mal formadas.
+ */
+class GrabadorCaptura {
+public:
+    static const size_t CAPACIDAD_ANILLO = 1 << 22;  ///< Bytes entre el lector y el hilo escritor
+    static const size_t BLOQUE_ESCRITURA = 1 << 20;  ///< Bytes máximos de cada escritura al archivo
+    static const size_t MAXIMO_REGISTRO = 1 << 16;   ///< Bytes máximos de una lectura en el anillo
+    static const int INTERVALO_MS = 10;              ///< Espera máxima del hilo escritor entre vaciados
+
+private:
+    static const int LINEA_CACHE = 64;               ///< Bytes de una línea de caché
+
+    /**
+     * @struct Cabecera
+     * @brief Lo que precede a los bytes de cada lectura en el anillo
+     */
+    struct Cabecera {
+        long long instante;  ///< relojMonotonicoNs() de la lectura
+        size_t longitud;     ///< Bytes que siguen a la cabecera
+    };
+
+    FILE* archivo;                 ///< Captura de destino
+    FormatoTramas formato;         ///< Codificación del flujo, para elegir el tipo de marca
+    char* anillo;                  ///< CAPACIDAD_ANILLO bytes de registros pendientes
+
+    // Relleno en lugar de alignas, igual que en ColaSPSC
+    char relleno0[LINEA_CACHE];
+    std::atomic<size_t> cabeza;    ///< Siguiente byte a leer (hilo escritor)
+    char relleno1[LINEA_CACHE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> cola;      ///< Siguiente byte a escribir (lector)
+    char relleno2[LINEA_CACHE - sizeof(std::atomic<size_t>)];
+    std::atomic<unsigned long long> grabados;  ///< Bytes recibidos ya escritos
+    std::atomic<unsigned long long> perdidos;  ///< Bytes recibidos descartados
+
+    std::thread hilo;              ///< Hilo escritor
+    std::mutex cerrojo;            ///< Protege detenido
+    std::condition_variable aviso; ///< Despierta al hilo para detenerse
+    bool detenido;                 ///< true al pedir la detención
+
+    // Estado del hilo escritor
+    char* registro;                ///< Copia contigua de la lectura en curso
+    char* bloque;                  ///< Bytes preparados para la próxima escritura
+    size_t usadosBloque;           ///< Bytes ocupados en bloque
+    bool enLimite;                 ///< Texto: el último byte escrito terminó una línea
+    AnalizadorBinario separador;   ///< Binario: sigue las tramas para saber dónde cabe una marca
+    bool fallo;                    ///< true si una escritura al archivo falló
+
+    /**
+     * @brief Copia bytes al anillo, dando la vuelta si hace falta
+     * @param posicion Posición lógica (sin reducir) donde empezar
+     * @param datos Bytes a copiar
+     * @param longitud Cantidad de bytes
+     */
+    void copiarAlAnillo(size_t posicion, const void* datos, size_t longitud);
+
+    /**
+     * @brief Copia bytes desde el anillo, dando la vuelta si hace falta
+     * @param posicion Posición lógica (sin reducir) donde empezar
+     * @param destino Destino de los bytes
+     * @param longitud Cantidad de bytes
+     */
+    void copiarDelAnillo(size_t posicion, void* destino, size_t longitud) const;
+
+    /**
+     * @brief Posición de la primera trama que empieza en una lectura
+     * @param datos Bytes de la lectura
+     * @param longitud Cantidad de bytes
+     * @return Desplazamiento de la trama, o longitud si no empieza ninguna
+     *
+     * Avanza el estado de separación por toda la lectura.
+     */
+    size_t buscarInicioTrama(const char* datos, size_t longitud);
+
+    /**
+     * @brief Agrega bytes al bloque, escribiéndolo cuando se llena
+     * @param datos Bytes a agregar
+     * @param longitud Cantidad de bytes
+     */
+    void agregar(const char* datos, size_t longitud);
+
+    /**
+     * @brief Agrega la marca de tiempo de una lectura
+     * @param instante relojMonotonicoNs() de la lectura
+     */
+    void agregarMarca(long long instante);
+
+    /**
+     * @brief Escribe el bloque en el archivo
+     */
+    void escribirBloque();
+
+    /**
+     * @brief Pasa al archivo todas las lecturas pendientes del anillo
+     */
+    void drenar();
+
+    /**
+     * @brief Cuerpo del hilo escritor
+     */
+    void ejecutar();
+
+    GrabadorCaptura(const GrabadorCaptura&) = delete;
+    GrabadorCaptura& operator=(const GrabadorCaptura&) = delete;
+
+public:
+    /**
+     * @brief Constructor sin archivo
+     * @param f Codificación de las tramas del flujo que se grabará
+     */
+    explicit GrabadorCaptura(FormatoTramas f = FORMATO_TEXTO);
+
+    /**
+     * @brief Destructor que termina la grabación si sigue abierta
+     */
+    ~GrabadorCaptura();
+
+    /**
+     * @brief Abre la captura e inicia el hilo escritor
+     * @param ruta Archivo de destino; si ya existe, la grabación se agrega al final
+     * @return true si el archivo pudo abrirse
+     */
+    bool abrir(const char* ruta);
+
+    /**
+     * @brief Encola una lectura para grabarla (sólo el hilo que lee el puerto)
+     * @param datos Bytes recibidos
+     * @param longitud Cantidad de bytes
+     * @param instante relojMonotonicoNs() de la lectura
+     *
+     * No espera nunca: si la lectura no cabe en el anillo, se descarta.
+     */
+    void registrar(const char* datos, size_t longitud, long long instante);
+
+    /**
+     * @brief Escribe lo pendiente, detiene el hilo y cierra el archivo
+     */
+    void cerrar();
+
+    /**
+     * @brief Bytes recibidos que ya se escribieron en la captura
+     * @return Bytes, sin contar las marcas de tiempo
+     */
+    unsigned long long getGrabados() const {
+        return grabados.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Bytes recibidos que no se grabaron porque el anillo estaba lleno
+     * @return Bytes descartados de la captura
+     */
+    unsigned long long getPerdidos() const {
+        return perdidos.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Indica si alguna escritura al archivo falló (ej. disco lleno)
+     * @return true si la captura quedó incompleta por un error de escritura
+     */
+    bool huboFallo() const {
+        return fallo;
+    }
+};
+
+#endif // PRT7_GRABADOR_CAPTURA_H
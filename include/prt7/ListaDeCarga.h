@@ -0,0 +1,408 @@
+/**
+ * @file ListaDeCarga.h
+ * @brief Lista doblemente enlazada donde se ensambla el mensaje decodificado
+ */
+
+#ifndef PRT7_LISTA_DE_CARGA_H
+#define PRT7_LISTA_DE_CARGA_H
+
+#include <cstddef>
+
+class EscritorSalida;
+class SumideroCarga;
+
+/**
+ * @struct NodoCarga
+ * @brief Nodo para la lista doblemente enlazada de carga
+ *
+ * Cada nodo guarda un bloque de caracteres consecutivos en lugar de uno solo
+ * (lista desenrollada), lo que reduce el costo de punteros por carácter.
+ */
+struct NodoCarga {
+    static const int CAPACIDAD = 240;  ///< Caracteres por nodo
+
+    char datos[CAPACIDAD];  ///< Caracteres decodificados del bloque
+    int usados;             ///< Cantidad de posiciones ocupadas en datos
+    NodoCarga* siguiente;   ///< Puntero al siguiente nodo
+    NodoCarga* previo;      ///< Puntero al nodo previo
+};
+
+/**
+ * @class ArenaDeNodos
+ * @brief Reserva nodos de carga en lotes para evitar un new por nodo
+ *
+ * Los nodos se entregan de lotes contiguos cuyo tamaño se duplica hasta un
+ * máximo. Al destruir la arena se libera lote por lote, no nodo por nodo.
+ */
+class ArenaDeNodos {
+public:
+    static const int LOTE_MAXIMO = 256;   ///< Nodos máximos por lote
+
+private:
+    static const int LOTE_INICIAL = 4;    ///< Nodos del primer lote
+
+    /**
+     * @struct Lote
+     * @brief Lote de nodos reservado con una sola asignación
+     */
+    struct Lote {
+        NodoCarga* nodos;  ///< Arreglo de nodos del lote
+        int cantidad;      ///< Tamaño del arreglo
+        Lote* siguiente;   ///< Lote reservado anteriormente
+    };
+
+    Lote* lotes;       ///< Lote más reciente
+    int entregados;    ///< Nodos ya entregados del lote más reciente
+    NodoCarga* libres; ///< Nodos devueltos, enlazados por siguiente
+    size_t reservados; ///< Bytes de todos los lotes
+
+    ArenaDeNodos(const ArenaDeNodos&) = delete;
+    ArenaDeNodos& operator=(const ArenaDeNodos&) = delete;
+
+public:
+    /**
+     * @brief Constructor de una arena vacía (no reserva memoria)
+     */
+    ArenaDeNodos() : lotes(nullptr), entregados(0), libres(nullptr), reservados(0) {}
+
+    /**
+     * @brief Destructor que libera todos los lotes
+     */
+    ~ArenaDeNodos();
+
+    /**
+     * @brief Entrega un nodo vacío y sin enlazar
+     * @return Nodo listo para usarse
+     */
+    NodoCarga* obtener();
+
+    /**
+     * @brief Devuelve un nodo desenlazado para reutilizarlo
+     * @param nodo Nodo entregado antes por obtener()
+     *
+     * La memoria no vuelve al sistema hasta destruir la arena; el nodo se
+     * entrega de nuevo en la próxima llamada a obtener().
+     */
+    void liberar(NodoCarga* nodo) {
+        nodo->siguiente = libres;
+        libres = nodo;
+    }
+
+    /**
+     * @brief Memoria reservada por la arena
+     * @return Bytes de todos los lotes, entregados o no
+     */
+    size_t getReservados() const {
+        return reservados;
+    }
+};
+
+/**
+ * @class ListaDeCarga
+ * @brief Lista doblemente enlazada para almacenar caracteres decodificados
+ *
+ * Almacena los fragmentos de datos en el orden en que son procesados. Los
+ * caracteres se agrupan en nodos de NodoCarga::CAPACIDAD posiciones tomados
+ * de una ArenaDeNodos, así que insertar sólo reserva memoria al llenarse un
+ * nodo y la destrucción es proporcional a la cantidad de lotes.
+ *
+ * Con un SumideroCarga configurado, cada nodo se entrega al sumidero en
+ * cuanto se llena. Si además no se conserva el historial, la lista retiene
+ * sólo una ventana de los nodos más recientes y devuelve los antiguos a la
+ * arena, de modo que la memoria queda acotada sin importar el largo del
+ * mensaje. Si el sumidero rechaza un bloque (disco lleno, conexión
+ * cortada), lo rechazado se cuenta en getSinEntregar() y en
+ * METRICA_SIN_ENTREGAR, se avisa una vez por stderr y la ventana deja de
+ * retirar nodos: lo que sigue queda en memoria y en el mensaje final.
+ *
+ * Con un presupuesto de memoria (configurarPresupuesto()) la lista no
+ * retiene más nodos de los que caben en él, tenga o no historial: al
+ * llegar al límite la cabeza sale de la memoria. Si hay sumidero, ya se le
+ * entregó al llenarse; si no, se escribe antes en el destino de derrame.
+ * Cuando ese destino falla (ej. disco lleno) la cabeza se conserva y la
+ * lista queda por encima del presupuesto hasta que aliviarPresupuesto()
+ * logre derramarla; mientras tanto excedePresupuesto() avisa a quien lee
+ * el flujo para que deje de leer.
+ *
+ * Todos los nodos salvo la cola están llenos, así que un índice de nodos
+ * (arreglo de punteros en orden) da la longitud, el acceso por posición y
+ * la copia a un buffer contiguo sin recorrer la lista enlazada.
+ */
+class ListaDeCarga {
+private:
+    NodoCarga* cabeza;  ///< Primer nodo de la lista
+    NodoCarga* cola;    ///< Último nodo de la lista
+    ArenaDeNodos arena; ///< Origen de la memoria de los nodos
+
+    SumideroCarga* sumidero;  ///< Destino de los nodos llenos (no es propiedad de la lista)
+    int ventanaNodos;         ///< Nodos retenidos sin historial (0 = sin límite)
+    bool historial;           ///< true para conservar todo aunque haya sumidero
+    int nodos;                ///< Nodos enlazados actualmente
+    int emitidosEnCola;       ///< Caracteres de la cola ya entregados al sumidero
+    long long sinEntregar;    ///< Caracteres que el sumidero rechazó
+    long long descartados;    ///< Caracteres entregados y ya retirados de la lista
+    SumideroCarga* derrame;   ///< Destino de los nodos retirados por el presupuesto sin sumidero
+    int limiteNodos;          ///< Nodos retenidos como máximo por el presupuesto (0 = sin límite)
+    size_t memoria;           ///< Bytes de la arena y del índice ya sumados a las métricas
+    bool contabilizada;       ///< false si la lista no cuenta en la memoria de carga ni en lo derramado
+
+    NodoCarga** indice;       ///< Nodos en orden: indice[primerNodo] es la cabeza
+    int capacidadIndice;      ///< Posiciones reservadas en indice
+    int primerNodo;           ///< Posición de la cabeza dentro de indice
+
+    /**
+     * @brief Deja lugar en el índice para un nodo más al final
+     */
+    void ampliarIndice();
+
+    /**
+     * @brief Entrega caracteres al sumidero y registra si los rechaza
+     * @param datos Caracteres en orden
+     * @param cantidad Cantidad de caracteres
+     */
+    void entregar(const char* datos, size_t cantidad);
+
+    /**
+     * @brief Enlaza un nodo nuevo al final de la lista
+     *
+     * Antes entrega al sumidero lo que falte de la cola llena y, si la
+     * ventana se excede, retira la cabeza.
+     */
+    void agregarNodo();
+
+    /**
+     * @brief Desenlaza la cabeza y la devuelve a la arena
+     */
+    void soltarCabeza();
+
+    /**
+     * @brief Saca la cabeza de la memoria por el presupuesto
+     * @return true si se retiró; false si el destino de derrame falló
+     */
+    bool derramarCabeza();
+
+    /**
+     * @brief Publica en las métricas los cambios de la memoria reservada
+     */
+    void contabilizarMemoria();
+
+    ListaDeCarga(const ListaDeCarga&) = delete;
+    ListaDeCarga& operator=(const ListaDeCarga&) = delete;
+
+public:
+    /**
+     * @brief Constructor que inicializa una lista vacía
+     */
+    ListaDeCarga()
+        : cabeza(nullptr), cola(nullptr), sumidero(nullptr), ventanaNodos(0),
+          historial(true), nodos(0), emitidosEnCola(0), sinEntregar(0), descartados(0),
+          derrame(nullptr), limiteNodos(0), memoria(0), contabilizada(true),
+          indice(nullptr), capacidadIndice(0), primerNodo(0) {}
+
+    /**
+     * @brief Destructor; la arena libera los nodos por lotes
+     */
+    ~ListaDeCarga();
+
+    /**
+     * @brief Inserta un carácter al final de la lista
+     * @param dato Carácter a insertar
+     */
+    void insertarAlFinal(char dato) {
+        if (!cola || cola->usados == NodoCarga::CAPACIDAD) {
+            agregarNodo();
+        }
+
+        cola->datos[cola->usados++] = dato;
+    }
+
+    /**
+     * @brief Inserta un bloque de caracteres al final de la lista
+     * @param datos Caracteres a insertar en orden
+     * @param cantidad Cantidad de caracteres
+     *
+     * Equivale a llamar insertarAlFinal() con cada carácter, pero copia
+     * nodo por nodo.
+     */
+    void insertarBloque(const char* datos, size_t cantidad);
+
+    /**
+     * @brief Inserta un mismo carácter varias veces al final de la lista
+     * @param caracter Carácter a repetir
+     * @param cantidad Repeticiones
+     *
+     * Equivale a insertarBloque() con un bloque de caracteres iguales, con
+     * un memset por nodo.
+     */
+    void rellenar(char caracter, size_t cantidad);
+
+    /**
+     * @brief Configura la entrega del mensaje mientras se ensambla
+     * @param destino Sumidero que recibe los nodos llenos (nullptr para ninguno)
+     * @param ventanaCaracteres Caracteres mínimos a retener sin historial (0 = todos)
+     * @param conservarHistorial true para no retirar nunca nodos de la lista
+     *
+     * Lo que la lista ya contiene (por ejemplo, un mensaje restaurado por
+     * PuntoControl) no se entrega al sumidero; la lista no libera el sumidero.
+     */
+    void configurarSalida(SumideroCarga* destino, size_t ventanaCaracteres, bool conservarHistorial);
+
+    /**
+     * @brief Acota la memoria de la lista
+     * @param bytes Presupuesto de los nodos y del índice (0 = sin límite)
+     * @param destinoDerrame Dónde escribir lo retirado si no hay sumidero (no pasa a ser de la lista)
+     *
+     * La arena reserva por lotes: un lote se descuenta del presupuesto para
+     * que el último no lo pase. Con sumidero, destinoDerrame no se usa.
+     */
+    void configurarPresupuesto(size_t bytes, SumideroCarga* destinoDerrame);
+
+    /**
+     * @brief Retiene lo mismo que otra lista ya configurada, descartando lo que ésta entrega
+     * @param original Lista cuya ventana, historial y presupuesto se copian
+     * @param descarte Recibe en lugar del sumidero y del derrame de original (no pasa a ser de la lista)
+     *
+     * Para copias que reciben los mismos caracteres que original, como la
+     * del escritor de la tubería: retiran los mismos nodos sin volver a
+     * entregarlos. Debe llamarse con la lista vacía.
+     */
+    void imitarRetencion(const ListaDeCarga& original, SumideroCarga* descarte);
+
+    /**
+     * @brief Indica si la lista retiene más nodos de los que permite el presupuesto
+     * @return true si un derrame falló y la cabeza sigue en memoria
+     */
+    bool excedePresupuesto() const {
+        return limiteNodos > 0 && nodos > limiteNodos;
+    }
+
+    /**
+     * @brief Reintenta derramar lo que excede el presupuesto
+     * @return true si la lista volvió a estar dentro del presupuesto
+     */
+    bool aliviarPresupuesto();
+
+    /**
+     * @brief Decide si la lista cuenta en INDICADOR_MEMORIA_CARGA y METRICA_BYTES_DERRAMADOS
+     * @param c false para copias auxiliares que no deben sumarse al mensaje
+     *
+     * Debe llamarse con la lista vacía; getMemoria() sigue al día igual.
+     */
+    void setContabilizada(bool c) {
+        contabilizada = c;
+    }
+
+    /**
+     * @brief Memoria reservada por la lista
+     * @return Bytes de la arena y del índice
+     */
+    size_t getMemoria() const {
+        return memoria;
+    }
+
+    /**
+     * @brief Entrega al sumidero los caracteres pendientes del último nodo
+     *
+     * También vacía el destino de derrame.
+     */
+    void vaciarSumidero();
+
+    /**
+     * @brief Caracteres que ya no están en la lista por haberse entregado o derramado
+     * @return 0 si la ventana y el presupuesto nunca se excedieron
+     */
+    long long getDescartados() const {
+        return descartados;
+    }
+
+    /**
+     * @brief Caracteres que el sumidero rechazó
+     * @return 0 si todas las entregas se aceptaron
+     */
+    long long getSinEntregar() const {
+        return sinEntregar;
+    }
+
+    /**
+     * @brief Cantidad de caracteres en la lista, en O(1)
+     * @return Caracteres retenidos (no incluye getDescartados())
+     */
+    size_t getLongitud() const {
+        return nodos == 0 ? 0 : static_cast<size_t>(nodos - 1) * NodoCarga::CAPACIDAD + cola->usados;
+    }
+
+    /**
+     * @brief Carácter en una posición, en O(1)
+     * @param posicion Posición desde el primer carácter retenido (menor que getLongitud())
+     * @return Carácter en esa posición
+     */
+    char caracterEn(size_t posicion) const {
+        const NodoCarga* nodo = indice[primerNodo + posicion / NodoCarga::CAPACIDAD];
+        return nodo->datos[posicion % NodoCarga::CAPACIDAD];
+    }
+
+    /**
+     * @brief Copia un tramo del mensaje a un buffer contiguo, un memcpy por nodo
+     * @param desde Posición del primer carácter a copiar
+     * @param destino Buffer de destino
+     * @param cantidad Caracteres a copiar como máximo
+     * @return Caracteres copiados (menos si el tramo pasa el final)
+     */
+    size_t copiar(size_t desde, char* destino, size_t cantidad) const;
+
+    /**
+     * @brief Cantidad de bloques contiguos de la lista
+     * @return Nodos retenidos
+     */
+    int getCantidadBloques() const {
+        return nodos;
+    }
+
+    /**
+     * @brief Bloque contiguo de caracteres, sin copiarlo
+     * @param bloque Número de bloque (menor que getCantidadBloques())
+     * @param datos Inicio de los caracteres del bloque
+     * @return Caracteres del bloque (todos los bloques menos el último están llenos)
+     *
+     * El puntero deja de ser válido si la lista retira nodos por su ventana.
+     */
+    size_t getBloque(int bloque, const char*& datos) const {
+        const NodoCarga* nodo = indice[primerNodo + bloque];
+        datos = nodo->datos;
+        return static_cast<size_t>(nodo->usados);
+    }
+
+    /**
+     * @brief Primer nodo, para recorrer la lista hacia adelante
+     * @return Cabeza de la lista (nullptr si está vacía)
+     */
+    const NodoCarga* getCabeza() const {
+        return cabeza;
+    }
+
+    /**
+     * @brief Último nodo, para recorrer la lista hacia atrás
+     * @return Cola de la lista (nullptr si está vacía)
+     */
+    const NodoCarga* getCola() const {
+        return cola;
+    }
+
+    /**
+     * @brief Imprime el mensaje completo ensamblado
+     */
+    void imprimirMensaje();
+
+    /**
+     * @brief Imprime el mensaje con formato detallado
+     */
+    void imprimirConFormato();
+
+    /**
+     * @brief Imprime el mensaje con formato detallado en un escritor con buffer
+     * @param salida Escritor de destino
+     */
+    void imprimirConFormato(EscritorSalida& salida);
+};
+
+#endif // PRT7_LISTA_DE_CARGA_H
@@ -0,0 +1,31 @@
+/**
+ * @file MapeoVectorial.h
+ * @brief Desplazamiento César de bloques completos con instrucciones vectoriales
+ */
+
+#ifndef PRT7_MAPEO_VECTORIAL_H
+#define PRT7_MAPEO_VECTORIAL_H
+
+#include <cstddef>
+
+/**
+ * @brief Mapea un bloque de caracteres con un desplazamiento fijo del rotor
+ * @param entrada Caracteres de las tramas LOAD
+ * @param salida Destino (puede ser el mismo buffer que entrada)
+ * @param cantidad Cantidad de caracteres
+ * @param desplazamiento Desplazamiento del rotor (0-25)
+ *
+ * Produce lo mismo que RotorDeMapeo::getMapeo() carácter por carácter: las
+ * letras se pasan a mayúscula y se desplazan, el resto queda igual. Usa
+ * AVX2, SSE2 o NEON según lo que habilite el compilador y una versión
+ * escalar para el resto del bloque.
+ */
+void mapearBloqueCesar(const char* entrada, char* salida, size_t cantidad, int desplazamiento);
+
+/**
+ * @brief Nombre del conjunto de instrucciones compilado
+ * @return "avx2", "sse2", "neon" o "escalar"
+ */
+const char* nucleoMapeoVectorial();
+
+#endif // PRT7_MAPEO_VECTORIAL_H
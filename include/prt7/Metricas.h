@@ -0,0 +1,324 @@
+/**
+ * @file Metricas.h
+ * @brief Contadores e histogramas del camino crítico, y su exportación periódica
+ */
+
+#ifndef PRT7_METRICAS_H
+#define PRT7_METRICAS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Instante de un reloj monotónico
+ * @return Nanosegundos desde un origen arbitrario (no retrocede con cambios de hora)
+ */
+long long relojMonotonicoNs();
+
+/**
+ * @enum ContadorMetrica
+ * @brief Contadores acumulados desde el inicio del proceso
+ */
+enum ContadorMetrica {
+    METRICA_BYTES_LEIDOS,       ///< Bytes que entraron al decodificador
+    METRICA_LECTURAS,           ///< Lecturas del puerto o de la entrada estándar con datos
+    METRICA_TRAMAS_LOAD,        ///< Tramas LOAD procesadas
+    METRICA_TRAMAS_MAP,         ///< Tramas MAP procesadas
+    METRICA_TRAMAS_FIN,         ///< Tramas END procesadas
+    METRICA_TRAMAS_MALFORMADAS, ///< Líneas descartadas
+    METRICA_ROTACIONES,         ///< Movimientos de rotor aplicados (MAP y avance de la cadena)
+    METRICA_ASIGNACIONES,       ///< Reservas de memoria del camino crítico
+    METRICA_BYTES_ASIGNADOS,    ///< Bytes de esas reservas
+    METRICA_BYTES_GRABADOS,     ///< Bytes recibidos escritos en la captura de --record
+    METRICA_BYTES_SIN_GRABAR,   ///< Bytes recibidos que la captura descartó por ir atrasada
+    METRICA_BYTES_DERRAMADOS,   ///< Caracteres retirados de memoria por el presupuesto de la carga
+    METRICA_ESPERAS_PRESUPUESTO, ///< Pausas de la lectura porque la carga no pudo bajar del presupuesto
+    METRICA_SIN_ENTREGAR,       ///< Caracteres que el sumidero de la carga no aceptó
+    TOTAL_CONTADORES
+};
+
+/**
+ * @enum IndicadorMetrica
+ * @brief Valores instantáneos
+ */
+enum IndicadorMetrica {
+    INDICADOR_COLA_TRAMAS,      ///< Lotes en la cola lector -> decodificador de la tubería
+    INDICADOR_COLA_EVENTOS,     ///< Lotes en la cola decodificador -> escritor de la tubería
+    INDICADOR_SESIONES,         ///< Sesiones multipuerto abiertas
+    INDICADOR_MEMORIA_CARGA,    ///< Bytes reservados por las listas de carga
+    INDICADOR_MEMORIA_CARGA_MAXIMA, ///< Máximo que alcanzó INDICADOR_MEMORIA_CARGA
+    TOTAL_INDICADORES
+};
+
+/**
+ * @class HistogramaLog2
+ * @brief Histograma de cubetas de potencias de dos, sin bloqueos
+ *
+ * La cubeta k cuenta los valores en [2^(k-1), 2^k); la 0 cuenta el cero.
+ * Registrar es un par de sumas relajadas, así que puede quedar activo.
+ */
+class HistogramaLog2 {
+public:
+    static const int CUBETAS = 48;  ///< Cubetas (hasta ~2^47 ns, más de un día)
+
+private:
+    std::atomic<unsigned long long> cubetas[CUBETAS];  ///< Cuentas por cubeta
+    std::atomic<unsigned long long> suma;              ///< Suma de los valores registrados
+
+    HistogramaLog2(const HistogramaLog2&) = delete;
+    HistogramaLog2& operator=(const HistogramaLog2&) = delete;
+
+public:
+    /**
+     * @brief Constructor con todas las cubetas en cero
+     */
+    HistogramaLog2();
+
+    /**
+     * @brief Cubeta que corresponde a un valor
+     * @param valor Valor a clasificar
+     * @return Índice de la cubeta (0 a CUBETAS - 1)
+     */
+    static int cubeta(unsigned long long valor) {
+        int k = 0;
+        while (valor != 0 && k < CUBETAS - 1) {
+            valor >>= 1;
+            k++;
+        }
+        return k;
+    }
+
+    /**
+     * @brief Límite superior (exclusivo) de una cubeta
+     * @param k Índice de la cubeta
+     * @return 2^k
+     */
+    static unsigned long long limite(int k) {
+        return 1ULL << k;
+    }
+
+    /**
+     * @brief Registra un valor
+     * @param valor Valor observado (ej. nanosegundos)
+     */
+    void registrar(unsigned long long valor) {
+        cubetas[cubeta(valor)].fetch_add(1, std::memory_order_relaxed);
+        suma.fetch_add(valor, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Cuenta de una cubeta
+     * @param k Índice de la cubeta
+     * @return Valores registrados en ella
+     */
+    unsigned long long getCuenta(int k) const {
+        return cubetas[k].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Suma de todos los valores registrados
+     * @return Suma
+     */
+    unsigned long long getSuma() const {
+        return suma.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Cantidad de valores registrados
+     * @return Suma de todas las cubetas
+     */
+    unsigned long long getTotal() const;
+
+    /**
+     * @brief Cota superior de un percentil
+     * @param fraccion Percentil entre 0 y 1 (ej. 0.99)
+     * @return Límite de la cubeta donde cae el percentil, o 0 si no hay valores
+     */
+    unsigned long long percentil(double fraccion) const;
+};
+
+/**
+ * @class RegistroMetricas
+ * @brief Métricas compartidas por todas las sesiones del proceso
+ *
+ * Las sesiones acumulan en contadores propios y publican la diferencia una
+ * vez por lote, así que cada hilo hace unas pocas sumas relajadas por cada
+ * decena de tramas y no hay cerrojos en el camino crítico.
+ */
+class RegistroMetricas {
+private:
+    std::atomic<unsigned long long> contadores[TOTAL_CONTADORES];  ///< Contadores acumulados
+    std::atomic<long long> indicadores[TOTAL_INDICADORES];         ///< Valores instantáneos
+    HistogramaLog2 latencia;                                       ///< Lectura a decodificación (ns)
+
+    RegistroMetricas(const RegistroMetricas&) = delete;
+    RegistroMetricas& operator=(const RegistroMetricas&) = delete;
+
+public:
+    /**
+     * @brief Constructor con todo en cero
+     */
+    RegistroMetricas();
+
+    /**
+     * @brief Registro del proceso
+     * @return Registro compartido
+     */
+    static RegistroMetricas& global();
+
+    /**
+     * @brief Suma a un contador
+     * @param contador Contador a incrementar
+     * @param cantidad Incremento
+     */
+    void sumar(ContadorMetrica contador, unsigned long long cantidad) {
+        contadores[contador].fetch_add(cantidad, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Fija un valor instantáneo
+     * @param indicador Indicador a fijar
+     * @param valor Valor actual
+     */
+    void fijar(IndicadorMetrica indicador, long long valor) {
+        indicadores[indicador].store(valor, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Suma (o resta) a un valor instantáneo
+     * @param indicador Indicador a modificar
+     * @param cantidad Diferencia
+     */
+    void ajustar(IndicadorMetrica indicador, long long cantidad) {
+        indicadores[indicador].fetch_add(cantidad, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Eleva un valor instantáneo, que sólo crece (marcas de pleamar)
+     * @param indicador Indicador a modificar
+     * @param valor Valor observado; se conserva el mayor
+     */
+    void elevar(IndicadorMetrica indicador, long long valor) {
+        long long actual = indicadores[indicador].load(std::memory_order_relaxed);
+        while (valor > actual &&
+               !indicadores[indicador].compare_exchange_weak(actual, valor, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Registra la latencia entre la lectura de un bloque y el fin de su decodificación
+     * @param nanosegundos Latencia observada
+     */
+    void registrarLatencia(long long nanosegundos) {
+        latencia.registrar(nanosegundos > 0 ? static_cast<unsigned long long>(nanosegundos) : 0);
+    }
+
+    /**
+     * @brief Valor de un contador
+     * @param contador Contador a consultar
+     * @return Valor acumulado
+     */
+    unsigned long long getContador(ContadorMetrica contador) const {
+        return contadores[contador].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Valor de un indicador
+     * @param indicador Indicador a consultar
+     * @return Valor actual
+     */
+    long long getIndicador(IndicadorMetrica indicador) const {
+        return indicadores[indicador].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Histograma de latencia de lectura a decodificación
+     * @return Histograma en nanosegundos
+     */
+    const HistogramaLog2& getLatencia() const {
+        return latencia;
+    }
+
+    /**
+     * @brief Da formato a una línea de estadísticas de una sola línea
+     * @param buffer Destino del texto (terminado en '\0')
+     * @param tamano Bytes disponibles en buffer
+     * @return Longitud del texto
+     */
+    int formatearLinea(char* buffer, size_t tamano) const;
+
+    /**
+     * @brief Escribe todas las métricas en el formato de texto de Prometheus
+     * @param archivo Destino
+     */
+    void escribirPrometheus(FILE* archivo) const;
+
+    /**
+     * @brief Reemplaza un archivo con las métricas en formato Prometheus
+     * @param ruta Archivo de destino (se escribe uno temporal y se renombra)
+     * @return true si el archivo quedó actualizado
+     *
+     * Sirve para el colector de archivos de texto de node_exporter: el
+     * lector nunca ve un archivo a medio escribir.
+     */
+    bool exportarPrometheus(const char* ruta) const;
+};
+
+/**
+ * @class InformePeriodico
+ * @brief Hilo que exporta las métricas globales cada cierto tiempo
+ */
+class InformePeriodico {
+private:
+    int intervaloMs;                 ///< Tiempo entre informes
+    FILE* lineas;                    ///< Destino de la línea de estadísticas, o nullptr
+    const char* rutaPrometheus;      ///< Archivo Prometheus a reemplazar, o nullptr
+    std::thread hilo;                ///< Hilo del informe
+    std::mutex cerrojo;              ///< Protege detenido
+    std::condition_variable aviso;   ///< Despierta al hilo para detenerse
+    bool detenido;                   ///< true al pedir la detención
+
+    /**
+     * @brief Cuerpo del hilo
+     */
+    void ejecutar();
+
+    InformePeriodico(const InformePeriodico&) = delete;
+    InformePeriodico& operator=(const InformePeriodico&) = delete;
+
+public:
+    /**
+     * @brief Constructor sin iniciar el hilo
+     * @param intervalo Milisegundos entre informes
+     * @param destinoLineas Flujo de la línea de estadísticas, o nullptr para no escribirla
+     * @param prometheus Archivo Prometheus, o nullptr para no exportarlo
+     */
+    InformePeriodico(int intervalo, FILE* destinoLineas, const char* prometheus)
+        : intervaloMs(intervalo), lineas(destinoLineas), rutaPrometheus(prometheus), detenido(false) {}
+
+    /**
+     * @brief Destructor que detiene el hilo si sigue activo
+     */
+    ~InformePeriodico();
+
+    /**
+     * @brief Inicia el hilo
+     */
+    void iniciar();
+
+    /**
+     * @brief Detiene el hilo y escribe un último informe
+     */
+    void detener();
+
+    /**
+     * @brief Escribe un informe en los destinos configurados
+     */
+    void informar();
+};
+
+#endif // PRT7_METRICAS_H
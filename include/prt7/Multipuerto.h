@@ -0,0 +1,178 @@
+/**
+ * @file Multipuerto.h
+ * @brief Decodificación concurrente de varios puertos con un grupo fijo de hilos
+ */
+
+#ifndef PRT7_MULTIPUERTO_H
+#define PRT7_MULTIPUERTO_H
+
+#include <cstddef>
+#include <mutex>
+
+#include "prt7/Decodificador.h"
+#include "prt7/PuertoSerial.h"
+
+/**
+ * @struct MensajeRecolectado
+ * @brief Resultado de la sesión de un puerto
+ */
+struct MensajeRecolectado {
+    const char* puerto;            ///< Nombre del puerto
+    char* texto;                   ///< Copia contigua del mensaje ensamblado
+    size_t longitud;               ///< Caracteres del mensaje
+    long long tramasRecibidas;     ///< Tramas válidas procesadas
+    long long tramasMalformadas;   ///< Líneas descartadas
+    bool abierto;                  ///< false si el puerto no pudo abrirse
+    bool completo;                 ///< true si la transmisión terminó con END
+    bool entregado;                ///< true cuando la sesión ya entregó su resultado
+};
+
+/**
+ * @class ColectorMensajes
+ * @brief Punto único donde las sesiones dejan sus mensajes al terminar
+ *
+ * Cada sesión entrega desde su propio hilo; un mutex protege las entradas y
+ * el contador. Las entradas se indexan por el orden en que se agregaron los
+ * puertos, no por el orden en que terminaron.
+ */
+class ColectorMensajes {
+private:
+    MensajeRecolectado* mensajes;  ///< Una entrada por puerto
+    int capacidad;                 ///< Cantidad de entradas
+    int entregados;                ///< Sesiones que ya terminaron
+    mutable std::mutex cerrojo;    ///< Protege mensajes y entregados
+
+    ColectorMensajes(const ColectorMensajes&) = delete;
+    ColectorMensajes& operator=(const ColectorMensajes&) = delete;
+
+public:
+    /**
+     * @brief Constructor
+     * @param cantidad Cantidad de puertos a recolectar
+     */
+    explicit ColectorMensajes(int cantidad);
+
+    /**
+     * @brief Destructor que libera las copias de los mensajes
+     */
+    ~ColectorMensajes();
+
+    /**
+     * @brief Registra el resultado de una sesión (seguro entre hilos)
+     * @param indice Posición del puerto
+     * @param puerto Nombre del puerto
+     * @param decodificador Sesión terminada, o nullptr si el puerto no abrió
+     */
+    void entregar(int indice, const char* puerto, Decodificador* decodificador);
+
+    /**
+     * @brief Sesiones que ya entregaron su resultado
+     * @return Cantidad de entregas
+     */
+    int getEntregados() const;
+
+    /**
+     * @brief Cantidad de entradas
+     * @return Puertos recolectados
+     */
+    int getCapacidad() const {
+        return capacidad;
+    }
+
+    /**
+     * @brief Resultado de un puerto; leerlo sólo después de ejecutar()
+     * @param indice Posición del puerto
+     * @return Entrada del puerto
+     */
+    const MensajeRecolectado& getMensaje(int indice) const {
+        return mensajes[indice];
+    }
+};
+
+/**
+ * @class DecodificadorMultipuerto
+ * @brief Ejecuta una sesión de decodificación independiente por puerto
+ *
+ * Cada puerto tiene su propio LectorSerial y su propio Decodificador, así que
+ * ningún estado se comparte entre sesiones. Un grupo fijo de hilos reparte
+ * los puertos: cada hilo espera a la vez todos los suyos (poll en POSIX) y
+ * procesa el que tenga datos. Al terminar, cada sesión entrega su mensaje a
+ * un ColectorMensajes.
+ */
+class DecodificadorMultipuerto {
+public:
+    static const int MAXIMO_PUERTOS = 64;  ///< Puertos por ejecución
+
+private:
+    /**
+     * @struct Sesion
+     * @brief Estado de un puerto durante la ejecución
+     */
+    struct Sesion {
+        ConfiguracionSerial config;     ///< Configuración del puerto
+        DescriptorPuerto puerto;        ///< Puerto abierto
+        LectorSerial* lector;           ///< Lector del puerto
+        Decodificador* decodificador;   ///< Sesión de decodificación
+        PlazoInactividad plazo;         ///< Tiempo máximo sin datos del puerto
+        bool activa;                    ///< true mientras el puerto siga transmitiendo
+    };
+
+    Sesion sesiones[MAXIMO_PUERTOS];  ///< Puertos agregados
+    int cantidad;                     ///< Cantidad de puertos agregados
+    int hilos;                        ///< Hilos pedidos (0 = uno por núcleo)
+    int inactividadMs;                ///< Tiempo máximo sin datos de cada puerto (0 = sin límite)
+
+    /**
+     * @brief Cuerpo de un hilo: atiende los puertos primera, primera + paso, ...
+     * @param primera Índice del primer puerto del hilo
+     * @param paso Cantidad de hilos
+     * @param colector Destino de los mensajes
+     * @param timeoutMs Espera máxima de cada vuelta
+     */
+    void atender(int primera, int paso, ColectorMensajes& colector, int timeoutMs);
+
+    /**
+     * @brief Cierra una sesión y entrega su mensaje
+     * @param indice Posición del puerto
+     * @param colector Destino del mensaje
+     * @param finDatos true si el puerto se cerró (procesar la última línea sin fin de línea)
+     */
+    void terminar(int indice, ColectorMensajes& colector, bool finDatos);
+
+    DecodificadorMultipuerto(const DecodificadorMultipuerto&) = delete;
+    DecodificadorMultipuerto& operator=(const DecodificadorMultipuerto&) = delete;
+
+public:
+    /**
+     * @brief Constructor
+     * @param cantidadHilos Tamaño del grupo de hilos (0 = uno por núcleo)
+     * @param inactividad Milisegundos sin datos tras los que se cierra un puerto (0 = sin límite)
+     */
+    explicit DecodificadorMultipuerto(int cantidadHilos = 0, int inactividad = 0)
+        : cantidad(0), hilos(cantidadHilos), inactividadMs(inactividad) {}
+
+    /**
+     * @brief Agrega un puerto a la ejecución
+     * @param config Configuración del puerto
+     * @return false si ya se alcanzó MAXIMO_PUERTOS
+     */
+    bool agregarPuerto(const ConfiguracionSerial& config);
+
+    /**
+     * @brief Cantidad de puertos agregados
+     * @return Puertos
+     */
+    int getCantidad() const {
+        return cantidad;
+    }
+
+    /**
+     * @brief Decodifica todos los puertos hasta que cada uno reciba END, se cierre o quede inactivo
+     * @param colector Destino de los mensajes (al menos getCantidad() entradas)
+     * @param timeoutMs Espera máxima de cada vuelta de un hilo
+     * @return Cantidad de hilos usados
+     */
+    int ejecutar(ColectorMensajes& colector, int timeoutMs);
+};
+
+#endif // PRT7_MULTIPUERTO_H
@@ -0,0 +1,285 @@
+/**
+ * @file PuertoSerial.h
+ * @brief Configuración, apertura y lectura por bloques del puerto serial
+ */
+
+#ifndef PRT7_PUERTO_SERIAL_H
+#define PRT7_PUERTO_SERIAL_H
+
+#include "prt7/AnalizadorBinario.h"
+#include "prt7/AnalizadorTramas.h"
+#include "prt7/Trama.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
+class GrabadorCaptura;
+struct InstantaneaSesion;
+
+// ============================================================================
+// FUNCIONES DE COMUNICACIÓN SERIAL
+// ============================================================================
+
+/**
+ * @struct ConfiguracionSerial
+ * @brief Parámetros del enlace serial, normalmente tomados de la línea de comandos
+ */
+struct ConfiguracionSerial {
+    const char* puerto;   ///< Nombre del puerto (ej: "COM3" o "/dev/ttyUSB0")
+    long baudios;         ///< Velocidad en baudios (9600 a 2000000)
+    int vmin;             ///< VMIN de termios: bytes mínimos por read() (POSIX)
+    int vtime;            ///< VTIME de termios: espera entre bytes en décimas de segundo (POSIX)
+    bool modoCrudo;       ///< true para modo crudo (cfmakeraw): sin eco ni modo canónico
+    bool controlFlujo;    ///< true para control de flujo por hardware RTS/CTS
+    int bufferEntrada;    ///< Tamaño del buffer de recepción del driver (SetupComm, Windows)
+    int bufferSalida;     ///< Tamaño del buffer de transmisión del driver (SetupComm, Windows)
+    FormatoTramas formato;  ///< Codificación de las tramas que envía el emisor
+
+    /**
+     * @brief Constructor con los valores del Arduino de referencia (9600 8N1)
+     */
+    ConfiguracionSerial()
+        : baudios(9600), vmin(0), vtime(0), modoCrudo(true), controlFlujo(false),
+          bufferEntrada(65536), bufferSalida(4096), formato(FORMATO_TEXTO) {
+        #ifdef _WIN32
+            puerto = "COM3";
+        #else
+            puerto = "/dev/ttyUSB0";
+        #endif
+    }
+};
+
+#ifdef _WIN32
+typedef HANDLE DescriptorPuerto;               ///< Puerto o flujo en Windows
+#define PUERTO_INVALIDO INVALID_HANDLE_VALUE   ///< Valor de un puerto que no pudo abrirse
+#else
+typedef int DescriptorPuerto;                  ///< Descriptor de puerto o flujo en POSIX
+#define PUERTO_INVALIDO (-1)                   ///< Valor de un puerto que no pudo abrirse
+#endif
+
+/**
+ * @brief Abre y configura el puerto serial
+ * @param config Configuración del enlace (puerto, baudios, VMIN/VTIME, buffers, etc.)
+ * @return Puerto abierto o PUERTO_INVALIDO si falla
+ */
+DescriptorPuerto abrirPuertoSerial(const ConfiguracionSerial& config);
+
+/**
+ * @brief Cierra un puerto abierto con abrirPuertoSerial()
+ * @param puerto Puerto a cerrar
+ */
+void cerrarPuertoSerial(DescriptorPuerto puerto);
+
+/**
+ * @class PlazoInactividad
+ * @brief Tiempo máximo sin datos de una sesión, medido con un reloj monotónico
+ *
+ * Sirve para terminar una sesión cuyo emisor dejó de transmitir sin enviar
+ * END ni cerrar el puerto. acotarEspera() recorta la espera de cada lectura
+ * al tiempo que falta, así que el plazo vence dentro de la propia espera y
+ * no depende de cuántas tramas hayan llegado.
+ */
+class PlazoInactividad {
+private:
+    long long limiteNs;         ///< Tiempo máximo sin datos (0 = sin límite)
+    long long ultimaActividad;  ///< relojMonotonicoNs() de los últimos datos recibidos
+
+public:
+    /**
+     * @brief Constructor que empieza a contar desde ahora
+     * @param milisegundos Tiempo máximo sin datos (0 o negativo = sin límite)
+     */
+    explicit PlazoInactividad(int milisegundos = 0);
+
+    /**
+     * @brief Reinicia la cuenta al recibir datos
+     */
+    void registrarActividad();
+
+    /**
+     * @brief Indica si pasó el tiempo máximo sin datos
+     * @return false si no hay límite
+     */
+    bool vencido() const;
+
+    /**
+     * @brief Espera a usar en la próxima lectura
+     * @param esperaMs Espera deseada (-1 = indefinida)
+     * @return La menor entre esperaMs y lo que falta para vencer el plazo
+     */
+    int acotarEspera(int esperaMs) const;
+};
+
+// ============================================================================
+// LECTOR SERIAL POR BLOQUES
+// ============================================================================
+
+/**
+ * @class LectorSerial
+ * @brief Lector del puerto serial que trabaja por bloques
+ *
+ * En lugar de leer byte por byte, cada llamada a rellenar() espera a que el
+ * puerto tenga datos (poll en POSIX, ReadFile con tiempos límite en Windows)
+ * y trae de una vez todo lo disponible a un buffer interno. Después,
+ * extraerLinea() separa todas las líneas completas contenidas en ese bloque.
+ * También sirve para otros descriptores de flujo, como la entrada estándar.
+ */
+class LectorSerial {
+public:
+    typedef DescriptorPuerto Descriptor;     ///< Tipo del puerto
+
+    static const int CAPACIDAD = 4096;       ///< Tamaño del buffer interno en bytes
+    static const int LONGITUD_MAXIMA = LONGITUD_MAXIMA_TRAMA;  ///< Longitud máxima de una línea
+
+private:
+    Descriptor puerto;       ///< Puerto del que se lee
+    char datos[CAPACIDAD];   ///< Bytes recibidos pendientes de separar en líneas
+    int inicio;              ///< Primer byte aún no entregado
+    int fin;                 ///< Posición tras el último byte recibido
+    int escaneado;           ///< Posición hasta la que ya se buscó un fin de línea
+    bool truncando;          ///< true si se descartan bytes de una línea demasiado larga
+    long long instanteLectura;  ///< relojMonotonicoNs() de la última lectura con datos (0 = ninguna)
+    FormatoTramas formato;   ///< Codificación de las tramas del flujo
+    AnalizadorBinario binario;  ///< Estado del análisis en FORMATO_BINARIO
+    GrabadorCaptura* grabador;  ///< Destino de una copia de cada lectura, o nullptr
+#ifdef _WIN32
+    int timeoutConfigurado;  ///< Último tiempo límite aplicado con SetCommTimeouts
+    bool dispositivo;        ///< true para un puerto o consola; false para un archivo o tubería
+#endif
+
+    /**
+     * @brief Mueve los bytes pendientes al inicio del buffer
+     */
+    void compactar();
+
+    /**
+     * @brief Descarta el resto de una línea demasiado larga
+     * @param desde Posición donde empiezan los bytes recién leídos
+     *
+     * Los bytes anteriores al siguiente fin de línea se eliminan; el fin de
+     * línea y lo que le sigue se conservan.
+     */
+    void descartarExceso(int desde);
+
+public:
+    /**
+     * @brief Constructor
+     * @param p Puerto serial ya abierto
+     */
+    LectorSerial(Descriptor p) : puerto(p), inicio(0), fin(0), escaneado(0), truncando(false), instanteLectura(0),
+                                 formato(FORMATO_TEXTO), grabador(nullptr)
+#ifdef _WIN32
+        , timeoutConfigurado(-1), dispositivo(GetFileType(p) == FILE_TYPE_CHAR)
+#endif
+    {}
+
+    /**
+     * @brief Espera datos del puerto y los agrega al buffer en un solo bloque
+     * @param timeoutMs Tiempo máximo de espera en milisegundos
+     * @return Bytes leídos, 0 si se agotó el tiempo, -1 si el puerto falló o se cerró
+     */
+    int rellenar(int timeoutMs);
+
+    /**
+     * @brief Puerto del que lee este lector
+     * @return Descriptor del puerto
+     */
+    Descriptor getPuerto() const {
+        return puerto;
+    }
+
+    /**
+     * @brief Elige la codificación de las tramas del flujo
+     * @param f FORMATO_TEXTO (líneas) o FORMATO_BINARIO
+     *
+     * En FORMATO_BINARIO extraerTramas() usa un AnalizadorBinario y
+     * extraerLinea() y extraerResto() no entregan nada: una trama binaria
+     * que quede incompleta al cerrarse el flujo se descarta.
+     */
+    void setFormato(FormatoTramas f) {
+        formato = f;
+        binario.reiniciar();
+    }
+
+    /**
+     * @brief Graba en una captura cada lectura que haga rellenar() desde ahora
+     * @param g Grabador ya abierto, o nullptr para dejar de grabar
+     *
+     * Los bytes que el buffer ya tenga sin entregar (ej. los que llegaron
+     * mientras se buscaba el puerto con DetectorPuertos) se graban enseguida.
+     * El grabador no pertenece al lector y debe seguir abierto mientras se use.
+     */
+    void setGrabador(GrabadorCaptura* g);
+
+    /**
+     * @brief Momento de la última lectura que trajo datos
+     * @return Instante de relojMonotonicoNs(), o 0 si aún no llegó nada
+     */
+    long long getInstanteLectura() const {
+        return instanteLectura;
+    }
+
+    /**
+     * @brief Extrae la siguiente línea completa del buffer sin copiarla
+     * @param linea Inicio de la línea dentro del buffer interno
+     * @param longitud Bytes de la línea, sin el fin de línea
+     * @return true si había una línea completa
+     *
+     * La línea apunta al buffer del lector y deja de ser válida en la
+     * siguiente llamada a rellenar().
+     */
+    bool extraerLinea(const char*& linea, int& longitud);
+
+    /**
+     * @brief Entrega los bytes pendientes que no terminaron en fin de línea
+     * @param linea Inicio de los bytes dentro del buffer interno
+     * @param longitud Cantidad de bytes
+     * @return true si quedaba algo pendiente
+     *
+     * Se usa al llegar al fin de los datos, cuando la última trama puede no
+     * tener fin de línea.
+     */
+    bool extraerResto(const char*& linea, int& longitud);
+
+    /**
+     * @brief Analiza un lote de tramas completas del buffer (líneas o binarias)
+     * @param tramas Arreglo donde dejar las tramas válidas
+     * @param maximo Capacidad del arreglo
+     * @param malformadas Contador al que se suman las líneas descartadas
+     * @return Cantidad de tramas escritas en el arreglo (0 si no quedan líneas)
+     *
+     * Se detiene justo después de END, así que las líneas que le siguen
+     * no se cuentan como mal formadas.
+     */
+    int extraerTramas(Trama* tramas, int maximo, int& malformadas);
+
+    /**
+     * @brief Indica si el buffer ya contiene una trama válida, sin consumir nada
+     * @return true si hay al menos una línea completa (o trama binaria) válida
+     *
+     * Sirve para reconocer un emisor PRT-7 antes de decidir decodificarlo.
+     */
+    bool contieneTramaValida() const;
+
+    /**
+     * @brief Copia la línea o trama a medias que quedó en el buffer
+     * @param destino Instantánea cuyo analizador se completa
+     *
+     * Se llama después de extraer todas las tramas completas; de una línea
+     * más larga que InstantaneaSesion::LONGITUD_LINEA sólo se conserva el
+     * principio y se marca como truncada.
+     */
+    void capturarAnalizador(InstantaneaSesion& destino) const;
+
+    /**
+     * @brief Continúa la línea o trama a medias de una instantánea
+     * @param origen Instantánea guardada
+     * @return false si el estado del analizador binario no es válido
+     *
+     * La línea restaurada queda delante de los bytes que el buffer ya tenga.
+     */
+    bool restaurarAnalizador(const InstantaneaSesion& origen);
+};
+
+#endif // PRT7_PUERTO_SERIAL_H
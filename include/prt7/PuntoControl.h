@@ -0,0 +1,206 @@
+/**
+ * @file PuntoControl.h
+ * @brief Instantáneas del estado de una sesión para reanudarla tras un corte
+ */
+
+#ifndef PRT7_PUNTO_CONTROL_H
+#define PRT7_PUNTO_CONTROL_H
+
+#include <cstddef>
+#include <cstdio>
+
+#include "prt7/AnalizadorBinario.h"
+#include "prt7/Decodificador.h"
+#include "prt7/Metricas.h"
+#include "prt7/PuertoSerial.h"
+#include "prt7/RotorCompuesto.h"
+
+/**
+ * @struct InstantaneaSesion
+ * @brief Todo lo que una sesión necesita para continuar, salvo el mensaje
+ *
+ * El analizador guarda la línea a medias (texto) o la trama binaria a
+ * medias, tomada del Decodificador o del LectorSerial que la tenga.
+ */
+struct InstantaneaSesion {
+    static const int LONGITUD_LINEA = Decodificador::LONGITUD_MAXIMA_LINEA;  ///< Bytes de línea que se conservan
+
+    long long tramasRecibidas;    ///< Tramas válidas procesadas
+    long long tramasMalformadas;  ///< Líneas descartadas
+    long long tramasCarga;        ///< Tramas LOAD procesadas
+    long long movimientosRotor;   ///< Movimientos de rotor aplicados
+    bool finTransmision;          ///< true si ya se recibió END
+    FormatoTramas formato;        ///< Codificación de las tramas
+
+    int cantidadRotores;          ///< Rotores de la cadena (0 = rotor único)
+    bool avance;                  ///< true si la cadena avanza con cada carácter
+    int desplazamientos[RotorCompuesto::MAXIMO_ROTORES];  ///< Posición de cada rotor (o del rotor único)
+
+    char linea[LONGITUD_LINEA];   ///< Línea incompleta
+    int longitudLinea;            ///< Bytes ocupados en linea
+    bool lineaTruncada;           ///< true si la línea ya era demasiado larga
+    AnalizadorBinario::EstadoGuardado binario;  ///< Trama binaria incompleta
+};
+
+/**
+ * @enum ResultadoPuntoControl
+ * @brief Resultado de PuntoControl::cargar()
+ */
+enum ResultadoPuntoControl {
+    PUNTO_CONTROL_AUSENTE,     ///< No había punto de control: la sesión empieza de cero
+    PUNTO_CONTROL_RESTAURADO,  ///< La sesión continúa donde quedó
+    PUNTO_CONTROL_INVALIDO     ///< El punto de control está dañado o no corresponde a la sesión
+};
+
+/**
+ * @class PuntoControl
+ * @brief Guarda periódicamente una sesión en disco y la restaura al iniciar
+ *
+ * Usa dos archivos: <ruta> con la instantánea (unos cientos de bytes, se
+ * reemplaza de forma atómica escribiendo un temporal y renombrándolo) y
+ * <ruta>.carga con el mensaje, al que cada guardado sólo agrega los
+ * caracteres nuevos. La instantánea indica cuántos bytes de la carga son
+ * válidos, así que un corte entre ambas escrituras no la corrompe.
+ *
+ * Formato de la instantánea (enteros little-endian):
+ *
+ * | Campo                                   | Bytes              |
+ * |-----------------------------------------|--------------------|
+ * | "PRT7PC", versión, formato              | 6 + 1 + 1          |
+ * | recibidas, malformadas, cargas, movim.  | 4 x 8              |
+ * | fin, cantidad de rotores, avance        | 3 x 1              |
+ * | desplazamiento de cada rotor            | max(1, rotores)    |
+ * | bytes de carga, posición de entrada     | 2 x 8              |
+ * | línea: longitud, truncada, bytes        | 2 + 1 + longitud   |
+ * | analizador binario                      | 1 + 8 + 1 + 1 + 8  |
+ * | FNV-1a de todo lo anterior              | 4                  |
+ *
+ * Con un sumidero y una ventana, los caracteres que la ventana descartó
+ * entre dos guardados ya se entregaron al sumidero y no pasan a la carga.
+ */
+class PuntoControl {
+public:
+    static const unsigned char VERSION = 1;  ///< Versión del formato de la instantánea
+
+private:
+    char* rutaEstado;             ///< Archivo de la instantánea
+    char* rutaTemporal;           ///< Temporal que se renombra sobre rutaEstado
+    char* rutaCarga;              ///< Archivo del mensaje
+    FILE* archivoCarga;           ///< Archivo del mensaje abierto para agregar, o nullptr
+    long long bytesCarga;         ///< Bytes válidos en el archivo del mensaje
+    long long persistidos;        ///< Caracteres de la lista (contando los descartados) ya considerados
+    long long posicionEntrada;    ///< Bytes de la captura ya alimentados al restaurar
+    long long intervaloNs;        ///< Tiempo entre guardados
+    long long ultimoGuardado;     ///< relojMonotonicoNs() del último guardado
+    long long fallos;             ///< Guardados que no pudieron completarse
+    InstantaneaSesion restaurada; ///< Estado leído por cargar()
+    bool hayRestaurada;           ///< true si restaurada tiene un analizador por aplicar
+
+    /**
+     * @brief Abre el archivo del mensaje conservando sus primeros bytes
+     * @param conservar Bytes válidos a conservar (0 = vaciarlo)
+     * @return true si pudo abrirse
+     */
+    bool abrirCarga(long long conservar);
+
+    /**
+     * @brief Agrega al archivo del mensaje los caracteres aún no guardados
+     * @param carga Lista de la sesión
+     * @return true si se escribieron y sincronizaron todos
+     *
+     * Si una escritura falla, el archivo se trunca a los bytes válidos
+     * anteriores, para que el próximo guardado continúe desde ahí sin
+     * duplicar ni dejar restos.
+     */
+    bool agregarCarga(const ListaDeCarga& carga);
+
+    PuntoControl(const PuntoControl&) = delete;
+    PuntoControl& operator=(const PuntoControl&) = delete;
+
+public:
+    /**
+     * @brief Constructor
+     * @param ruta Archivo de la instantánea (el mensaje va en ruta + ".carga")
+     * @param intervaloMs Milisegundos entre guardados de guardarSiVence()
+     */
+    PuntoControl(const char* ruta, int intervaloMs);
+
+    /**
+     * @brief Destructor que cierra el archivo del mensaje
+     */
+    ~PuntoControl();
+
+    /**
+     * @brief Restaura la sesión guardada, si existe
+     * @param decodificador Sesión recién creada, ya configurada y sin alimentar
+     * @return Resultado de la restauración
+     *
+     * Restaura contadores, rotores y mensaje; el analizador se aplica
+     * después con prepararEntrada(), cuando se sabe quién analiza los bytes.
+     * Debe llamarse antes de ListaDeCarga::configurarSalida() para que el
+     * mensaje restaurado no vuelva al sumidero. Sin punto de control deja
+     * los archivos listos para empezar de cero.
+     */
+    ResultadoPuntoControl cargar(Decodificador& decodificador);
+
+    /**
+     * @brief Entrega la línea o trama a medias restaurada a quien analizará la entrada
+     * @param decodificador Sesión restaurada
+     * @param lector Lector del flujo, o nullptr si los bytes van a Decodificador::alimentar()
+     */
+    void prepararEntrada(Decodificador& decodificador, LectorSerial* lector);
+
+    /**
+     * @brief Guarda la sesión ahora
+     * @param decodificador Sesión a guardar
+     * @param lector Lector con la línea a medias, o nullptr si la tiene el decodificador
+     * @param posicion Bytes de la captura ya alimentados (0 en un flujo)
+     * @return false si no pudo guardarse (el punto de control anterior sigue válido)
+     */
+    bool guardar(Decodificador& decodificador, const LectorSerial* lector, long long posicion);
+
+    /**
+     * @brief Guarda la sesión si pasó el intervalo desde el último guardado
+     * @param decodificador Sesión a guardar
+     * @param lector Lector con la línea a medias, o nullptr
+     * @param posicion Bytes de la captura ya alimentados (0 en un flujo)
+     */
+    void guardarSiVence(Decodificador& decodificador, const LectorSerial* lector, long long posicion) {
+        if (relojMonotonicoNs() - ultimoGuardado >= intervaloNs) {
+            guardar(decodificador, lector, posicion);
+        }
+    }
+
+    /**
+     * @brief Bytes de la captura que ya procesó la sesión restaurada
+     * @return Posición desde la que continuar una reproducción (0 sin restaurar)
+     */
+    long long getPosicionEntrada() const {
+        return posicionEntrada;
+    }
+
+    /**
+     * @brief Guardados fallidos (disco lleno, permisos, ...)
+     * @return Cantidad de fallos
+     */
+    long long getFallos() const {
+        return fallos;
+    }
+};
+
+/**
+ * @brief Reproduce una captura en memoria guardando el punto de control entre bloques
+ * @param datos Captura completa (por ejemplo, un ArchivoMapeado)
+ * @param tamano Bytes de la captura
+ * @param decodificador Sesión que recibe las tramas (restaurada o nueva)
+ * @param puntoControl Punto de control de la sesión, ya cargado
+ *
+ * Una sesión restaurada continúa desde el byte de la captura en que se
+ * guardó. El último guardado va antes de Decodificador::finalizar(): la
+ * línea o trama a medias del final queda en la instantánea, así que si la
+ * captura crece (por ejemplo, con --record) la sesión retomada la completa.
+ */
+void reproducirConPuntoControl(const char* datos, size_t tamano, Decodificador& decodificador,
+                               PuntoControl& puntoControl);
+
+#endif // PRT7_PUNTO_CONTROL_H
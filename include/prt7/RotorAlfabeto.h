@@ -0,0 +1,177 @@
+/**
+ * @file RotorAlfabeto.h
+ * @brief Rotor de César con tablas de mapeo generadas en tiempo de compilación
+ */
+
+#ifndef PRT7_ROTOR_ALFABETO_H
+#define PRT7_ROTOR_ALFABETO_H
+
+/**
+ * @struct AlfabetoLatino
+ * @brief Alfabeto A-Z del protocolo PRT-7 (las minúsculas cuentan como mayúsculas)
+ */
+struct AlfabetoLatino {
+    static constexpr int TAMANO = 26;  ///< Cantidad de símbolos
+
+    /**
+     * @brief Símbolo en una posición
+     * @param i Posición (0 a TAMANO - 1)
+     * @return Símbolo de salida
+     */
+    static constexpr char simbolo(int i) {
+        return static_cast<char>('A' + i);
+    }
+
+    /**
+     * @brief Posición de un byte dentro del alfabeto
+     * @param c Byte de entrada
+     * @return Posición, o -1 si no pertenece al alfabeto
+     */
+    static constexpr int indice(int c) {
+        return (c >= 'A' && c <= 'Z') ? c - 'A' : (c >= 'a' && c <= 'z') ? c - 'a' : -1;
+    }
+};
+
+/**
+ * @struct AlfabetoAlfanumerico
+ * @brief Alfabeto A-Z0-9 de 36 símbolos
+ */
+struct AlfabetoAlfanumerico {
+    static constexpr int TAMANO = 36;  ///< Cantidad de símbolos
+
+    /**
+     * @brief Símbolo en una posición
+     * @param i Posición (0 a TAMANO - 1)
+     * @return Símbolo de salida
+     */
+    static constexpr char simbolo(int i) {
+        return static_cast<char>(i < 26 ? 'A' + i : '0' + (i - 26));
+    }
+
+    /**
+     * @brief Posición de un byte dentro del alfabeto
+     * @param c Byte de entrada
+     * @return Posición, o -1 si no pertenece al alfabeto
+     */
+    static constexpr int indice(int c) {
+        return (c >= '0' && c <= '9') ? 26 + (c - '0') : AlfabetoLatino::indice(c);
+    }
+};
+
+/**
+ * @struct TablasRotor
+ * @brief Una tabla de 256 entradas por cada desplazamiento posible
+ * @tparam Alfabeto Alfabeto del rotor
+ */
+template <typename Alfabeto>
+struct TablasRotor {
+    char mapeo[Alfabeto::TAMANO][256];  ///< mapeo[d][c]: byte c con el rotor en d
+};
+
+/**
+ * @brief Genera todas las tablas de un alfabeto (se evalúa al compilar)
+ * @tparam Alfabeto Alfabeto del rotor
+ * @return Tablas para los desplazamientos 0 a TAMANO - 1
+ *
+ * Los bytes que no pertenecen al alfabeto se mapean a sí mismos.
+ */
+template <typename Alfabeto>
+constexpr TablasRotor<Alfabeto> generarTablasRotor() {
+    TablasRotor<Alfabeto> t{};
+    for (int d = 0; d < Alfabeto::TAMANO; d++) {
+        for (int c = 0; c < 256; c++) {
+            int i = Alfabeto::indice(c);
+            t.mapeo[d][c] = i < 0 ? static_cast<char>(c) : Alfabeto::simbolo((i + d) % Alfabeto::TAMANO);
+        }
+    }
+    return t;
+}
+
+/**
+ * @class RotorAlfabeto
+ * @brief Rotor de César sin construcción en tiempo de ejecución
+ * @tparam Alfabeto Alfabeto del rotor (AlfabetoLatino, AlfabetoAlfanumerico, ...)
+ *
+ * Todas las tablas existen desde la compilación; rotar sólo cambia el
+ * puntero a la tabla del nuevo desplazamiento y getMapeo() es una lectura.
+ */
+template <typename Alfabeto>
+class RotorAlfabeto {
+public:
+    static constexpr int TAMANO = Alfabeto::TAMANO;  ///< Posiciones del rotor
+
+    /**
+     * @brief Tabla precalculada de un desplazamiento
+     * @param desplazamiento Desplazamiento (0 a TAMANO - 1)
+     * @return Tabla de 256 entradas
+     */
+    static const char* tabla(int desplazamiento) {
+        return TABLAS.mapeo[desplazamiento];
+    }
+
+    /**
+     * @brief Tabla inversa de un desplazamiento
+     * @param desplazamiento Desplazamiento (0 a TAMANO - 1)
+     * @return Tabla de 256 entradas: el byte que tabla(desplazamiento) lleva a cada carácter
+     *
+     * Deshacer un giro de d es girar TAMANO - d, así que la inversa ya es una
+     * de las tablas generadas. Un símbolo que el rotor no puede producir
+     * (ej. una minúscula) tiene como inversa la de su símbolo del alfabeto.
+     */
+    static const char* tablaInversa(int desplazamiento) {
+        return TABLAS.mapeo[(TAMANO - desplazamiento) % TAMANO];
+    }
+
+private:
+    static constexpr TablasRotor<Alfabeto> TABLAS = generarTablasRotor<Alfabeto>();  ///< Todas las tablas
+
+    const char* actual;   ///< Tabla del desplazamiento actual
+    int desplazamiento;   ///< Desplazamiento actual (0 a TAMANO - 1)
+
+public:
+    /**
+     * @brief Constructor con el rotor en la posición cero
+     */
+    RotorAlfabeto() : actual(tabla(0)), desplazamiento(0) {}
+
+    /**
+     * @brief Rota el rotor N posiciones
+     * @param n Posiciones a rotar (positivo=adelante, negativo=atrás)
+     */
+    void rotar(int n) {
+        int pasos = n % TAMANO;
+        desplazamiento = (desplazamiento + pasos + TAMANO) % TAMANO;
+        actual = tabla(desplazamiento);
+    }
+
+    /**
+     * @brief Desplazamiento actual
+     * @return Posición respecto al primer símbolo
+     */
+    int getDesplazamiento() const {
+        return desplazamiento;
+    }
+
+    /**
+     * @brief Carácter mapeado según la rotación actual
+     * @param in Carácter de entrada
+     * @return Carácter mapeado
+     */
+    char getMapeo(char in) const {
+        return actual[static_cast<unsigned char>(in)];
+    }
+
+    /**
+     * @brief Carácter que habría que enviar para obtener uno dado
+     * @param out Carácter deseado a la salida del rotor
+     * @return Carácter de entrada cuyo mapeo es @p out
+     */
+    char getInverso(char out) const {
+        return tablaInversa(desplazamiento)[static_cast<unsigned char>(out)];
+    }
+};
+
+template <typename Alfabeto>
+constexpr TablasRotor<Alfabeto> RotorAlfabeto<Alfabeto>::TABLAS;
+
+#endif // PRT7_ROTOR_ALFABETO_H
@@ -0,0 +1,115 @@
+/**
+ * @file RotorCompuesto.h
+ * @brief Cadena de rotores con avance y tabla compuesta en caché
+ */
+
+#ifndef PRT7_ROTOR_COMPUESTO_H
+#define PRT7_ROTOR_COMPUESTO_H
+
+#include "prt7/RotorDeMapeo.h"
+
+/**
+ * @class RotorCompuesto
+ * @brief Varios RotorDeMapeo encadenados, al estilo de una máquina Enigma
+ *
+ * Cada carácter pasa en orden por todos los rotores. Como cada rotor es un
+ * desplazamiento de César, la cadena completa equivale a un solo rotor
+ * girado la suma de los desplazamientos. Ese rotor compuesto se mantiene
+ * al día con cada movimiento: se gira lo mismo que la suma, sin recorrer
+ * la cadena, así que mapear, rotar y avanzar cuestan lo mismo sin importar
+ * cuántos rotores haya.
+ *
+ * Con avance activado, cada carácter decodificado mueve el primer rotor una
+ * posición y, como en un odómetro, cada vuelta completa de un rotor mueve
+ * el siguiente.
+ */
+class RotorCompuesto {
+public:
+    static const int MAXIMO_ROTORES = 8;  ///< Rotores por cadena
+
+private:
+    RotorDeMapeo rotores[MAXIMO_ROTORES];  ///< Rotores de la cadena
+    int cantidad;                          ///< Rotores en uso
+    bool avance;                           ///< true si cada carácter mueve el primer rotor
+    RotorDeMapeo compuesto;                ///< Rotor girado la suma de los desplazamientos (módulo el anillo)
+
+    RotorCompuesto(const RotorCompuesto&) = delete;
+    RotorCompuesto& operator=(const RotorCompuesto&) = delete;
+
+public:
+    /**
+     * @brief Constructor con todos los rotores en la posición cero
+     * @param rotoresEnUso Cantidad de rotores (1 a MAXIMO_ROTORES)
+     * @param conAvance true para mover la cadena en cada carácter
+     */
+    RotorCompuesto(int rotoresEnUso, bool conAvance);
+
+    /**
+     * @brief Rota un rotor de la cadena
+     * @param indice Rotor a mover (0 es el primero)
+     * @param n Posiciones a rotar (positivo=adelante, negativo=atrás)
+     * @return false si el índice no corresponde a un rotor de la cadena
+     */
+    bool rotar(int indice, int n);
+
+    /**
+     * @brief Avanza la cadena una posición (primer rotor y acarreos)
+     *
+     * Un rotor que da la vuelta suma 1 - TAMANO_ANILLO, o sea 1 módulo el
+     * anillo: el compuesto avanza una posición por cada rotor que se movió.
+     */
+    void avanzar();
+
+    /**
+     * @brief Rotor equivalente a la cadena en su estado actual
+     * @return Rotor compuesto
+     */
+    RotorDeMapeo& getCompuesto() {
+        return compuesto;
+    }
+
+    /**
+     * @brief Carácter mapeado por toda la cadena
+     * @param in Carácter de entrada
+     * @return Carácter mapeado
+     */
+    char getMapeo(char in) {
+        return getCompuesto().getMapeo(in);
+    }
+
+    /**
+     * @brief Carácter que hay que enviar para que la cadena produzca uno dado
+     * @param out Carácter deseado a la salida de la cadena
+     * @return Carácter de entrada
+     */
+    char getInverso(char out) {
+        return getCompuesto().getInverso(out);
+    }
+
+    /**
+     * @brief Cantidad de rotores en uso
+     * @return Rotores de la cadena
+     */
+    int getCantidad() const {
+        return cantidad;
+    }
+
+    /**
+     * @brief Indica si la cadena avanza con cada carácter
+     * @return true con avance activado
+     */
+    bool tieneAvance() const {
+        return avance;
+    }
+
+    /**
+     * @brief Rotor individual de la cadena
+     * @param indice Rotor (0 a getCantidad() - 1)
+     * @return Rotor en su posición actual
+     */
+    const RotorDeMapeo& getRotor(int indice) const {
+        return rotores[indice];
+    }
+};
+
+#endif // PRT7_ROTOR_COMPUESTO_H
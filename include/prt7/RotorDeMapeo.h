@@ -0,0 +1,140 @@
+/**
+ * @file RotorDeMapeo.h
+ * @brief Rotor de mapeo del protocolo PRT-7 (lista circular doblemente enlazada)
+ */
+
+#ifndef PRT7_ROTOR_DE_MAPEO_H
+#define PRT7_ROTOR_DE_MAPEO_H
+
+#include <cstddef>
+
+#include "prt7/MapeoVectorial.h"
+#include "prt7/RotorAlfabeto.h"
+
+/**
+ * @struct NodoRotor
+ * @brief Nodo para la lista circular del rotor de mapeo
+ */
+struct NodoRotor {
+    char dato;              ///< Carácter almacenado (A-Z)
+    NodoRotor* siguiente;   ///< Puntero al siguiente nodo
+    NodoRotor* previo;      ///< Puntero al nodo previo
+
+    /**
+     * @brief Constructor del nodo
+     * @param c Carácter a almacenar
+     */
+    NodoRotor(char c = 'A') : dato(c), siguiente(nullptr), previo(nullptr) {}
+};
+
+/**
+ * @class RotorDeMapeo
+ * @brief Lista circular doblemente enlazada que actúa como disco de cifrado
+ *
+ * Implementa una rueda de César que puede rotar para cambiar el mapeo
+ * de caracteres dinámicamente.
+ *
+ * La lista circular sigue siendo la representación canónica del rotor, pero
+ * la rotación se reduce módulo el tamaño del anillo y el desplazamiento actual
+ * se guarda como entero. El mapeo se resuelve con las tablas de
+ * RotorAlfabeto<AlfabetoLatino>, generadas al compilar: rotar sólo elige la
+ * tabla del nuevo desplazamiento y decodificar una trama LOAD es una sola
+ * lectura. Los nodos del anillo viven dentro del propio rotor, así que
+ * construirlo no reserva memoria.
+ */
+class RotorDeMapeo {
+public:
+    static const int TAMANO_ANILLO = AlfabetoLatino::TAMANO;  ///< Cantidad de nodos del anillo (A-Z)
+
+private:
+    NodoRotor anillo[TAMANO_ANILLO];  ///< Nodos del anillo, enlazados en el constructor
+    NodoRotor* cabeza;                ///< Puntero a la posición 'cero' actual del rotor
+    int desplazamiento;               ///< Posición de la cabeza respecto a 'A' (0-25)
+    const char* tabla;                ///< Tabla precalculada del desplazamiento actual
+    const char* inversa;              ///< Tabla inversa del desplazamiento actual
+
+    RotorDeMapeo(const RotorDeMapeo&) = delete;
+    RotorDeMapeo& operator=(const RotorDeMapeo&) = delete;
+
+public:
+    /**
+     * @brief Constructor que inicializa el rotor con el alfabeto A-Z
+     */
+    RotorDeMapeo();
+
+    /**
+     * @brief Destructor (los nodos son parte del rotor)
+     */
+    ~RotorDeMapeo() {}
+
+    /**
+     * @brief Rota el rotor N posiciones
+     * @param n Número de posiciones a rotar (positivo=adelante, negativo=atrás)
+     *
+     * La rotación se reduce módulo 26 y se recorre por el camino más corto,
+     * así que el costo es acotado sin importar la magnitud de N.
+     */
+    void rotar(int n);
+
+    /**
+     * @brief Obtiene el desplazamiento actual del rotor
+     * @return Posición de la cabeza respecto a 'A' (0-25)
+     */
+    int getDesplazamiento() const {
+        return desplazamiento;
+    }
+
+    /**
+     * @brief Obtiene el carácter mapeado según la rotación actual
+     * @param in Carácter de entrada
+     * @return Carácter mapeado según la posición del rotor
+     *
+     * La posición de @p in respecto a 'A' se aplica a partir de la cabeza,
+     * por lo que con el rotor en +2 la 'A' se mapea a 'C'.
+     */
+    char getMapeo(char in) const {
+        return tabla[static_cast<unsigned char>(in)];
+    }
+
+    /**
+     * @brief Mapea un bloque de caracteres con la rotación actual
+     * @param entrada Caracteres a mapear
+     * @param salida Destino (puede ser el mismo buffer que entrada)
+     * @param cantidad Cantidad de caracteres
+     *
+     * Equivale a getMapeo() sobre cada carácter, usando el núcleo vectorial
+     * de mapearBloqueCesar().
+     */
+    void mapearBloque(const char* entrada, char* salida, size_t cantidad) const {
+        mapearBloqueCesar(entrada, salida, cantidad, desplazamiento);
+    }
+
+    /**
+     * @brief Obtiene el carácter que se mapea a uno dado con la rotación actual
+     * @param out Carácter deseado a la salida del rotor
+     * @return Carácter a enviar en una trama LOAD para obtener @p out
+     *
+     * Es la lectura de la tabla inversa que se elige junto con la directa al
+     * rotar, así que codificar cuesta lo mismo que decodificar. Una minúscula
+     * no es alcanzable (el rotor sólo produce mayúsculas): se invierte como
+     * su mayúscula.
+     */
+    char getInverso(char out) const {
+        return inversa[static_cast<unsigned char>(out)];
+    }
+
+    /**
+     * @brief Invierte un bloque de caracteres con la rotación actual
+     * @param entrada Caracteres deseados a la salida del rotor
+     * @param salida Destino (puede ser el mismo buffer que entrada)
+     * @param cantidad Cantidad de caracteres
+     *
+     * Equivale a getInverso() sobre cada carácter: es el mismo núcleo
+     * vectorial de mapearBloque() con el giro opuesto.
+     */
+    void invertirBloque(const char* entrada, char* salida, size_t cantidad) const {
+        mapearBloqueCesar(entrada, salida, cantidad, (TAMANO_ANILLO - desplazamiento) % TAMANO_ANILLO);
+    }
+};
+
+#endif // PRT7_ROTOR_DE_MAPEO_H
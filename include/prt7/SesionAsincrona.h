@@ -0,0 +1,302 @@
+/**
+ * @file SesionAsincrona.h
+ * @brief Sesión de decodificación movida por el bucle de eventos de la aplicación
+ */
+
+#ifndef PRT7_SESION_ASINCRONA_H
+#define PRT7_SESION_ASINCRONA_H
+
+#include <cstddef>
+
+#include "prt7/Decodificador.h"
+#include "prt7/ListaDeCarga.h"
+#include "prt7/PuertoSerial.h"
+#include "prt7/Trama.h"
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && defined(__has_include)
+    #if __has_include(<coroutine>)
+        #include <coroutine>
+        #define PRT7_CORRUTINAS 1  ///< Hay co_await: se definen EsperaTrama y EsperaMensaje
+    #endif
+#endif
+
+/**
+ * @struct Continuacion
+ * @brief Función a la que se llama (una sola vez) cuando una espera se cumple
+ */
+struct Continuacion {
+    void (*funcion)(void* contexto);  ///< Función a llamar, o nullptr
+    void* contexto;                   ///< Argumento de la función
+};
+
+/**
+ * @class ObservadorSesion
+ * @brief Interfaz de retrollamadas de una SesionAsincrona
+ *
+ * Ambos métodos se llaman desde alimentar(), atenderLectura() o cerrar(),
+ * es decir, en el hilo del bucle de eventos.
+ */
+class ObservadorSesion : public ObservadorTramas {
+public:
+    /**
+     * @brief Recibe un lote de tramas justo antes de que la sesión lo aplique
+     * @param tramas Tramas en orden, hasta END inclusive
+     * @param cantidad Cantidad de tramas (al menos 1)
+     */
+    void tramasRecibidas(const Trama* tramas, int cantidad) override {
+        (void)tramas;
+        (void)cantidad;
+    }
+
+    /**
+     * @brief Avisa que la transmisión terminó (END, fin de datos o cerrar())
+     * @param decodificador Sesión terminada, con el mensaje completo en su lista de carga
+     */
+    virtual void sesionTerminada(Decodificador& decodificador) {
+        (void)decodificador;
+    }
+};
+
+/**
+ * @class SesionAsincrona
+ * @brief Decodificador que no bloquea: la aplicación le avisa cuándo hay datos
+ *
+ * decodificarFlujo() ocupa un hilo por puerto esperando en rellenar(). Esta
+ * sesión, en cambio, nunca espera: el bucle de eventos de la aplicación
+ * (poll, epoll, kqueue, libuv, asio...) vigila getPuerto() y llama a
+ * atenderLectura() cuando el puerto tiene datos, o entrega con alimentar()
+ * los bytes que haya leído por su cuenta. Así miles de sesiones comparten
+ * unos pocos hilos.
+ *
+ * Los resultados se reciben de tres maneras, combinables:
+ * - retrollamadas de un ObservadorSesion por lote de tramas y al terminar;
+ * - esperas con continuación: extraerTrama() consume la cola de tramas y
+ *   esperarTrama() / esperarMensaje() registran a quién llamar cuando haya
+ *   más o cuando se complete el mensaje;
+ * - con C++20, `co_await EsperaTrama(sesion, trama)` y
+ *   `co_await EsperaMensaje(sesion)`, construidas sobre las anteriores.
+ *
+ * Las continuaciones se llaman al final de alimentar(), atenderLectura() o
+ * cerrar(), cuando el lote ya se aplicó, y no deben volver a alimentar la
+ * sesión ni destruirla. Una sesión tiene a lo sumo una espera de cada tipo.
+ * No es segura entre hilos: cada sesión pertenece a un único bucle.
+ */
+class SesionAsincrona : private ObservadorTramas {
+public:
+    static const int CAPACIDAD_INICIAL_COLA = 256;  ///< Tramas de la cola antes de crecer
+
+private:
+    Decodificador& decodificador;  ///< Sesión que aplica las tramas
+    LectorSerial* lector;          ///< Lector del puerto, o nullptr si los bytes llegan por alimentar()
+    ObservadorSesion* observador;  ///< Retrollamadas de la aplicación, o nullptr
+    bool conCola;                  ///< true si las tramas se guardan para extraerTrama()
+    bool terminada;                ///< true después de END, fin de datos o cerrar()
+
+    Trama* cola;                   ///< Cola circular de tramas aún no extraídas
+    int capacidadCola;             ///< Tramas que caben en cola
+    int primeraCola;               ///< Posición de la trama más antigua
+    int usadosCola;                ///< Tramas en la cola
+
+    Continuacion esperaTrama;      ///< Quien espera una trama, o funcion == nullptr
+    Continuacion esperaMensaje;    ///< Quien espera el mensaje, o funcion == nullptr
+
+    void tramasRecibidas(const Trama* tramas, int cantidad) override;
+
+    /**
+     * @brief Duplica la capacidad de la cola conservando el orden
+     */
+    void agrandarCola();
+
+    /**
+     * @brief Cierra la sesión: vacía la salida, avisa al observador y despierta las esperas
+     */
+    void terminar();
+
+    /**
+     * @brief Llama a las continuaciones cuyas esperas ya se cumplieron
+     */
+    void despertar();
+
+    SesionAsincrona(const SesionAsincrona&) = delete;
+    SesionAsincrona& operator=(const SesionAsincrona&) = delete;
+
+public:
+    /**
+     * @brief Constructor
+     * @param d Sesión ya configurada (rotores, formato, salida) y sin alimentar
+     * @param puerto Puerto o descriptor que vigila el bucle, o PUERTO_INVALIDO si se usa alimentar()
+     * @param guardarTramas true para conservar las tramas hasta extraerTrama(); false si sólo interesa el mensaje
+     *
+     * La sesión no abre ni cierra el puerto: ambas cosas quedan a cargo de
+     * la aplicación, que es quien lo registró en su bucle. Para que
+     * atenderLectura() no bloquee, el descriptor debe estar en modo no
+     * bloqueante o leerse sólo cuando el bucle indique que tiene datos.
+     */
+    SesionAsincrona(Decodificador& d, DescriptorPuerto puerto, bool guardarTramas);
+
+    /**
+     * @brief Destructor que libera el lector y la cola
+     */
+    ~SesionAsincrona();
+
+    /**
+     * @brief Elige quién recibe las retrollamadas
+     * @param o Observador, o nullptr para ninguno
+     */
+    void setObservador(ObservadorSesion* o);
+
+    /**
+     * @brief Puerto que debe vigilar el bucle de eventos
+     * @return Descriptor recibido en el constructor
+     */
+    DescriptorPuerto getPuerto() const {
+        return lector ? lector->getPuerto() : PUERTO_INVALIDO;
+    }
+
+    /**
+     * @brief Lee lo que el puerto ya tenga, sin esperar, y lo decodifica
+     * @return false si la sesión terminó (END o el puerto se cerró) y debe quitarse del bucle
+     *
+     * Si la carga está sobre su presupuesto de memoria y no logra derramar,
+     * no lee nada: los bytes quedan en el puerto hasta el próximo aviso.
+     */
+    bool atenderLectura();
+
+    /**
+     * @brief Decodifica bytes que la aplicación leyó por su cuenta
+     * @param datos Bytes recibidos (una línea puede quedar partida entre llamadas)
+     * @param longitud Cantidad de bytes
+     * @return false si la sesión ya terminó
+     */
+    bool alimentar(const char* datos, size_t longitud);
+
+    /**
+     * @brief Termina la sesión porque el flujo se cerró o venció un plazo de la aplicación
+     *
+     * Procesa una última línea sin fin de línea, como Decodificador::finalizar().
+     */
+    void cerrar();
+
+    /**
+     * @brief Indica si la transmisión terminó
+     * @return true después de END, fin de datos o cerrar()
+     */
+    bool haTerminado() const {
+        return terminada;
+    }
+
+    /**
+     * @brief Indica si hay tramas sin extraer
+     * @return true si extraerTrama() entregaría una
+     */
+    bool hayTrama() const {
+        return usadosCola > 0;
+    }
+
+    /**
+     * @brief Saca la trama más antigua de la cola
+     * @param destino Trama extraída
+     * @return false si la cola estaba vacía
+     */
+    bool extraerTrama(Trama& destino);
+
+    /**
+     * @brief Registra a quién llamar cuando haya una trama o termine la sesión
+     * @param c Continuación a llamar una sola vez
+     * @return false si no hace falta esperar (ya hay una trama o la sesión terminó); c no se registra
+     */
+    bool esperarTrama(Continuacion c);
+
+    /**
+     * @brief Registra a quién llamar cuando termine la sesión
+     * @param c Continuación a llamar una sola vez
+     * @return false si la sesión ya terminó; c no se registra
+     */
+    bool esperarMensaje(Continuacion c);
+
+    /**
+     * @brief Decodificador de la sesión
+     * @return Sesión con contadores y mensaje
+     */
+    Decodificador& getDecodificador() {
+        return decodificador;
+    }
+};
+
+#ifdef PRT7_CORRUTINAS
+
+/**
+ * @brief Reanuda la corrutina cuya dirección es contexto
+ * @param contexto Resultado de std::coroutine_handle<>::address()
+ */
+inline void reanudarCorrutina(void* contexto) {
+    std::coroutine_handle<>::from_address(contexto).resume();
+}
+
+/**
+ * @class EsperaTrama
+ * @brief `co_await EsperaTrama(sesion, trama)`: siguiente trama de la sesión
+ *
+ * Devuelve true con la trama en el destino, o false cuando la sesión
+ * terminó y ya no quedan tramas. Requiere una sesión creada con
+ * guardarTramas en true.
+ */
+class EsperaTrama {
+private:
+    SesionAsincrona& sesion;  ///< Sesión esperada
+    Trama& destino;           ///< Donde dejar la trama
+
+public:
+    /**
+     * @brief Constructor
+     * @param s Sesión esperada
+     * @param t Donde dejar la trama
+     */
+    EsperaTrama(SesionAsincrona& s, Trama& t) : sesion(s), destino(t) {}
+
+    bool await_ready() const {
+        return sesion.hayTrama() || sesion.haTerminado();
+    }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        Continuacion c = {reanudarCorrutina, h.address()};
+        return sesion.esperarTrama(c);
+    }
+
+    bool await_resume() {
+        return sesion.extraerTrama(destino);
+    }
+};
+
+/**
+ * @class EsperaMensaje
+ * @brief `co_await EsperaMensaje(sesion)`: lista de carga con el mensaje completo
+ */
+class EsperaMensaje {
+private:
+    SesionAsincrona& sesion;  ///< Sesión esperada
+
+public:
+    /**
+     * @brief Constructor
+     * @param s Sesión esperada
+     */
+    explicit EsperaMensaje(SesionAsincrona& s) : sesion(s) {}
+
+    bool await_ready() const {
+        return sesion.haTerminado();
+    }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        Continuacion c = {reanudarCorrutina, h.address()};
+        return sesion.esperarMensaje(c);
+    }
+
+    ListaDeCarga& await_resume() {
+        return sesion.getDecodificador().getCarga();
+    }
+};
+
+#endif // PRT7_CORRUTINAS
+
+#endif // PRT7_SESION_ASINCRONA_H
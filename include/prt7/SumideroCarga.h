@@ -0,0 +1,124 @@
+/**
+ * @file SumideroCarga.h
+ * @brief Destinos que reciben por bloques el mensaje decodificado
+ */
+
+#ifndef PRT7_SUMIDERO_CARGA_H
+#define PRT7_SUMIDERO_CARGA_H
+
+#include <cstddef>
+#include <cstdio>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+#endif
+
+/**
+ * @class SumideroCarga
+ * @brief Interfaz de un destino para los caracteres decodificados
+ *
+ * ListaDeCarga entrega cada nodo al llenarse y lo pendiente al vaciarse,
+ * de modo que el consumidor recibe el mensaje mientras se ensambla y no
+ * sólo al llegar END.
+ */
+class SumideroCarga {
+public:
+    /**
+     * @brief Destructor virtual
+     */
+    virtual ~SumideroCarga() {}
+
+    /**
+     * @brief Recibe un bloque de caracteres decodificados
+     * @param datos Caracteres en orden
+     * @param cantidad Cantidad de caracteres
+     * @return false si el destino falló (se descartan los datos)
+     */
+    virtual bool escribir(const char* datos, size_t cantidad) = 0;
+
+    /**
+     * @brief Entrega al destino lo que tenga en buffers propios
+     */
+    virtual void vaciar() {}
+};
+
+/**
+ * @class SumideroArchivo
+ * @brief Agrega el mensaje a un archivo
+ */
+class SumideroArchivo : public SumideroCarga {
+private:
+    FILE* archivo;  ///< Archivo abierto, o nullptr
+    bool propio;    ///< true si el archivo debe cerrarse (no es la salida estándar)
+
+    SumideroArchivo(const SumideroArchivo&) = delete;
+    SumideroArchivo& operator=(const SumideroArchivo&) = delete;
+
+public:
+    /**
+     * @brief Constructor sin archivo
+     */
+    SumideroArchivo() : archivo(nullptr), propio(false) {}
+
+    /**
+     * @brief Destructor que vacía y cierra el archivo
+     */
+    ~SumideroArchivo() override;
+
+    /**
+     * @brief Abre el archivo de destino
+     * @param ruta Ruta del archivo, o "-" para la salida estándar
+     * @param agregar true para agregar al final, false para truncar
+     * @return true si el archivo quedó abierto
+     */
+    bool abrir(const char* ruta, bool agregar);
+
+    bool escribir(const char* datos, size_t cantidad) override;
+    void vaciar() override;
+};
+
+/**
+ * @class SumideroSocket
+ * @brief Envía el mensaje por una conexión TCP
+ */
+class SumideroSocket : public SumideroCarga {
+private:
+#ifdef _WIN32
+    SOCKET conexion;  ///< Socket conectado
+#else
+    int conexion;     ///< Socket conectado, o -1
+#endif
+
+    SumideroSocket(const SumideroSocket&) = delete;
+    SumideroSocket& operator=(const SumideroSocket&) = delete;
+
+public:
+    /**
+     * @brief Constructor sin conexión
+     */
+    SumideroSocket();
+
+    /**
+     * @brief Destructor que cierra la conexión
+     */
+    ~SumideroSocket() override;
+
+    /**
+     * @brief Se conecta al receptor
+     * @param host Nombre o dirección del receptor
+     * @param puerto Puerto TCP, como texto
+     * @return true si la conexión quedó establecida
+     */
+    bool conectar(const char* host, const char* puerto);
+
+    bool escribir(const char* datos, size_t cantidad) override;
+};
+
+/**
+ * @brief Crea un sumidero a partir de su descripción en la línea de comandos
+ * @param especificacion "stdout", "file:<ruta>" o "tcp:<host>:<puerto>"
+ * @return Sumidero listo (liberar con delete), o nullptr si no pudo abrirse
+ */
+SumideroCarga* crearSumidero(const char* especificacion);
+
+#endif // PRT7_SUMIDERO_CARGA_H
@@ -0,0 +1,245 @@
+/**
+ * @file Trama.h
+ * @brief Tramas del protocolo PRT-7: jerarquía polimórfica y representación por valor
+ */
+
+#ifndef PRT7_TRAMA_H
+#define PRT7_TRAMA_H
+
+#include "prt7/EscritorSalida.h"
+#include "prt7/ListaDeCarga.h"
+#include "prt7/RotorDeMapeo.h"
+
+// ============================================================================
+// CLASE BASE ABSTRACTA - TramaBase
+// ============================================================================
+
+/**
+ * @class TramaBase
+ * @brief Clase base abstracta para todas las tramas del protocolo PRT-7
+ *
+ * Define la interfaz común para las tramas LOAD y MAP mediante polimorfismo.
+ */
+class TramaBase {
+public:
+    /**
+     * @brief Método virtual puro para procesar la trama
+     * @param carga Puntero a la lista de carga donde se almacenan los datos
+     * @param rotor Puntero al rotor de mapeo que realiza la decodificación
+     */
+    virtual void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) = 0;
+
+    /**
+     * @brief Destructor virtual para permitir polimorfismo correcto
+     */
+    virtual ~TramaBase() {}
+};
+
+// ============================================================================
+// LÓGICA COMÚN DE LAS TRAMAS
+// ============================================================================
+
+/**
+ * @brief Escribe el reporte de una trama LOAD ya procesada
+ * @param caracter Carácter recibido
+ * @param decodificado Carácter resultante del mapeo
+ * @param carga Lista con el mensaje acumulado (para DETALLE_TRAZA)
+ * @param salida Escritor de destino
+ */
+void reportarCarga(char caracter, char decodificado, ListaDeCarga* carga, EscritorSalida& salida);
+
+/**
+ * @brief Escribe el reporte de una trama MAP ya procesada
+ * @param rotacion Rotación recibida
+ * @param salida Escritor de destino
+ * @param rotor Rotor de la cadena al que se dirigió (0 = el primero, reportado como M,<n>)
+ *
+ * Una trama a otro rotor se reporta como [M,<rotor>,<n>], para que las
+ * rotaciones de rotores distintos no se vean iguales.
+ */
+void reportarMapeo(int rotacion, EscritorSalida& salida, int rotor = 0);
+
+/**
+ * @brief Lógica de una trama LOAD: decodifica el carácter y lo agrega a la lista
+ * @param caracter Carácter recibido en la trama
+ * @param carga Lista donde almacenar el carácter decodificado
+ * @param rotor Rotor que realiza el mapeo
+ * @param salida Escritor donde reportar la trama según su nivel de detalle
+ *
+ * La comparten TramaLoad::procesar() y despacharTrama().
+ */
+inline void procesarCarga(char caracter, ListaDeCarga* carga, RotorDeMapeo* rotor,
+                          EscritorSalida& salida) {
+    char decodificado = rotor->getMapeo(caracter);
+    carga->insertarAlFinal(decodificado);
+
+    if (salida.getNivel() != DETALLE_SILENCIOSO) {
+        reportarCarga(caracter, decodificado, carga, salida);
+    }
+}
+
+/**
+ * @brief Lógica de una trama MAP: rota el rotor
+ * @param rotacion Número de posiciones a rotar
+ * @param rotor Rotor a rotar
+ * @param salida Escritor donde reportar la trama según su nivel de detalle
+ *
+ * La comparten TramaMap::procesar() y despacharTrama().
+ */
+inline void procesarMapeo(int rotacion, RotorDeMapeo* rotor, EscritorSalida& salida) {
+    rotor->rotar(rotacion);
+
+    if (salida.getNivel() != DETALLE_SILENCIOSO) {
+        reportarMapeo(rotacion, salida);
+    }
+}
+
+// ============================================================================
+// TRAMAS CONCRETAS
+// ============================================================================
+
+/**
+ * @class TramaLoad
+ * @brief Trama de carga que contiene un fragmento de dato
+ *
+ * Representa una trama tipo L,X donde X es un carácter a decodificar.
+ */
+class TramaLoad : public TramaBase {
+private:
+    char caracter;  ///< Carácter a procesar
+
+public:
+    /**
+     * @brief Constructor
+     * @param c Carácter de la trama
+     */
+    TramaLoad(char c) : caracter(c) {}
+
+    /**
+     * @brief Procesa la trama: decodifica el carácter y lo agrega a la lista
+     * @param carga Lista donde almacenar el carácter decodificado
+     * @param rotor Rotor que realiza el mapeo
+     */
+    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) override;
+};
+
+/**
+ * @class TramaMap
+ * @brief Trama de mapeo que modifica la rotación del rotor
+ *
+ * Representa una trama tipo M,N donde N es el número de rotaciones.
+ */
+class TramaMap : public TramaBase {
+private:
+    int rotacion;  ///< Cantidad de rotación a aplicar
+
+public:
+    /**
+     * @brief Constructor
+     * @param n Número de posiciones a rotar
+     */
+    TramaMap(int n) : rotacion(n) {}
+
+    /**
+     * @brief Procesa la trama: rota el rotor
+     * @param carga No se utiliza en esta trama
+     * @param rotor Rotor a rotar
+     */
+    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) override;
+};
+
+// ============================================================================
+// TRAMAS POR VALOR (SIN MEMORIA DINÁMICA)
+// ============================================================================
+
+/**
+ * @enum TipoTrama
+ * @brief Tipos de trama del protocolo PRT-7
+ */
+enum TipoTrama {
+    TRAMA_LOAD,  ///< Trama L,X
+    TRAMA_MAP,   ///< Trama M,N o M,R,N
+    TRAMA_FIN    ///< Trama END
+};
+
+/**
+ * @struct Trama
+ * @brief Trama del protocolo representada por valor
+ *
+ * Es la representación usada en el camino crítico: vive en la pila, no
+ * requiere new/delete y se despacha con un switch en despacharTrama().
+ * La jerarquía TramaBase sigue disponible para tramas de extensión.
+ */
+struct Trama {
+    TipoTrama tipo;       ///< Tipo de la trama
+    char caracter;        ///< Carácter de una trama LOAD
+    unsigned char rotor;  ///< Rotor al que se dirige una trama MAP (0 = el primero)
+    int rotacion;         ///< Rotación de una trama MAP
+
+    /**
+     * @brief Crea una trama LOAD
+     * @param c Carácter de la trama
+     * @return Trama LOAD
+     */
+    static Trama carga(char c) {
+        Trama t;
+        t.tipo = TRAMA_LOAD;
+        t.caracter = c;
+        t.rotor = 0;
+        t.rotacion = 0;
+        return t;
+    }
+
+    /**
+     * @brief Crea una trama MAP
+     * @param n Número de posiciones a rotar
+     * @param indiceRotor Rotor al que se dirige (tramas M,<rotor>,<n>)
+     * @return Trama MAP
+     */
+    static Trama mapeo(int n, int indiceRotor = 0) {
+        Trama t;
+        t.tipo = TRAMA_MAP;
+        t.caracter = '\0';
+        t.rotor = static_cast<unsigned char>(indiceRotor);
+        t.rotacion = n;
+        return t;
+    }
+
+    /**
+     * @brief Crea una trama END
+     * @return Trama de fin de transmisión
+     */
+    static Trama fin() {
+        Trama t;
+        t.tipo = TRAMA_FIN;
+        t.caracter = '\0';
+        t.rotor = 0;
+        t.rotacion = 0;
+        return t;
+    }
+};
+
+/**
+ * @brief Procesa una trama por valor sin llamadas virtuales
+ * @param trama Trama a procesar
+ * @param carga Lista de carga de la sesión
+ * @param rotor Rotor de mapeo de la sesión
+ * @param salida Escritor de la sesión
+ * @return false si la trama es END y la transmisión terminó
+ */
+inline bool despacharTrama(const Trama& trama, ListaDeCarga* carga, RotorDeMapeo* rotor,
+                           EscritorSalida& salida) {
+    switch (trama.tipo) {
+        case TRAMA_LOAD:
+            procesarCarga(trama.caracter, carga, rotor, salida);
+            return true;
+        case TRAMA_MAP:
+            procesarMapeo(trama.rotacion, rotor, salida);
+            return true;
+        case TRAMA_FIN:
+            return false;
+    }
+    return true;
+}
+
+#endif // PRT7_TRAMA_H
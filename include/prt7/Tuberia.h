@@ -0,0 +1,48 @@
+/**
+ * @file Tuberia.h
+ * @brief Decodificación en tres etapas (lector, decodificador, escritor) en hilos separados
+ */
+
+#ifndef PRT7_TUBERIA_H
+#define PRT7_TUBERIA_H
+
+#include "prt7/Decodificador.h"
+#include "prt7/PuertoSerial.h"
+
+/**
+ * @struct EstadisticasTuberia
+ * @brief Contadores de una ejecución de decodificarEnTuberia()
+ */
+struct EstadisticasTuberia {
+    unsigned long long lotesLeidos;            ///< Lotes de tramas que entregó el lector
+    unsigned long long esperasLector;          ///< Veces que el lector encontró llena su cola
+    unsigned long long esperasDecodificador;   ///< Veces que el decodificador encontró llena la cola de salida
+    unsigned long long esperasEscritor;        ///< Veces que el escritor encontró vacía su cola
+
+    /**
+     * @brief Constructor con los contadores en cero
+     */
+    EstadisticasTuberia()
+        : lotesLeidos(0), esperasLector(0), esperasDecodificador(0), esperasEscritor(0) {}
+};
+
+/**
+ * @brief Decodifica lo que entregue un lector con una etapa por hilo
+ * @param lector Lector ya asociado a un puerto o a la entrada estándar
+ * @param decodificador Sesión que recibe las tramas
+ * @param timeoutMs Espera máxima de cada rellenado del lector
+ * @param inactividadMs Tiempo máximo sin datos antes de cerrar la sesión (0 = sin límite)
+ * @param estadisticas Contadores de contrapresión de la ejecución
+ *
+ * Un hilo vacía el lector en lotes de tramas, otro aplica el rotor y la
+ * lista de carga, y un tercero da formato a los reportes con el nivel de
+ * detalle de la salida del decodificador. Las etapas se comunican por colas
+ * ColaSPSC acotadas, así que una consola lenta sólo frena al escritor y, si
+ * su cola se llena, al decodificador, pero no la lectura del puerto hasta
+ * que también se llene la cola del lector. Termina con END, al cerrarse
+ * el flujo o al vencer el plazo de inactividad.
+ */
+void decodificarEnTuberia(LectorSerial& lector, Decodificador& decodificador, int timeoutMs,
+                          int inactividadMs, EstadisticasTuberia& estadisticas);
+
+#endif // PRT7_TUBERIA_H
@@ -0,0 +1,38 @@
+/**
+ * @file prt7.h
+ * @brief Encabezado general de la biblioteca del decodificador PRT-7
+ *
+ * Incluye todos los componentes públicos. Para decodificar basta con crear
+ * un Decodificador, llamar a Decodificador::alimentar() con los bytes que
+ * se vayan recibiendo y a Decodificador::finalizar() al cerrarse el flujo.
+ */
+
+#ifndef PRT7_PRT7_H
+#define PRT7_PRT7_H
+
+#include "prt7/AgrupadorTramas.h"
+#include "prt7/AnalizadorBinario.h"
+#include "prt7/AnalizadorTramas.h"
+#include "prt7/ArchivoMapeado.h"
+#include "prt7/CodificadorTramas.h"
+#include "prt7/ColaSPSC.h"
+#include "prt7/DecodificacionParalela.h"
+#include "prt7/Decodificador.h"
+#include "prt7/DeteccionPuerto.h"
+#include "prt7/EscritorSalida.h"
+#include "prt7/GrabadorCaptura.h"
+#include "prt7/ListaDeCarga.h"
+#include "prt7/MapeoVectorial.h"
+#include "prt7/Metricas.h"
+#include "prt7/Multipuerto.h"
+#include "prt7/PuertoSerial.h"
+#include "prt7/PuntoControl.h"
+#include "prt7/RotorAlfabeto.h"
+#include "prt7/RotorCompuesto.h"
+#include "prt7/RotorDeMapeo.h"
+#include "prt7/SesionAsincrona.h"
+#include "prt7/SumideroCarga.h"
+#include "prt7/Trama.h"
+#include "prt7/Tuberia.h"
+
+#endif // PRT7_PRT7_H
@@ -7,620 +7,865 @@
  * Este programa implementa un decodificador para el protocolo PRT-7 que lee
  * tramas desde un puerto serial (Arduino) y decodifica mensajes ocultos usando
  * listas doblemente enlazadas y listas circulares.
+ * 
+ * La lógica de decodificación vive en la biblioteca prt7 (include/prt7); este
+ * archivo sólo interpreta la línea de comandos y conecta la entrada elegida
+ * con un Decodificador.
  */
 
 #include <iostream>
 #include <cstring>
 #include <cstdlib>
+#include <cerrno>
+
+#include "prt7/ArchivoMapeado.h"
+#include "prt7/CodificadorTramas.h"
+#include "prt7/DecodificacionParalela.h"
+#include "prt7/Decodificador.h"
+#include "prt7/DeteccionPuerto.h"
+#include "prt7/GrabadorCaptura.h"
+#include "prt7/Metricas.h"
+#include "prt7/Multipuerto.h"
+#include "prt7/PuertoSerial.h"
+#include "prt7/PuntoControl.h"
+#include "prt7/SumideroCarga.h"
+#include "prt7/Tuberia.h"
 
 #ifdef _WIN32
-    #include <windows.h>
-#else
     #include <fcntl.h>
+    #include <io.h>
+#else
     #include <unistd.h>
-    #include <termios.h>
 #endif
 
 // ============================================================================
-// DECLARACIONES FORWARD
+// OPCIONES DE LÍNEA DE COMANDOS
 // ============================================================================
 
-class ListaDeCarga;
-class RotorDeMapeo;
+/// Segundos entre guardados de --checkpoint sin --checkpoint-interval
+static const long INTERVALO_PUNTO_CONTROL = 5;
 
-// ============================================================================
-// CLASE BASE ABSTRACTA - TramaBase
-// ============================================================================
+/// Caracteres entre las tramas MAP que intercalan --encode y --verify sin --map-every
+static const long INTERVALO_MAPEO = 16;
+
+/// Presupuesto mínimo de --memory-budget: la arena de nodos reserva en lotes de hasta 64 KiB
+static const long long PRESUPUESTO_MINIMO = 256 * 1024;
 
 /**
- * @class TramaBase
- * @brief Clase base abstracta para todas las tramas del protocolo PRT-7
- * 
- * Define la interfaz común para las tramas LOAD y MAP mediante polimorfismo.
+ * @struct OpcionesPrograma
+ * @brief Opciones de ejecución tomadas de la línea de comandos
  */
-class TramaBase {
-public:
-    /**
-     * @brief Método virtual puro para procesar la trama
-     * @param carga Puntero a la lista de carga donde se almacenan los datos
-     * @param rotor Puntero al rotor de mapeo que realiza la decodificación
-     */
-    virtual void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) = 0;
+struct OpcionesPrograma {
+    ConfiguracionSerial serial;  ///< Configuración del puerto
+    NivelDetalle detalle;        ///< Nivel de detalle de la salida por trama
+    const char* entrada;         ///< Captura a reproducir ("-" = entrada estándar), o nullptr
+    const char* puertos[DecodificadorMultipuerto::MAXIMO_PUERTOS];  ///< Puertos indicados con --port
+    int cantidadPuertos;         ///< Cantidad de --port indicados
+    int hilos;                   ///< Hilos para varios puertos (0 = uno por núcleo)
+    bool tuberia;                ///< true para leer, decodificar y escribir en hilos separados
+    int trabajos;                ///< Hilos para reproducir una captura en paralelo (0 = en orden)
+    int rotores;                 ///< Rotores encadenados (1 = rotor único)
+    bool avance;                 ///< true si cada carácter mueve la cadena de rotores
+    const char* sumidero;        ///< Destino del mensaje mientras se ensambla, o nullptr
+    long ventana;                ///< Caracteres retenidos en memoria con sumidero (-1 = por defecto)
+    bool historial;              ///< true para conservar el mensaje completo aunque haya sumidero
+    long inactividad;            ///< Milisegundos sin datos que cierran la sesión (-1 = por defecto, 0 = nunca)
+    long intervaloMetricas;      ///< Segundos entre informes de métricas (0 = sin línea periódica)
+    const char* archivoMetricas; ///< Archivo Prometheus a mantener actualizado, o nullptr
+    const char* puntoControl;    ///< Archivo del punto de control de la sesión, o nullptr
+    long intervaloPuntoControl;  ///< Segundos entre guardados del punto de control
+    long limiteDeteccion;        ///< Milisegundos de búsqueda con --port auto (0 = sin límite)
+    const char* grabacion;       ///< Captura donde grabar los bytes recibidos, o nullptr
+    const char* codificar;       ///< Mensaje a convertir en un flujo de tramas, o nullptr
+    const char* verificar;       ///< Mensaje para la verificación de ida y vuelta, o nullptr
+    long intervaloMapeo;         ///< Caracteres entre tramas MAP al codificar (0 = ninguna)
+    long semilla;                ///< Semilla de las rotaciones al codificar
+    long long presupuesto;       ///< Bytes máximos de la lista de carga (0 = sin límite)
+    const char* derrame;         ///< Archivo donde derramar lo que no cabe en el presupuesto, o nullptr
     
     /**
-     * @brief Destructor virtual para permitir polimorfismo correcto
+     * @brief Constructor con los valores por defecto
      */
-    virtual ~TramaBase() {}
+    OpcionesPrograma() : detalle(DETALLE_DELTA), entrada(nullptr), cantidadPuertos(0), hilos(0), tuberia(false), trabajos(0),
+                         rotores(1), avance(false), sumidero(nullptr), ventana(-1), historial(false),
+                         inactividad(-1), intervaloMetricas(0), archivoMetricas(nullptr), puntoControl(nullptr),
+                         intervaloPuntoControl(INTERVALO_PUNTO_CONTROL), limiteDeteccion(0), grabacion(nullptr),
+                         codificar(nullptr), verificar(nullptr), intervaloMapeo(INTERVALO_MAPEO), semilla(1),
+                         presupuesto(0), derrame(nullptr) {}
 };
 
-// ============================================================================
-// NODOS PARA ESTRUCTURAS DE DATOS
-// ============================================================================
+/// Milisegundos sin datos tras los que se cierra una sesión de puerto serial sin --idle-timeout
+static const long TIEMPO_INACTIVIDAD_MS = 10000;
+
+/// Segundos entre actualizaciones de --metrics-file cuando no se indica --stats
+static const long INTERVALO_METRICAS_ARCHIVO = 10;
+
+/// Caracteres del mensaje que se retienen en memoria con --sink y sin --window
+static const long VENTANA_PREDETERMINADA = 4096;
 
 /**
- * @struct NodoRotor
- * @brief Nodo para la lista circular del rotor de mapeo
+ * @brief Muestra las opciones de línea de comandos
+ * @param programa Nombre del ejecutable (argv[0])
  */
-struct NodoRotor {
-    char dato;              ///< Carácter almacenado (A-Z)
-    NodoRotor* siguiente;   ///< Puntero al siguiente nodo
-    NodoRotor* previo;      ///< Puntero al nodo previo
-    
-    /**
-     * @brief Constructor del nodo
-     * @param c Carácter a almacenar
-     */
-    NodoRotor(char c) : dato(c), siguiente(nullptr), previo(nullptr) {}
-};
+void mostrarUso(const char* programa) {
+    std::cout << "Uso: " << programa << " [opciones]" << std::endl;
+    std::cout << "  --port <nombre>     Puerto serial (COM3, /dev/ttyUSB0, ...); repetir para varios" << std::endl;
+    std::cout << "  --port auto[:<p>]   Usa el primer puerto que transmita una trama (" 
+    #ifdef _WIN32
+              << "COM1-COM32"
+    #else
+              << "/dev/ttyUSB*, /dev/ttyACM*"
+    #endif
+              << ", o los que empiecen con p)" << std::endl;
+    std::cout << "  --probe-timeout <ms> Tiempo maximo de busqueda con --port auto (por defecto sin limite)" << std::endl;
+    std::cout << "  --threads <n>       Hilos para decodificar varios puertos (por defecto uno por nucleo)" << std::endl;
+    std::cout << "  --baud <n>          Velocidad en baudios (por defecto 9600)" << std::endl;
+    std::cout << "  --vmin <n>          VMIN de termios, 0-255 (POSIX)" << std::endl;
+    std::cout << "  --vtime <n>         VTIME de termios en décimas de segundo, 0-255 (POSIX)" << std::endl;
+    std::cout << "  --no-raw            No aplicar modo crudo (cfmakeraw)" << std::endl;
+    std::cout << "  --rtscts            Control de flujo por hardware RTS/CTS" << std::endl;
+    std::cout << "  --rx-buffer <n>     Buffer de recepción del driver en bytes (Windows)" << std::endl;
+    std::cout << "  --tx-buffer <n>     Buffer de transmisión del driver en bytes (Windows)" << std::endl;
+    std::cout << "  --idle-timeout <ms> Cierra la sesion tras tantos ms sin datos (por defecto "
+              << TIEMPO_INACTIVIDAD_MS << " en puertos, sin limite en stdin; 0 = nunca)" << std::endl;
+    std::cout << "  --binary            Tramas en la codificacion binaria compacta en lugar de texto" << std::endl;
+    std::cout << "  --pipeline          Lector, decodificador y escritor en hilos separados" << std::endl;
+    std::cout << "  --verbosity <nivel> silent, delta (por defecto) o trace" << std::endl;
+    std::cout << "  --input <archivo>   Reproduce una captura en lugar del puerto ('-' = stdin)" << std::endl;
+    std::cout << "  --record <archivo>  Graba los bytes recibidos con marcas de tiempo (se reproduce con --input)" << std::endl;
+    std::cout << "  --rotors <n>        Rotores encadenados, 1-" << RotorCompuesto::MAXIMO_ROTORES
+              << " (tramas M,<rotor>,<n>)" << std::endl;
+    std::cout << "  --stepping <modo>   none (por defecto) u odometer: cada caracter avanza la cadena" << std::endl;
+    std::cout << "  --jobs <n>          Reproduce la captura en paralelo con n hilos (requiere --verbosity silent)" << std::endl;
+    std::cout << "  --sink <destino>    Entrega el mensaje mientras se ensambla: stdout, file:<ruta> o tcp:<host>:<puerto>" << std::endl;
+    std::cout << "  --window <n>        Caracteres retenidos en memoria con --sink (por defecto " << VENTANA_PREDETERMINADA
+              << "; 0 = todos)" << std::endl;
+    std::cout << "  --history           Conserva el mensaje completo en memoria aunque haya --sink" << std::endl;
+    std::cout << "  --memory-budget <t> Memoria maxima del mensaje (ej. 512K, 64M); lo antiguo sale a --sink o --spill" << std::endl;
+    std::cout << "  --spill <archivo>   Donde escribir lo que no cabe en --memory-budget cuando no hay --sink" << std::endl;
+    std::cout << "  --stats <segundos>  Escribe una linea de metricas en stderr cada tantos segundos" << std::endl;
+    std::cout << "  --metrics-file <r>  Mantiene las metricas en formato Prometheus en el archivo r" << std::endl;
+    std::cout << "  --checkpoint <r>    Guarda la sesion en r periodicamente y la reanuda desde r al iniciar" << std::endl;
+    std::cout << "  --checkpoint-interval <s> Segundos entre guardados de --checkpoint (por defecto "
+              << INTERVALO_PUNTO_CONTROL << ")" << std::endl;
+    std::cout << "  --encode <mensaje>  Escribe en stdout el flujo de tramas que transmite el archivo mensaje ('-' = stdin)" << std::endl;
+    std::cout << "  --verify <mensaje>  Codifica y decodifica el archivo mensaje y compara el resultado" << std::endl;
+    std::cout << "  --map-every <n>     Caracteres entre tramas MAP con --encode y --verify (por defecto "
+              << INTERVALO_MAPEO << "; 0 = ninguna)" << std::endl;
+    std::cout << "  --seed <n>          Semilla de las rotaciones de --encode y --verify (por defecto 1)" << std::endl;
+    std::cout << "  --help              Muestra esta ayuda" << std::endl;
+}
 
 /**
- * @struct NodoCarga
- * @brief Nodo para la lista doblemente enlazada de carga
+ * @brief Convierte el valor de una opción numérica validando su rango
+ * @param texto Texto a convertir
+ * @param minimo Valor mínimo aceptado
+ * @param maximo Valor máximo aceptado
+ * @param valor Resultado de la conversión
+ * @return true si el texto es un entero dentro del rango
  */
-struct NodoCarga {
-    char dato;              ///< Carácter decodificado
-    NodoCarga* siguiente;   ///< Puntero al siguiente nodo
-    NodoCarga* previo;      ///< Puntero al nodo previo
+bool leerEntero(const char* texto, long minimo, long maximo, long& valor) {
+    char* finNumero;
+    errno = 0;
+    long n = strtol(texto, &finNumero, 10);
     
-    /**
-     * @brief Constructor del nodo
-     * @param c Carácter a almacenar
-     */
-    NodoCarga(char c) : dato(c), siguiente(nullptr), previo(nullptr) {}
-};
-
-// ============================================================================
-// ROTOR DE MAPEO - Lista Circular Doblemente Enlazada
-// ============================================================================
+    if (finNumero == texto || *finNumero != '\0' || errno == ERANGE) {
+        return false;
+    }
+    if (n < minimo || n > maximo) {
+        return false;
+    }
+    
+    valor = n;
+    return true;
+}
 
 /**
- * @class RotorDeMapeo
- * @brief Lista circular doblemente enlazada que actúa como disco de cifrado
- * 
- * Implementa una rueda de César que puede rotar para cambiar el mapeo
- * de caracteres dinámicamente.
+ * @brief Convierte un tamaño en bytes, con sufijo opcional K, M o G (potencias de 1024)
+ * @param texto Texto a convertir (ej. "1048576", "512K", "64M")
+ * @param minimo Bytes mínimos aceptados
+ * @param valor Resultado en bytes
+ * @return true si el texto es un tamaño válido no menor que minimo
  */
-class RotorDeMapeo {
-private:
-    NodoRotor* cabeza;  ///< Puntero a la posición 'cero' actual del rotor
+bool leerTamano(const char* texto, long long minimo, long long& valor) {
+    char* finNumero;
+    errno = 0;
+    long long n = strtoll(texto, &finNumero, 10);
     
-public:
-    /**
-     * @brief Constructor que inicializa el rotor con el alfabeto A-Z
-     */
-    RotorDeMapeo() {
-        // Crear lista circular con A-Z
-        cabeza = new NodoRotor('A');
-        NodoRotor* actual = cabeza;
-        
-        for (char c = 'B'; c <= 'Z'; c++) {
-            NodoRotor* nuevo = new NodoRotor(c);
-            actual->siguiente = nuevo;
-            nuevo->previo = actual;
-            actual = nuevo;
-        }
-        
-        // Cerrar el círculo
-        actual->siguiente = cabeza;
-        cabeza->previo = actual;
+    if (finNumero == texto || errno == ERANGE || n < 0) {
+        return false;
+    }
+    int desplazamiento = 0;
+    if (*finNumero == 'K' || *finNumero == 'k') desplazamiento = 10;
+    if (*finNumero == 'M' || *finNumero == 'm') desplazamiento = 20;
+    if (*finNumero == 'G' || *finNumero == 'g') desplazamiento = 30;
+    if (desplazamiento > 0) finNumero++;
+    
+    // Hasta 1 TiB: el resultado no desborda
+    if (*finNumero != '\0' || n > (1LL << (40 - desplazamiento))) {
+        return false;
+    }
+    n <<= desplazamiento;
+    if (n < minimo) {
+        return false;
     }
     
-    /**
-     * @brief Destructor que libera toda la memoria del rotor
-     */
-    ~RotorDeMapeo() {
-        if (!cabeza) return;
+    valor = n;
+    return true;
+}
+
+/**
+ * @brief Lee las opciones desde la línea de comandos
+ * @param argc Cantidad de argumentos
+ * @param argv Argumentos del programa
+ * @param opciones Opciones a completar (conserva los valores por defecto no indicados)
+ * @return true si todos los argumentos son válidos
+ */
+bool analizarArgumentos(int argc, char* argv[], OpcionesPrograma& opciones) {
+    ConfiguracionSerial& config = opciones.serial;
+    
+    for (int i = 1; i < argc; i++) {
+        const char* opcion = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        long numero;
+        long long tamano;
         
-        NodoRotor* actual = cabeza->siguiente;
-        while (actual != cabeza) {
-            NodoRotor* temp = actual;
-            actual = actual->siguiente;
-            delete temp;
+        if (strcmp(opcion, "--no-raw") == 0) {
+            config.modoCrudo = false;
+            continue;
         }
-        delete cabeza;
-    }
-    
-    /**
-     * @brief Rota el rotor N posiciones
-     * @param n Número de posiciones a rotar (positivo=adelante, negativo=atrás)
-     */
-    void rotar(int n) {
-        if (n > 0) {
-            for (int i = 0; i < n; i++) {
-                cabeza = cabeza->siguiente;
-            }
-        } else if (n < 0) {
-            for (int i = 0; i > n; i--) {
-                cabeza = cabeza->previo;
-            }
+        if (strcmp(opcion, "--rtscts") == 0) {
+            config.controlFlujo = true;
+            continue;
         }
-    }
-    
-    /**
-     * @brief Obtiene el carácter mapeado según la rotación actual
-     * @param in Carácter de entrada
-     * @return Carácter mapeado según la posición del rotor
-     */
-    char getMapeo(char in) {
-        // Si no es letra, devolver sin cambios
-        if ((in < 'A' || in > 'Z') && (in < 'a' || in > 'z')) {
-            return in;
+        if (strcmp(opcion, "--pipeline") == 0) {
+            opciones.tuberia = true;
+            continue;
+        }
+        if (strcmp(opcion, "--binary") == 0) {
+            config.formato = FORMATO_BINARIO;
+            continue;
+        }
+        if (strcmp(opcion, "--history") == 0) {
+            opciones.historial = true;
+            continue;
         }
         
-        // Convertir a mayúscula
-        char c = (in >= 'a' && in <= 'z') ? (in - 32) : in;
-        
-        // Buscar el carácter en el rotor
-        NodoRotor* actual = cabeza;
-        int posicionEntrada = 0;
+        if (strcmp(opcion, "--port") != 0 && strcmp(opcion, "--baud") != 0 &&
+            strcmp(opcion, "--vmin") != 0 && strcmp(opcion, "--vtime") != 0 &&
+            strcmp(opcion, "--rx-buffer") != 0 && strcmp(opcion, "--tx-buffer") != 0 &&
+            strcmp(opcion, "--verbosity") != 0 && strcmp(opcion, "--input") != 0 &&
+            strcmp(opcion, "--threads") != 0 && strcmp(opcion, "--jobs") != 0 &&
+            strcmp(opcion, "--rotors") != 0 && strcmp(opcion, "--stepping") != 0 &&
+            strcmp(opcion, "--sink") != 0 && strcmp(opcion, "--window") != 0 &&
+            strcmp(opcion, "--stats") != 0 && strcmp(opcion, "--metrics-file") != 0 &&
+            strcmp(opcion, "--idle-timeout") != 0 && strcmp(opcion, "--checkpoint") != 0 &&
+            strcmp(opcion, "--checkpoint-interval") != 0 && strcmp(opcion, "--probe-timeout") != 0 &&
+            strcmp(opcion, "--record") != 0 && strcmp(opcion, "--encode") != 0 &&
+            strcmp(opcion, "--verify") != 0 && strcmp(opcion, "--map-every") != 0 &&
+            strcmp(opcion, "--seed") != 0 && strcmp(opcion, "--memory-budget") != 0 &&
+            strcmp(opcion, "--spill") != 0) {
+            std::cout << "Error: opcion desconocida " << opcion << std::endl;
+            return false;
+        }
+        if (!valor) {
+            std::cout << "Error: falta el valor de " << opcion << std::endl;
+            return false;
+        }
+        i++;
         
-        do {
-            if (actual->dato == c) {
-                break;
+        if (strcmp(opcion, "--port") == 0) {
+            if (opciones.cantidadPuertos == DecodificadorMultipuerto::MAXIMO_PUERTOS) {
+                std::cout << "Error: demasiados puertos (maximo "
+                          << DecodificadorMultipuerto::MAXIMO_PUERTOS << ")" << std::endl;
+                return false;
             }
-            posicionEntrada++;
-            actual = actual->siguiente;
-        } while (actual != cabeza);
-        
-        // El mapeo es: avanzar desde la cabeza la misma cantidad de posiciones
-        NodoRotor* resultado = cabeza;
-        for (int i = 0; i < posicionEntrada; i++) {
-            resultado = resultado->siguiente;
+            opciones.puertos[opciones.cantidadPuertos++] = valor;
+            config.puerto = opciones.puertos[0];
+        } else if (strcmp(opcion, "--threads") == 0 && leerEntero(valor, 1, 256, numero)) {
+            opciones.hilos = static_cast<int>(numero);
+        } else if (strcmp(opcion, "--jobs") == 0 && leerEntero(valor, 1, 256, numero)) {
+            opciones.trabajos = static_cast<int>(numero);
+        } else if (strcmp(opcion, "--rotors") == 0 &&
+                   leerEntero(valor, 1, RotorCompuesto::MAXIMO_ROTORES, numero)) {
+            opciones.rotores = static_cast<int>(numero);
+        } else if (strcmp(opcion, "--stepping") == 0 && strcmp(valor, "none") == 0) {
+            opciones.avance = false;
+        } else if (strcmp(opcion, "--stepping") == 0 && strcmp(valor, "odometer") == 0) {
+            opciones.avance = true;
+        } else if (strcmp(opcion, "--sink") == 0) {
+            opciones.sumidero = valor;
+        } else if (strcmp(opcion, "--window") == 0 && leerEntero(valor, 0, 1L << 30, numero)) {
+            opciones.ventana = numero;
+        } else if (strcmp(opcion, "--memory-budget") == 0 &&
+                   leerTamano(valor, PRESUPUESTO_MINIMO, tamano)) {
+            opciones.presupuesto = tamano;
+        } else if (strcmp(opcion, "--spill") == 0) {
+            opciones.derrame = valor;
+        } else if (strcmp(opcion, "--idle-timeout") == 0 && leerEntero(valor, 0, 86400000, numero)) {
+            opciones.inactividad = numero;
+        } else if (strcmp(opcion, "--stats") == 0 && leerEntero(valor, 1, 86400, numero)) {
+            opciones.intervaloMetricas = numero;
+        } else if (strcmp(opcion, "--metrics-file") == 0) {
+            opciones.archivoMetricas = valor;
+        } else if (strcmp(opcion, "--probe-timeout") == 0 && leerEntero(valor, 0, 86400000, numero)) {
+            opciones.limiteDeteccion = numero;
+        } else if (strcmp(opcion, "--checkpoint") == 0) {
+            opciones.puntoControl = valor;
+        } else if (strcmp(opcion, "--checkpoint-interval") == 0 && leerEntero(valor, 1, 86400, numero)) {
+            opciones.intervaloPuntoControl = numero;
+        } else if (strcmp(opcion, "--input") == 0) {
+            opciones.entrada = valor;
+        } else if (strcmp(opcion, "--record") == 0) {
+            opciones.grabacion = valor;
+        } else if (strcmp(opcion, "--encode") == 0) {
+            opciones.codificar = valor;
+        } else if (strcmp(opcion, "--verify") == 0) {
+            opciones.verificar = valor;
+        } else if (strcmp(opcion, "--map-every") == 0 && leerEntero(valor, 0, 1L << 30, numero)) {
+            opciones.intervaloMapeo = numero;
+        } else if (strcmp(opcion, "--seed") == 0 && leerEntero(valor, 1, 2147483647L, numero)) {
+            opciones.semilla = numero;
+        } else if (strcmp(opcion, "--baud") == 0 && leerEntero(valor, 1, 4000000, numero)) {
+            config.baudios = numero;
+        } else if (strcmp(opcion, "--vmin") == 0 && leerEntero(valor, 0, 255, numero)) {
+            config.vmin = static_cast<int>(numero);
+        } else if (strcmp(opcion, "--vtime") == 0 && leerEntero(valor, 0, 255, numero)) {
+            config.vtime = static_cast<int>(numero);
+        } else if (strcmp(opcion, "--rx-buffer") == 0 && leerEntero(valor, 1, 1 << 24, numero)) {
+            config.bufferEntrada = static_cast<int>(numero);
+        } else if (strcmp(opcion, "--tx-buffer") == 0 && leerEntero(valor, 1, 1 << 24, numero)) {
+            config.bufferSalida = static_cast<int>(numero);
+        } else if (strcmp(opcion, "--verbosity") == 0 && strcmp(valor, "silent") == 0) {
+            opciones.detalle = DETALLE_SILENCIOSO;
+        } else if (strcmp(opcion, "--verbosity") == 0 && strcmp(valor, "delta") == 0) {
+            opciones.detalle = DETALLE_DELTA;
+        } else if (strcmp(opcion, "--verbosity") == 0 && strcmp(valor, "trace") == 0) {
+            opciones.detalle = DETALLE_TRAZA;
+        } else {
+            std::cout << "Error: valor invalido para " << opcion << ": " << valor << std::endl;
+            return false;
         }
-        
-        return resultado->dato;
     }
-};
+    
+    return true;
+}
 
 // ============================================================================
-// LISTA DE CARGA - Lista Doblemente Enlazada
+// FUNCIÓN PRINCIPAL
 // ============================================================================
 
+/// Tiempo máximo que el bucle principal espera datos del puerto en cada vuelta (ms)
+static const int TIEMPO_ESPERA_MS = 100;
+
 /**
- * @class ListaDeCarga
- * @brief Lista doblemente enlazada para almacenar caracteres decodificados
- * 
- * Almacena los fragmentos de datos en el orden en que son procesados.
+ * @brief Decodifica la transmisión en vivo desde el puerto serial
+ * @param config Configuración del puerto
+ * @param decodificador Sesión que recibe las tramas
+ * @param inactividadMs Tiempo máximo sin datos antes de cerrar la sesión (0 = sin límite)
+ * @param limiteDeteccionMs Tiempo máximo de búsqueda con --port auto (0 = sin límite)
+ * @param tuberia Contadores de la tubería de hilos, o nullptr para decodificar en un solo hilo
+ * @param puntoControl Punto de control de la sesión, o nullptr
+ * @param grabador Captura donde grabar lo recibido, o nullptr
+ * @return true si el puerto pudo abrirse
+ *
+ * Con el puerto "auto" (o "auto:<prefijo>") se buscan los candidatos con un
+ * DetectorPuertos y se decodifica el primero que transmita, empezando por
+ * los bytes que llegaron durante la búsqueda.
  */
-class ListaDeCarga {
-private:
-    NodoCarga* cabeza;  ///< Primer nodo de la lista
-    NodoCarga* cola;    ///< Último nodo de la lista
-    
-public:
-    /**
-     * @brief Constructor que inicializa una lista vacía
-     */
-    ListaDeCarga() : cabeza(nullptr), cola(nullptr) {}
-    
-    /**
-     * @brief Destructor que libera toda la memoria
-     */
-    ~ListaDeCarga() {
-        NodoCarga* actual = cabeza;
-        while (actual) {
-            NodoCarga* temp = actual;
-            actual = actual->siguiente;
-            delete temp;
+bool ejecutarPuertoSerial(const ConfiguracionSerial& config, Decodificador& decodificador, int inactividadMs,
+                          int limiteDeteccionMs, EstadisticasTuberia* tuberia, PuntoControl* puntoControl,
+                          GrabadorCaptura* grabador) {
+    bool automatico = strcmp(config.puerto, "auto") == 0 || strncmp(config.puerto, "auto:", 5) == 0;
+    if (automatico) {
+        std::cout << "Iniciando Decodificador PRT-7. Buscando el puerto del emisor..." << std::endl;
+        
+        DetectorPuertos detector(config, config.puerto[4] == ':' ? config.puerto + 5 : nullptr);
+        PuertoDetectado detectado;
+        if (!detector.detectar(limiteDeteccionMs, detectado)) {
+            std::cout << "Error: Ningun puerto transmitio tramas PRT-7 ("
+                      << detector.getProbados() << " puertos probados)" << std::endl;
+            return false;
         }
-    }
-    
-    /**
-     * @brief Inserta un carácter al final de la lista
-     * @param dato Carácter a insertar
-     */
-    void insertarAlFinal(char dato) {
-        NodoCarga* nuevo = new NodoCarga(dato);
         
-        if (!cabeza) {
-            cabeza = cola = nuevo;
+        std::cout << "Conexion establecida en " << detectado.nombre << ". Esperando tramas..." << std::endl;
+        std::cout << std::endl;
+        
+        detectado.lector->setGrabador(grabador);
+        if (tuberia) {
+            decodificarEnTuberia(*detectado.lector, decodificador, TIEMPO_ESPERA_MS, inactividadMs, *tuberia);
         } else {
-            cola->siguiente = nuevo;
-            nuevo->previo = cola;
-            cola = nuevo;
+            decodificarFlujo(*detectado.lector, decodificador, inactividadMs, puntoControl);
         }
+        cerrarPuertoSerial(detectado.puerto);
+        delete detectado.lector;
+        return true;
     }
     
-    /**
-     * @brief Imprime el mensaje completo ensamblado
-     */
-    void imprimirMensaje() {
-        NodoCarga* actual = cabeza;
-        while (actual) {
-            std::cout << actual->dato;
-            actual = actual->siguiente;
-        }
-        std::cout << std::endl;
-    }
+    std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto COM..." << std::endl;
     
-    /**
-     * @brief Imprime el mensaje con formato detallado
-     */
-    void imprimirConFormato() {
-        NodoCarga* actual = cabeza;
-        while (actual) {
-            std::cout << "[" << actual->dato << "]";
-            actual = actual->siguiente;
-        }
+    DescriptorPuerto puerto = abrirPuertoSerial(config);
+    
+    if (puerto == PUERTO_INVALIDO) {
+        std::cout << "Error: No se pudo abrir el puerto " << config.puerto
+                  << " a " << config.baudios << " baudios" << std::endl;
+        #ifdef _WIN32
+            std::cout << "Intente con otro puerto (--port COM4, etc.)" << std::endl;
+        #else
+            std::cout << "Intente con otro puerto (--port /dev/ttyACM0, etc.)" << std::endl;
+        #endif
+        return false;
     }
-};
-
-// ============================================================================
-// TRAMAS CONCRETAS
-// ============================================================================
-
-/**
- * @class TramaLoad
- * @brief Trama de carga que contiene un fragmento de dato
- * 
- * Representa una trama tipo L,X donde X es un carácter a decodificar.
- */
-class TramaLoad : public TramaBase {
-private:
-    char caracter;  ///< Carácter a procesar
     
-public:
-    /**
-     * @brief Constructor
-     * @param c Carácter de la trama
-     */
-    TramaLoad(char c) : caracter(c) {}
+    std::cout << "Conexion establecida. Esperando tramas..." << std::endl;
+    std::cout << std::endl;
     
-    /**
-     * @brief Procesa la trama: decodifica el carácter y lo agrega a la lista
-     * @param carga Lista donde almacenar el carácter decodificado
-     * @param rotor Rotor que realiza el mapeo
-     */
-    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) override {
-        char decodificado = rotor->getMapeo(caracter);
-        carga->insertarAlFinal(decodificado);
-        
-        std::cout << "Trama recibida: [L," << caracter << "] -> Procesando... -> ";
-        std::cout << "Fragmento '" << caracter << "' decodificado como '" 
-                  << decodificado << "'. Mensaje: ";
-        carga->imprimirConFormato();
-        std::cout << std::endl;
+    LectorSerial lector(puerto);
+    lector.setFormato(decodificador.getFormato());
+    lector.setGrabador(grabador);
+    if (tuberia) {
+        decodificarEnTuberia(lector, decodificador, TIEMPO_ESPERA_MS, inactividadMs, *tuberia);
+    } else {
+        decodificarFlujo(lector, decodificador, inactividadMs, puntoControl);
     }
-};
+    cerrarPuertoSerial(puerto);
+    
+    return true;
+}
 
 /**
- * @class TramaMap
- * @brief Trama de mapeo que modifica la rotación del rotor
- * 
- * Representa una trama tipo M,N donde N es el número de rotaciones.
+ * @brief Decodifica una captura guardada, sin esperas entre tramas
+ * @param ruta Ruta de la captura, o "-" para la entrada estándar
+ * @param decodificador Sesión que recibe las tramas
+ * @param trabajos Hilos para decodificar un archivo mapeado en paralelo (0 = en orden)
+ * @param inactividadMs Tiempo máximo sin datos de la entrada estándar (0 = sin límite)
+ * @param tuberia Contadores de la tubería de hilos para la entrada estándar, o nullptr
+ * @param puntoControl Punto de control de la sesión, o nullptr
+ * @param grabador Captura donde grabar lo leído de la entrada estándar, o nullptr
+ * @return true si la captura pudo leerse
+ *
+ * Los archivos regulares se mapean en memoria y se recorren de una vez
+ * (por bloques si hay punto de control, para guardarlo entre uno y otro,
+ * y desde la posición guardada si la sesión se restauró); una tubería en
+ * la entrada estándar se lee por bloques. Sólo esta última se graba: un
+ * archivo ya es una captura.
  */
-class TramaMap : public TramaBase {
-private:
-    int rotacion;  ///< Cantidad de rotación a aplicar
+bool ejecutarReproduccion(const char* ruta, Decodificador& decodificador, int trabajos,
+                          int inactividadMs, EstadisticasTuberia* tuberia, PuntoControl* puntoControl,
+                          GrabadorCaptura* grabador) {
+    std::cout << "Iniciando Decodificador PRT-7. Reproduciendo captura "
+              << (strcmp(ruta, "-") == 0 ? "(entrada estandar)" : ruta) << "..." << std::endl;
+    std::cout << std::endl;
     
-public:
-    /**
-     * @brief Constructor
-     * @param n Número de posiciones a rotar
-     */
-    TramaMap(int n) : rotacion(n) {}
+    ArchivoMapeado captura;
+    if (captura.abrir(ruta)) {
+        if (grabador) {
+            std::cout << "Aviso: --record no graba una captura que ya es un archivo" << std::endl;
+        }
+        if (tuberia) {
+            std::cout << "Aviso: --pipeline no se usa con un archivo; se decodifica en un solo hilo" << std::endl;
+        }
+        if (puntoControl) {
+            if (trabajos > 0) {
+                std::cout << "Aviso: --jobs no se usa con --checkpoint; se reproduce en orden" << std::endl;
+            }
+            reproducirConPuntoControl(captura.getDatos(), captura.getTamano(), decodificador, *puntoControl);
+        } else if (trabajos > 0) {
+            if (decodificador.getSalida().getNivel() != DETALLE_SILENCIOSO) {
+                std::cout << "Aviso: --jobs requiere --verbosity silent; se reproduce en orden" << std::endl;
+            }
+            decodificarEnParalelo(captura.getDatos(), captura.getTamano(), decodificador, trabajos);
+        } else {
+            decodificador.alimentar(captura.getDatos(), captura.getTamano());
+            decodificador.finalizar();
+        }
+        return true;
+    }
     
-    /**
-     * @brief Procesa la trama: rota el rotor
-     * @param carga No se utiliza en esta trama
-     * @param rotor Rotor a rotar
-     */
-    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) override {
-        rotor->rotar(rotacion);
-        std::cout << "\nTrama recibida: [M," << rotacion << "] -> Procesando... -> ";
-        std::cout << "ROTANDO ROTOR " << (rotacion >= 0 ? "+" : "") << rotacion << ".\n" << std::endl;
+    if (strcmp(ruta, "-") != 0) {
+        std::cout << "Error: No se pudo leer la captura " << ruta << std::endl;
+        return false;
     }
-};
-
-// ============================================================================
-// FUNCIONES DE COMUNICACIÓN SERIAL
-// ============================================================================
+    
+    #ifdef _WIN32
+        DescriptorPuerto entrada = GetStdHandle(STD_INPUT_HANDLE);
+    #else
+        DescriptorPuerto entrada = STDIN_FILENO;
+    #endif
+    LectorSerial lector(entrada);
+    lector.setFormato(decodificador.getFormato());
+    lector.setGrabador(grabador);
+    if (tuberia) {
+        decodificarEnTuberia(lector, decodificador, TIEMPO_ESPERA_MS, inactividadMs, *tuberia);
+    } else {
+        decodificarFlujo(lector, decodificador, inactividadMs, puntoControl);
+    }
+    return true;
+}
 
-#ifdef _WIN32
 /**
- * @brief Abre el puerto serial en Windows
- * @param puerto Nombre del puerto (ej: "COM3")
- * @return Handle del puerto o INVALID_HANDLE_VALUE si falla
+ * @brief Escribe en la salida estándar el flujo de tramas que transmite un mensaje
+ * @param opciones Opciones con el mensaje, el formato y la configuración de rotores
+ * @return true si el mensaje pudo leerse y el flujo escribirse completo
+ *
+ * La salida estándar lleva sólo el flujo, listo para --input o para un
+ * emisor; los avisos van a stderr. Un archivo regular se mapea en memoria y
+ * una tubería se codifica por bloques a medida que llega.
  */
-HANDLE abrirPuertoSerial(const char* puerto) {
-    HANDLE hSerial = CreateFileA(puerto, GENERIC_READ | GENERIC_WRITE, 0, NULL,
-                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+bool ejecutarCodificacion(const OpcionesPrograma& opciones) {
+    #ifdef _WIN32
+        // En modo texto, cada 0x0A del flujo binario saldría como 0x0D 0x0A
+        _setmode(_fileno(stdout), _O_BINARY);
+    #endif
+    SumideroArchivo salida;
+    salida.abrir("-", true);
     
-    if (hSerial == INVALID_HANDLE_VALUE) {
-        return INVALID_HANDLE_VALUE;
+    CodificadorTramas codificador(opciones.serial.formato, salida);
+    if (opciones.rotores > 1 || opciones.avance) {
+        codificador.configurarRotores(opciones.rotores, opciones.avance);
     }
-    
-    DCB dcbSerialParams = {0};
-    dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
-    
-    if (!GetCommState(hSerial, &dcbSerialParams)) {
-        CloseHandle(hSerial);
-        return INVALID_HANDLE_VALUE;
+    codificador.setIntervaloMapeo(static_cast<int>(opciones.intervaloMapeo),
+                                  static_cast<unsigned>(opciones.semilla));
+    
+    ArchivoMapeado mensaje;
+    if (mensaje.abrir(opciones.codificar)) {
+        codificador.codificar(mensaje.getDatos(), mensaje.getTamano());
+    } else if (strcmp(opciones.codificar, "-") == 0) {
+        static const size_t BLOQUE = 65536;
+        char* bloque = new char[BLOQUE];
+        size_t leidos;
+        while ((leidos = fread(bloque, 1, BLOQUE, stdin)) > 0) {
+            codificador.codificar(bloque, leidos);
+        }
+        delete[] bloque;
+    } else {
+        std::cerr << "Error: No se pudo leer el mensaje " << opciones.codificar << std::endl;
+        return false;
     }
+    codificador.finalizar();
     
-    dcbSerialParams.BaudRate = CBR_9600;
-    dcbSerialParams.ByteSize = 8;
-    dcbSerialParams.StopBits = ONESTOPBIT;
-    dcbSerialParams.Parity = NOPARITY;
-    
-    if (!SetCommState(hSerial, &dcbSerialParams)) {
-        CloseHandle(hSerial);
-        return INVALID_HANDLE_VALUE;
+    if (codificador.getNoRepresentables() > 0) {
+        std::cerr << "Aviso: " << codificador.getNoRepresentables()
+                  << " caracteres no se decodificaran tal cual (minusculas o fines de linea)" << std::endl;
     }
-    
-    COMMTIMEOUTS timeouts = {0};
-    timeouts.ReadIntervalTimeout = 50;
-    timeouts.ReadTotalTimeoutConstant = 50;
-    timeouts.ReadTotalTimeoutMultiplier = 10;
-    
-    SetCommTimeouts(hSerial, &timeouts);
-    
-    return hSerial;
+    if (codificador.huboFallo()) {
+        std::cerr << "Error: No se pudo escribir el flujo completo" << std::endl;
+        return false;
+    }
+    return true;
 }
 
 /**
- * @brief Lee una línea del puerto serial en Windows
- * @param hSerial Handle del puerto
- * @param buffer Buffer donde almacenar los datos
- * @param maxLen Tamaño máximo del buffer
- * @return true si se leyó una línea completa
+ * @brief Codifica un mensaje, lo decodifica y compara el resultado con el original
+ * @param opciones Opciones con el mensaje, el formato y la configuración de rotores
+ * @return true si el mensaje decodificado es idéntico al original
  */
-bool leerLineaSerial(HANDLE hSerial, char* buffer, int maxLen) {
-    static char bufferInterno[256];
-    static int posBuffer = 0;
-    
-    DWORD bytesLeidos;
-    char c;
-    
-    while (ReadFile(hSerial, &c, 1, &bytesLeidos, NULL) && bytesLeidos > 0) {
-        if (c == '\n' || c == '\r') {
-            if (posBuffer > 0) {
-                bufferInterno[posBuffer] = '\0';
-                int i;
-                for (i = 0; i < posBuffer && i < maxLen - 1; i++) {
-                    buffer[i] = bufferInterno[i];
-                }
-                buffer[i] = '\0';
-                posBuffer = 0;
-                return true;
-            }
-        } else if (posBuffer < 255) {
-            bufferInterno[posBuffer++] = c;
-        }
+bool ejecutarVerificacion(const OpcionesPrograma& opciones) {
+    ArchivoMapeado mensaje;
+    if (!mensaje.abrir(opciones.verificar)) {
+        std::cout << "Error: No se pudo leer el mensaje " << opciones.verificar << std::endl;
+        return false;
     }
     
-    return false;
+    ResultadoVerificacion r = verificarIdaVuelta(mensaje.getDatos(), mensaje.getTamano(), opciones.serial.formato,
+                                                 opciones.rotores, opciones.avance,
+                                                 static_cast<int>(opciones.intervaloMapeo),
+                                                 static_cast<unsigned>(opciones.semilla));
+    
+    double segundos = r.nanosegundos / 1e9;
+    std::cout << "Verificacion de ida y vuelta de " << opciones.verificar << ": "
+              << (r.coincide ? "OK" : "FALLO") << std::endl;
+    std::cout << "  Caracteres: " << r.longitud << " enviados, " << r.decodificados << " decodificados" << std::endl;
+    std::cout << "  Flujo: " << r.tramas << " tramas, " << r.bytesFlujo << " bytes ("
+              << (opciones.serial.formato == FORMATO_BINARIO ? "binario" : "texto") << ")" << std::endl;
+    if (segundos > 0) {
+        std::cout << "  Tiempo: " << segundos * 1000 << " ms, " << r.bytesFlujo / segundos / 1e6
+                  << " MB/s de flujo, "
+                  << r.longitud / segundos / 1e6 << " millones de caracteres/s" << std::endl;
+    }
+    if (r.noRepresentables > 0) {
+        std::cout << "  Aviso: " << r.noRepresentables
+                  << " caracteres no se pueden transmitir tal cual (minusculas o fines de linea)" << std::endl;
+    }
+    if (r.tramasMalformadas > 0) {
+        std::cout << "  Tramas mal formadas: " << r.tramasMalformadas << std::endl;
+    }
+    if (!r.coincide && r.primeraDiferencia < r.longitud) {
+        unsigned char esperado = static_cast<unsigned char>(mensaje.getDatos()[r.primeraDiferencia]);
+        std::cout << "  Primera diferencia en la posicion " << r.primeraDiferencia
+                  << " (se esperaba el byte " << static_cast<int>(esperado) << ")" << std::endl;
+    }
+    return r.coincide;
 }
-#else
+
 /**
- * @brief Abre el puerto serial en Linux
- * @param puerto Nombre del puerto (ej: "/dev/ttyUSB0")
- * @return Descriptor de archivo o -1 si falla
+ * @brief Decodifica varios puertos a la vez, una sesión independiente por puerto
+ * @param opciones Opciones con los puertos y la cantidad de hilos
+ * @return true si al menos un puerto pudo abrirse
+ *
+ * Los reportes por trama se desactivan (las sesiones corren en paralelo);
+ * al terminar se muestra el mensaje ensamblado de cada puerto.
  */
-int abrirPuertoSerial(const char* puerto) {
-    int fd = open(puerto, O_RDWR | O_NOCTTY | O_NDELAY);
-    
-    if (fd == -1) {
-        return -1;
+bool ejecutarMultipuerto(const OpcionesPrograma& opciones) {
+    int inactividad = static_cast<int>(opciones.inactividad < 0 ? TIEMPO_INACTIVIDAD_MS : opciones.inactividad);
+    DecodificadorMultipuerto multipuerto(opciones.hilos, inactividad);
+    for (int i = 0; i < opciones.cantidadPuertos; i++) {
+        ConfiguracionSerial config = opciones.serial;
+        config.puerto = opciones.puertos[i];
+        multipuerto.agregarPuerto(config);
     }
     
-    struct termios options;
-    tcgetattr(fd, &options);
-    
-    cfsetispeed(&options, B9600);
-    cfsetospeed(&options, B9600);
+    std::cout << "Iniciando Decodificador PRT-7. Conectando a " << opciones.cantidadPuertos
+              << " puertos..." << std::endl;
     
-    options.c_cflag |= (CLOCAL | CREAD);
-    options.c_cflag &= ~PARENB;
-    options.c_cflag &= ~CSTOPB;
-    options.c_cflag &= ~CSIZE;
-    options.c_cflag |= CS8;
+    ColectorMensajes colector(multipuerto.getCantidad());
+    int hilos = multipuerto.ejecutar(colector, TIEMPO_ESPERA_MS);
     
-    tcsetattr(fd, TCSANOW, &options);
+    std::cout << "Flujos de datos terminados (" << hilos << " hilos)." << std::endl;
     
-    return fd;
-}
-
-/**
- * @brief Lee una línea del puerto serial en Linux
- * @param fd Descriptor del puerto
- * @param buffer Buffer donde almacenar los datos
- * @param maxLen Tamaño máximo del buffer
- * @return true si se leyó una línea completa
- */
-bool leerLineaSerial(int fd, char* buffer, int maxLen) {
-    static char bufferInterno[256];
-    static int posBuffer = 0;
-    
-    char c;
-    int n;
-    
-    while ((n = read(fd, &c, 1)) > 0) {
-        if (c == '\n' || c == '\r') {
-            if (posBuffer > 0) {
-                bufferInterno[posBuffer] = '\0';
-                int i;
-                for (i = 0; i < posBuffer && i < maxLen - 1; i++) {
-                    buffer[i] = bufferInterno[i];
-                }
-                buffer[i] = '\0';
-                posBuffer = 0;
-                return true;
-            }
-        } else if (posBuffer < 255) {
-            bufferInterno[posBuffer++] = c;
+    int abiertos = 0;
+    for (int i = 0; i < colector.getCapacidad(); i++) {
+        const MensajeRecolectado& m = colector.getMensaje(i);
+        std::cout << "\n--- " << m.puerto << " ---" << std::endl;
+        if (!m.abierto) {
+            std::cout << "Error: No se pudo abrir el puerto" << std::endl;
+            continue;
+        }
+        abiertos++;
+        std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+        std::cout.write(m.texto, m.longitud);
+        std::cout << std::endl;
+        std::cout << "Tramas recibidas: " << m.tramasRecibidas
+                  << (m.completo ? "" : " (sin END)") << std::endl;
+        if (m.tramasMalformadas > 0) {
+            std::cout << "Tramas mal formadas descartadas: " << m.tramasMalformadas << std::endl;
         }
     }
+    std::cout << "---" << std::endl;
     
-    return false;
+    return abiertos > 0;
 }
-#endif
-
-// ============================================================================
-// FUNCIÓN PRINCIPAL
-// ============================================================================
 
 /**
  * @brief Función principal del programa
+ * @param argc Cantidad de argumentos
+ * @param argv Argumentos (ver mostrarUso())
  * @return 0 si finaliza correctamente
  */
-int main() {
+int main(int argc, char* argv[]) {
+    OpcionesPrograma opciones;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            mostrarUso(argv[0]);
+            return 0;
+        }
+    }
+    if (!analizarArgumentos(argc, argv, opciones)) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+    
+    // Modos del emisor: no abren ningún puerto ni muestran la cabecera
+    if (opciones.codificar) {
+        return ejecutarCodificacion(opciones) ? 0 : 1;
+    }
+    if (opciones.verificar) {
+        return ejecutarVerificacion(opciones) ? 0 : 1;
+    }
+    
     std::cout << "==================================================" << std::endl;
     std::cout << "  DECODIFICADOR PRT-7 - PROTOCOLO INDUSTRIAL" << std::endl;
     std::cout << "==================================================" << std::endl;
     std::cout << std::endl;
     
-    // Crear estructuras de datos
-    ListaDeCarga* miListaDeCarga = new ListaDeCarga();
-    RotorDeMapeo* miRotorDeMapeo = new RotorDeMapeo();
-    
-    std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto COM..." << std::endl;
+    // Informe periódico de métricas (sin --stats, el archivo se actualiza cada 10 s)
+    InformePeriodico* informe = nullptr;
+    if (opciones.intervaloMetricas > 0 || opciones.archivoMetricas) {
+        long segundos = opciones.intervaloMetricas > 0 ? opciones.intervaloMetricas : INTERVALO_METRICAS_ARCHIVO;
+        informe = new InformePeriodico(static_cast<int>(segundos * 1000),
+                                       opciones.intervaloMetricas > 0 ? stderr : nullptr,
+                                       opciones.archivoMetricas);
+        informe->iniciar();
+    }
     
-    // Configurar puerto serial
-    const char* nombrePuerto;
-    #ifdef _WIN32
-        nombrePuerto = "COM3";  // Cambiar según sea necesario
-        HANDLE puerto = abrirPuertoSerial(nombrePuerto);
-        
-        if (puerto == INVALID_HANDLE_VALUE) {
-            std::cout << "Error: No se pudo abrir el puerto " << nombrePuerto << std::endl;
-            std::cout << "Intente con otro puerto (COM3, COM4, etc.)" << std::endl;
-            delete miListaDeCarga;
-            delete miRotorDeMapeo;
+    if (!opciones.entrada && opciones.cantidadPuertos > 1) {
+        if (opciones.sumidero) {
+            std::cout << "Aviso: --sink no se usa con varios puertos; los mensajes se muestran al final" << std::endl;
+        }
+        if (opciones.puntoControl) {
+            std::cout << "Aviso: --checkpoint no se usa con varios puertos" << std::endl;
+        }
+        if (opciones.grabacion) {
+            std::cout << "Aviso: --record no se usa con varios puertos" << std::endl;
+        }
+        if (opciones.presupuesto > 0) {
+            std::cout << "Aviso: --memory-budget no se usa con varios puertos" << std::endl;
+        }
+        bool abierto = ejecutarMultipuerto(opciones);
+        delete informe;
+        if (!abierto) {
             return 1;
         }
-    #else
-        nombrePuerto = "/dev/ttyUSB0";  // Cambiar según sea necesario
-        int puerto = abrirPuertoSerial(nombrePuerto);
-        
-        if (puerto == -1) {
-            std::cout << "Error: No se pudo abrir el puerto " << nombrePuerto << std::endl;
-            std::cout << "Intente con otro puerto (/dev/ttyUSB0, /dev/ttyACM0, etc.)" << std::endl;
-            delete miListaDeCarga;
-            delete miRotorDeMapeo;
+        std::cout << "Liberando memoria... Sistema apagado." << std::endl;
+        return 0;
+    }
+    
+    // Crear la sesión (lista de carga, rotor y salida)
+    Decodificador* decodificador = new Decodificador(opciones.detalle);
+    decodificador->setFormato(opciones.serial.formato);
+    if (opciones.rotores > 1 || opciones.avance) {
+        decodificador->configurarRotores(opciones.rotores, opciones.avance);
+    }
+    
+    // Restaurar la sesión antes de conectar el sumidero: lo restaurado ya se entregó
+    PuntoControl* puntoControl = nullptr;
+    if (opciones.puntoControl) {
+        puntoControl = new PuntoControl(opciones.puntoControl, static_cast<int>(opciones.intervaloPuntoControl * 1000));
+        ResultadoPuntoControl resultado = puntoControl->cargar(*decodificador);
+        if (resultado == PUNTO_CONTROL_INVALIDO) {
+            std::cout << "Error: El punto de control " << opciones.puntoControl
+                      << " no se puede usar (danado, de otra configuracion o sin permisos)" << std::endl;
+            delete puntoControl;
+            delete decodificador;
+            delete informe;
             return 1;
         }
-    #endif
+        if (resultado == PUNTO_CONTROL_RESTAURADO) {
+            std::cout << "Sesion restaurada desde " << opciones.puntoControl << ": "
+                      << decodificador->getTramasRecibidas() << " tramas, "
+                      << decodificador->getCarga().getLongitud() << " caracteres" << std::endl;
+        }
+        if (opciones.tuberia) {
+            std::cout << "Aviso: --pipeline no se usa con --checkpoint; se decodifica en un solo hilo" << std::endl;
+            opciones.tuberia = false;
+        }
+    }
     
-    std::cout << "Conexion establecida. Esperando tramas..." << std::endl;
-    std::cout << std::endl;
+    SumideroCarga* sumidero = nullptr;
+    if (opciones.sumidero) {
+        sumidero = crearSumidero(opciones.sumidero);
+        if (!sumidero) {
+            std::cout << "Error: No se pudo abrir el sumidero " << opciones.sumidero << std::endl;
+            delete puntoControl;
+            delete decodificador;
+            delete informe;
+            return 1;
+        }
+        long ventana = opciones.ventana < 0 ? VENTANA_PREDETERMINADA : opciones.ventana;
+        decodificador->getCarga().configurarSalida(sumidero, static_cast<size_t>(ventana), opciones.historial);
+    }
     
-    // Buffer para leer líneas
-    char buffer[256];
-    int tramasRecibidas = 0;
-    
-    // Bucle principal de procesamiento
-    while (true) {
-        if (leerLineaSerial(puerto, buffer, 256)) {
-            tramasRecibidas++;
-            
-            // Parsear la trama
-            char tipo = buffer[0];
-            
-            if (tipo == 'L' && buffer[1] == ',') {
-                // Trama LOAD
-                char caracter = buffer[2];
-                if (caracter == 'S' && buffer[3] == 'p' && buffer[4] == 'a' && 
-                    buffer[5] == 'c' && buffer[6] == 'e') {
-                    caracter = ' ';
-                }
-                
-                TramaBase* trama = new TramaLoad(caracter);
-                trama->procesar(miListaDeCarga, miRotorDeMapeo);
-                delete trama;
-                
-            } else if (tipo == 'M' && buffer[1] == ',') {
-                // Trama MAP
-                int rotacion = 0;
-                char* numStr = buffer + 2;
-                
-                // Convertir manualmente a entero
-                bool negativo = false;
-                int i = 0;
-                if (numStr[0] == '-') {
-                    negativo = true;
-                    i = 1;
-                }
-                
-                while (numStr[i] >= '0' && numStr[i] <= '9') {
-                    rotacion = rotacion * 10 + (numStr[i] - '0');
-                    i++;
-                }
-                
-                if (negativo) rotacion = -rotacion;
-                
-                TramaBase* trama = new TramaMap(rotacion);
-                trama->procesar(miListaDeCarga, miRotorDeMapeo);
-                delete trama;
-                
-            } else if (tipo == 'E' && buffer[1] == 'N' && buffer[2] == 'D') {
-                // Señal de fin
-                break;
+    // Con sumidero lo antiguo ya se entregó; sin él, se derrama a un archivo antes de liberarlo
+    SumideroArchivo* derrame = nullptr;
+    if (opciones.presupuesto > 0) {
+        if (!sumidero && !opciones.derrame) {
+            std::cout << "Error: --memory-budget necesita --sink o --spill para lo que no cabe en memoria" << std::endl;
+            delete puntoControl;
+            delete decodificador;
+            delete informe;
+            return 1;
+        }
+        if (!sumidero) {
+            derrame = new SumideroArchivo();
+            if (!derrame->abrir(opciones.derrame, true)) {
+                std::cout << "Error: No se pudo abrir el archivo de derrame " << opciones.derrame << std::endl;
+                delete derrame;
+                delete puntoControl;
+                delete decodificador;
+                delete informe;
+                return 1;
             }
         }
+        decodificador->getCarga().configurarPresupuesto(static_cast<size_t>(opciones.presupuesto), derrame);
+    } else if (opciones.derrame) {
+        std::cout << "Aviso: --spill sin --memory-budget no se usa" << std::endl;
+    }
+    
+    GrabadorCaptura* grabador = nullptr;
+    if (opciones.grabacion) {
+        grabador = new GrabadorCaptura(opciones.serial.formato);
+        if (!grabador->abrir(opciones.grabacion)) {
+            std::cout << "Error: No se pudo abrir la captura " << opciones.grabacion << std::endl;
+            delete grabador;
+            delete puntoControl;
+            delete decodificador;
+            delete derrame;
+            delete sumidero;
+            delete informe;
+            return 1;
+        }
+    }
+    
+    EstadisticasTuberia estadisticas;
+    EstadisticasTuberia* tuberia = opciones.tuberia ? &estadisticas : nullptr;
+    
+    bool correcto = opciones.entrada
+        ? ejecutarReproduccion(opciones.entrada, *decodificador, opciones.trabajos,
+                               static_cast<int>(opciones.inactividad < 0 ? 0 : opciones.inactividad), tuberia,
+                               puntoControl, grabador)
+        : ejecutarPuertoSerial(opciones.serial, *decodificador,
+                               static_cast<int>(opciones.inactividad < 0 ? TIEMPO_INACTIVIDAD_MS : opciones.inactividad),
+                               static_cast<int>(opciones.limiteDeteccion), tuberia, puntoControl, grabador);
+    
+    // Terminar la captura antes del último informe, para que cuente todo lo grabado
+    if (grabador) {
+        grabador->cerrar();
+    }
+    
+    // Último informe de métricas, ya con el flujo terminado
+    delete informe;
+    
+    if (correcto) {
+        // Resultado final
+        std::cout << "\n---" << std::endl;
+        std::cout << "Flujo de datos terminado." << std::endl;
+        std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+        decodificador->getCarga().imprimirMensaje();
+        std::cout << "---" << std::endl;
+        if (decodificador->getCarga().getDescartados() > 0) {
+            std::cout << "(" << decodificador->getCarga().getDescartados()
+                      << " caracteres anteriores ya entregados a "
+                      << (opciones.sumidero ? opciones.sumidero : opciones.derrame) << ")" << std::endl;
+        }
+        if (decodificador->getTramasMalformadas() > 0) {
+            std::cout << "Tramas mal formadas descartadas: "
+                      << decodificador->getTramasMalformadas() << std::endl;
+        }
+        if (decodificador->getCarga().getSinEntregar() > 0) {
+            std::cout << "Aviso: el sumidero " << opciones.sumidero << " rechazo "
+                      << decodificador->getCarga().getSinEntregar() << " caracteres" << std::endl;
+        }
+        if (puntoControl && puntoControl->getFallos() > 0) {
+            std::cout << "Aviso: " << puntoControl->getFallos() << " guardados de " << opciones.puntoControl
+                      << " fallaron" << std::endl;
+        }
+        if (grabador && (grabador->getPerdidos() > 0 || grabador->huboFallo())) {
+            std::cout << "Aviso: la captura " << opciones.grabacion << " quedo incompleta ("
+                      << grabador->getPerdidos() << " bytes sin grabar"
+                      << (grabador->huboFallo() ? ", error de escritura" : "") << ")" << std::endl;
+        }
+        if (tuberia && estadisticas.lotesLeidos > 0) {
+            std::cout << "Tuberia: " << estadisticas.lotesLeidos << " lotes; esperas por cola llena: lector "
+                      << estadisticas.esperasLector << ", decodificador "
+                      << estadisticas.esperasDecodificador << std::endl;
+        }
         
-        // Timeout simple - si no hay más datos, terminar
-        #ifdef _WIN32
-            Sleep(100);
-        #else
-            usleep(100000);
-        #endif
-        
-        if (tramasRecibidas > 0 && tramasRecibidas % 15 == 0) {
-            // Verificar si hay más datos
-            char test;
-            #ifdef _WIN32
-                DWORD bytesLeidos;
-                if (!ReadFile(puerto, &test, 1, &bytesLeidos, NULL) || bytesLeidos == 0) {
-                    break;
-                }
-            #else
-                if (read(puerto, &test, 1) <= 0) {
-                    break;
-                }
-            #endif
-        }
-    }
-    
-    // Resultado final
-    std::cout << "\n---" << std::endl;
-    std::cout << "Flujo de datos terminado." << std::endl;
-    std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
-    miListaDeCarga->imprimirMensaje();
-    std::cout << "---" << std::endl;
+        std::cout << "Liberando memoria... ";
+    }
     
     // Limpiar memoria
-    std::cout << "Liberando memoria... ";
-    delete miListaDeCarga;
-    delete miRotorDeMapeo;
-    
-    #ifdef _WIN32
-        CloseHandle(puerto);
-    #else
-        close(puerto);
-    #endif
+    delete grabador;
+    delete puntoControl;
+    delete decodificador;
+    delete derrame;
+    delete sumidero;
+    
+    if (!correcto) {
+        return 1;
+    }
     
     std::cout << "Sistema apagado." << std::endl;
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,113 @@
+/**
+ * @file AnalizadorBinario.cpp
+ * @brief Implementación del analizador de tramas binarias
+ */
+
+#include "prt7/AnalizadorBinario.h"
+
+int AnalizadorBinario::analizar(const char* datos, size_t longitud, size_t& consumidos,
+                                Trama* tramas, int maximo, int& malformadas) {
+    static const long long LIMITE = 2147483648LL;  // |INT_MIN|
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(datos);
+    size_t i = 0;
+    int cantidad = 0;
+
+    while (i < longitud && cantidad < maximo) {
+        if (estado == CARACTERES_RACHA) {
+            // Copiar de una vez lo que haya de la racha
+            while (restantes > 0 && i < longitud && cantidad < maximo) {
+                tramas[cantidad++] = Trama::carga(static_cast<char>(bytes[i++]));
+                restantes--;
+            }
+            if (restantes == 0) {
+                estado = ESPERA_ETIQUETA;
+            }
+            continue;
+        }
+
+        unsigned char b = bytes[i++];
+
+        switch (estado) {
+            case ESPERA_ETIQUETA:
+                acumulado = 0;
+                bytesVarint = 0;
+                rotor = 0;
+                switch (b) {
+                    case ETIQUETA_CARGA:       estado = CARACTER_CARGA; break;
+                    case ETIQUETA_MAPEO:       estado = VARINT_ROTACION; break;
+                    case ETIQUETA_MAPEO_ROTOR: estado = ROTOR_MAPEO; break;
+                    case ETIQUETA_RACHA:       estado = VARINT_RACHA; break;
+                    case ETIQUETA_MARCA_TIEMPO:
+                        estado = BYTES_MARCA;
+                        restantes = BYTES_MARCA_TIEMPO;
+                        break;
+                    case ETIQUETA_FIN:
+                        tramas[cantidad++] = Trama::fin();
+                        consumidos = i;
+                        return cantidad;
+                    default:
+                        // Etiqueta desconocida: descartar el byte y resincronizar
+                        malformadas++;
+                        break;
+                }
+                break;
+
+            case CARACTER_CARGA:
+                tramas[cantidad++] = Trama::carga(static_cast<char>(b));
+                estado = ESPERA_ETIQUETA;
+                break;
+
+            case ROTOR_MAPEO:
+                rotor = b;
+                estado = VARINT_ROTACION;
+                break;
+
+            case VARINT_ROTACION:
+            case VARINT_RACHA:
+                acumulado |= static_cast<unsigned long long>(b & 0x7F) << (7 * bytesVarint);
+                bytesVarint++;
+
+                if (b & 0x80) {
+                    if (bytesVarint == BYTES_MAXIMOS_VARINT) {
+                        // Varint demasiado largo
+                        malformadas++;
+                        estado = ESPERA_ETIQUETA;
+                    }
+                    break;
+                }
+
+                if (estado == VARINT_ROTACION) {
+                    // Deshacer el zigzag: los pares son positivos, los impares negativos
+                    long long n = (acumulado & 1) ? -static_cast<long long>(acumulado >> 1) - 1
+                                                  : static_cast<long long>(acumulado >> 1);
+                    if (n >= LIMITE || n < -LIMITE) {
+                        malformadas++;
+                    } else {
+                        tramas[cantidad++] = Trama::mapeo(static_cast<int>(n), rotor);
+                    }
+                    estado = ESPERA_ETIQUETA;
+                } else if (acumulado == 0) {
+                    // Una racha vacía no es una trama
+                    malformadas++;
+                    estado = ESPERA_ETIQUETA;
+                } else {
+                    restantes = acumulado;
+                    estado = CARACTERES_RACHA;
+                }
+                break;
+
+            case BYTES_MARCA:
+                if (--restantes == 0) {
+                    estado = ESPERA_ETIQUETA;
+                }
+                break;
+
+            case CARACTERES_RACHA:
+                break;
+        }
+    }
+
+    consumidos = i;
+    return cantidad;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file AnalizadorTramas.cpp
+ * @brief Implementación del analizador de tramas de texto
+ */
+
+#include "prt7/AnalizadorTramas.h"
+
+const char* descripcionError(ErrorTrama error) {
+    switch (error) {
+        case TRAMA_VALIDA:           return "trama valida";
+        case TRAMA_COMENTARIO:       return "comentario";
+        case ERROR_TRAMA_VACIA:      return "linea vacia";
+        case ERROR_TIPO_DESCONOCIDO: return "tipo de trama desconocido";
+        case ERROR_FORMATO:          return "formato invalido";
+        case ERROR_DESBORDAMIENTO:   return "rotacion fuera de rango";
+        case ERROR_LINEA_LARGA:      return "linea demasiado larga";
+    }
+    return "error desconocido";
+}
+
+ErrorTrama analizarTrama(const char* linea, int longitud, Trama& trama) {
+    enum Estado {
+        INICIO,       // Esperando el tipo de trama
+        COMA_LOAD,    // Leído 'L', se espera ','
+        VALOR_LOAD,   // Se espera el carácter de la trama LOAD
+        FIN_LOAD,     // Carácter leído, la línea debe terminar
+        ESPACIO,      // Leído "S" de un posible "Space"
+        COMA_MAP,     // Leído 'M', se espera ','
+        SIGNO_MAP,    // Se espera el signo o el primer dígito
+        DIGITO_MAP,   // Se espera al menos un dígito
+        NUMERO_MAP,   // Dígitos de la rotación
+        FIN_E,        // Leído 'E'
+        FIN_EN,       // Leído "EN"
+        FIN_END       // Leído "END", la línea debe terminar
+    };
+
+    static const char RESTO_SPACE[] = "pace";
+    static const long long LIMITE = 2147483648LL;  // |INT_MIN|
+    static const long long MAXIMO_ROTOR = 255;     // Índice de rotor en M,<rotor>,<n>
+
+    if (longitud <= 0) {
+        return ERROR_TRAMA_VACIA;
+    }
+    if (linea[0] == MARCA_COMENTARIO) {
+        return TRAMA_COMENTARIO;
+    }
+    if (longitud > LONGITUD_MAXIMA_TRAMA) {
+        return ERROR_LINEA_LARGA;
+    }
+
+    Estado estado = INICIO;
+    char caracter = '\0';
+    int coincidencias = 0;  // Letras de "pace" ya reconocidas
+    bool negativo = false;
+    bool conSigno = false;
+    long long magnitud = 0;
+    int rotor = -1;         // Índice de M,<rotor>,<n>, o -1 en M,<n>
+
+    for (int i = 0; i < longitud; i++) {
+        char c = linea[i];
+
+        switch (estado) {
+            case INICIO:
+                if (c == 'L') estado = COMA_LOAD;
+                else if (c == 'M') estado = COMA_MAP;
+                else if (c == 'E') estado = FIN_E;
+                else return ERROR_TIPO_DESCONOCIDO;
+                break;
+
+            case COMA_LOAD:
+                if (c != ',') return ERROR_FORMATO;
+                estado = VALOR_LOAD;
+                break;
+
+            case VALOR_LOAD:
+                caracter = c;
+                estado = (c == 'S') ? ESPACIO : FIN_LOAD;
+                break;
+
+            case ESPACIO:
+                if (coincidencias >= 4 || c != RESTO_SPACE[coincidencias]) return ERROR_FORMATO;
+                coincidencias++;
+                break;
+
+            case FIN_LOAD:
+            case FIN_END:
+                return ERROR_FORMATO;
+
+            case COMA_MAP:
+                if (c != ',') return ERROR_FORMATO;
+                estado = SIGNO_MAP;
+                break;
+
+            case SIGNO_MAP:
+                if (c == '-' || c == '+') {
+                    negativo = (c == '-');
+                    conSigno = true;
+                    estado = DIGITO_MAP;
+                    break;
+                }
+                // Sin signo: el carácter debe ser el primer dígito
+                // fall through
+            case DIGITO_MAP:
+            case NUMERO_MAP:
+                if (c == ',' && estado == NUMERO_MAP && rotor < 0 && !conSigno) {
+                    // El número leído era el índice del rotor: sigue la rotación
+                    if (magnitud > MAXIMO_ROTOR) return ERROR_FORMATO;
+                    rotor = static_cast<int>(magnitud);
+                    magnitud = 0;
+                    estado = SIGNO_MAP;
+                    break;
+                }
+                if (c < '0' || c > '9') return ERROR_FORMATO;
+                magnitud = magnitud * 10 + (c - '0');
+                if (magnitud > LIMITE || (!negativo && magnitud == LIMITE)) {
+                    return ERROR_DESBORDAMIENTO;
+                }
+                estado = NUMERO_MAP;
+                break;
+
+            case FIN_E:
+                if (c != 'N') return ERROR_FORMATO;
+                estado = FIN_EN;
+                break;
+
+            case FIN_EN:
+                if (c != 'D') return ERROR_FORMATO;
+                estado = FIN_END;
+                break;
+        }
+    }
+
+    switch (estado) {
+        case FIN_LOAD:
+            trama = Trama::carga(caracter);
+            return TRAMA_VALIDA;
+        case ESPACIO:
+            // "L,S" es la letra S; "L,Space" es un espacio
+            if (coincidencias == 0) {
+                trama = Trama::carga('S');
+                return TRAMA_VALIDA;
+            }
+            if (coincidencias == 4) {
+                trama = Trama::carga(' ');
+                return TRAMA_VALIDA;
+            }
+            return ERROR_FORMATO;
+        case NUMERO_MAP:
+            trama = Trama::mapeo(static_cast<int>(negativo ? -magnitud : magnitud), rotor < 0 ? 0 : rotor);
+            return TRAMA_VALIDA;
+        case FIN_END:
+            trama = Trama::fin();
+            return TRAMA_VALIDA;
+        default:
+            return ERROR_FORMATO;
+    }
+}
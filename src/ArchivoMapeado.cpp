@@ -0,0 +1,113 @@
+/**
+ * @file ArchivoMapeado.cpp
+ * @brief Implementación del mapeo de capturas en memoria
+ */
+
+#include "prt7/ArchivoMapeado.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+ArchivoMapeado::ArchivoMapeado() : datos(nullptr), tamano(0),
+#ifdef _WIN32
+    archivo(INVALID_HANDLE_VALUE), mapeo(NULL),
+#else
+    fd(-1),
+#endif
+    propio(false) {}
+
+ArchivoMapeado::~ArchivoMapeado() {
+    cerrar();
+}
+
+bool ArchivoMapeado::abrir(const char* ruta) {
+    cerrar();
+    bool entradaEstandar = strcmp(ruta, "-") == 0;
+
+#ifdef _WIN32
+    if (entradaEstandar) {
+        archivo = GetStdHandle(STD_INPUT_HANDLE);
+        propio = false;
+    } else {
+        archivo = CreateFileA(ruta, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        propio = true;
+    }
+    if (archivo == INVALID_HANDLE_VALUE || GetFileType(archivo) != FILE_TYPE_DISK) {
+        cerrar();
+        return false;
+    }
+
+    LARGE_INTEGER tamanoArchivo;
+    if (!GetFileSizeEx(archivo, &tamanoArchivo)) {
+        cerrar();
+        return false;
+    }
+    tamano = static_cast<size_t>(tamanoArchivo.QuadPart);
+    if (tamano == 0) {
+        return true;
+    }
+
+    mapeo = CreateFileMappingA(archivo, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapeo) {
+        cerrar();
+        return false;
+    }
+    datos = static_cast<const char*>(MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0));
+#else
+    if (entradaEstandar) {
+        fd = STDIN_FILENO;
+        propio = false;
+    } else {
+        fd = open(ruta, O_RDONLY);
+        propio = true;
+    }
+
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        cerrar();
+        return false;
+    }
+    tamano = static_cast<size_t>(info.st_size);
+    if (tamano == 0) {
+        return true;
+    }
+
+    void* region = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (region == MAP_FAILED) {
+        cerrar();
+        return false;
+    }
+    madvise(region, tamano, MADV_SEQUENTIAL);
+    datos = static_cast<const char*>(region);
+#endif
+
+    if (!datos) {
+        cerrar();
+        return false;
+    }
+    return true;
+}
+
+void ArchivoMapeado::cerrar() {
+#ifdef _WIN32
+    if (datos) UnmapViewOfFile(datos);
+    if (mapeo) CloseHandle(mapeo);
+    if (propio && archivo != INVALID_HANDLE_VALUE) CloseHandle(archivo);
+    archivo = INVALID_HANDLE_VALUE;
+    mapeo = NULL;
+#else
+    if (datos) munmap(const_cast<char*>(datos), tamano);
+    if (propio && fd >= 0) close(fd);
+    fd = -1;
+#endif
+    datos = nullptr;
+    tamano = 0;
+    propio = false;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file CodificadorTramas.cpp
+ * @brief Implementación del codificador de tramas y de la verificación de ida y vuelta
+ */
+
+#include "prt7/CodificadorTramas.h"
+#include "prt7/Decodificador.h"
+#include "prt7/Metricas.h"
+
+#include <cstdio>
+#include <cstring>
+
+// ============================================================================
+// CODIFICADOR
+// ============================================================================
+
+CodificadorTramas::CodificadorTramas(FormatoTramas f, SumideroCarga& d)
+    : formato(f), destino(d), cadena(nullptr), intervaloMapeo(0), hastaMapeo(0), estado(1), siguienteRotor(0),
+      usados(0), enRacha(0), tramas(0), noRepresentables(0), fallo(false) {}
+
+CodificadorTramas::~CodificadorTramas() {
+    delete cadena;
+}
+
+void CodificadorTramas::configurarRotores(int cantidad, bool avance) {
+    delete cadena;
+    cadena = new RotorCompuesto(cantidad, avance);
+}
+
+void CodificadorTramas::setIntervaloMapeo(int caracteres, unsigned semilla) {
+    intervaloMapeo = caracteres > 0 ? caracteres : 0;
+    hastaMapeo = intervaloMapeo;
+    estado = semilla ? semilla : 1;
+}
+
+void CodificadorTramas::escribir(const char* datos, int longitud) {
+    if (usados + longitud > CAPACIDAD) {
+        vaciar();
+    }
+    memcpy(buffer + usados, datos, longitud);
+    usados += longitud;
+}
+
+void CodificadorTramas::escribirVarint(unsigned long long valor) {
+    char bytes[10];
+    int n = 0;
+    do {
+        unsigned char b = static_cast<unsigned char>(valor & 0x7F);
+        valor >>= 7;
+        bytes[n++] = static_cast<char>(valor ? (b | 0x80) : b);
+    } while (valor);
+    escribir(bytes, n);
+}
+
+void CodificadorTramas::cerrarRacha() {
+    if (enRacha == 0) return;
+
+    if (enRacha == 1) {
+        char trama[2] = { static_cast<char>(AnalizadorBinario::ETIQUETA_CARGA), racha[0] };
+        escribir(trama, 2);
+    } else {
+        char etiqueta = static_cast<char>(AnalizadorBinario::ETIQUETA_RACHA);
+        escribir(&etiqueta, 1);
+        escribirVarint(static_cast<unsigned long long>(enRacha));
+        escribir(racha, enRacha);
+    }
+    enRacha = 0;
+}
+
+void CodificadorTramas::emitirCarga(char caracter) {
+    tramas++;
+    if (formato == FORMATO_BINARIO) {
+        racha[enRacha++] = caracter;
+        if (enRacha == MAXIMO_RACHA) {
+            cerrarRacha();
+        }
+        return;
+    }
+
+    if (caracter == ' ') {
+        escribir("L,Space\n", 8);
+    } else {
+        char trama[4] = { 'L', ',', caracter, '\n' };
+        escribir(trama, 4);
+    }
+}
+
+void CodificadorTramas::emitirMapeo(int indiceRotor, int rotacion) {
+    tramas++;
+    if (cadena) {
+        cadena->rotar(indiceRotor, rotacion);
+    } else {
+        rotor.rotar(rotacion);
+    }
+
+    if (formato == FORMATO_BINARIO) {
+        cerrarRacha();
+        // Zigzag: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+        unsigned long long zigzag = rotacion < 0 ? 2ULL * static_cast<unsigned long long>(-(rotacion + 1)) + 1
+                                                 : 2ULL * static_cast<unsigned long long>(rotacion);
+        if (indiceRotor == 0) {
+            char etiqueta = static_cast<char>(AnalizadorBinario::ETIQUETA_MAPEO);
+            escribir(&etiqueta, 1);
+        } else {
+            char cabecera[2] = { static_cast<char>(AnalizadorBinario::ETIQUETA_MAPEO_ROTOR),
+                                 static_cast<char>(indiceRotor) };
+            escribir(cabecera, 2);
+        }
+        escribirVarint(zigzag);
+        return;
+    }
+
+    char trama[32];
+    int n = indiceRotor == 0 ? snprintf(trama, sizeof(trama), "M,%d\n", rotacion)
+                             : snprintf(trama, sizeof(trama), "M,%d,%d\n", indiceRotor, rotacion);
+    escribir(trama, n);
+}
+
+void CodificadorTramas::codificar(const char* mensaje, size_t longitud) {
+    char invertidos[MAXIMO_RACHA];
+    size_t posicion = 0;
+
+    while (posicion < longitud) {
+        if (intervaloMapeo > 0 && hastaMapeo == 0) {
+            // xorshift32: rotaciones variadas pero repetibles con la misma semilla
+            estado ^= estado << 13;
+            estado ^= estado >> 17;
+            estado ^= estado << 5;
+            int rotacion = static_cast<int>(estado % (2 * ROTACION_MAXIMA + 1)) - ROTACION_MAXIMA;
+            int indice = cadena ? siguienteRotor++ % cadena->getCantidad() : 0;
+            emitirMapeo(indice, rotacion);
+            hastaMapeo = intervaloMapeo;
+        }
+
+        // Tramo sin MAP intermedio: con el rotor quieto se invierte en bloque
+        size_t n = longitud - posicion;
+        if (intervaloMapeo > 0 && n > static_cast<size_t>(hastaMapeo)) n = hastaMapeo;
+        if (n > static_cast<size_t>(MAXIMO_RACHA)) n = MAXIMO_RACHA;
+        const char* tramo = mensaje + posicion;
+
+        bool conAvance = cadena && cadena->tieneAvance();
+        if (!conAvance) {
+            RotorDeMapeo& r = cadena ? cadena->getCompuesto() : rotor;
+            r.invertirBloque(tramo, invertidos, n);
+        }
+
+        for (size_t k = 0; k < n; k++) {
+            char m = tramo[k];
+            if (formato == FORMATO_TEXTO && (m == '\n' || m == '\r')) {
+                // Un fin de línea cortaría la trama: no hay forma de enviarlo en texto
+                noRepresentables++;
+                continue;
+            }
+            int i = AlfabetoLatino::indice(static_cast<unsigned char>(m));
+            if (i >= 0 && AlfabetoLatino::simbolo(i) != m) {
+                noRepresentables++;
+            }
+
+            if (conAvance) {
+                emitirCarga(cadena->getInverso(m));
+                cadena->avanzar();
+            } else {
+                emitirCarga(invertidos[k]);
+            }
+        }
+
+        posicion += n;
+        if (intervaloMapeo > 0) {
+            hastaMapeo -= static_cast<int>(n);
+        }
+    }
+}
+
+void CodificadorTramas::finalizar() {
+    cerrarRacha();
+    if (formato == FORMATO_BINARIO) {
+        char etiqueta = static_cast<char>(AnalizadorBinario::ETIQUETA_FIN);
+        escribir(&etiqueta, 1);
+    } else {
+        escribir("END\n", 4);
+    }
+    tramas++;
+    vaciar();
+    destino.vaciar();
+}
+
+void CodificadorTramas::vaciar() {
+    if (usados > 0 && !destino.escribir(buffer, static_cast<size_t>(usados))) {
+        fallo = true;
+    }
+    usados = 0;
+}
+
+// ============================================================================
+// VERIFICACIÓN DE IDA Y VUELTA
+// ============================================================================
+
+/**
+ * @class SumideroDecodificador
+ * @brief Entrega cada bloque del flujo generado directamente a un Decodificador
+ */
+class SumideroDecodificador : public SumideroCarga {
+private:
+    Decodificador& decodificador;  ///< Sesión que recibe el flujo
+    long long bytes;               ///< Bytes entregados
+
+public:
+    /**
+     * @brief Constructor
+     * @param d Sesión que recibe el flujo
+     */
+    explicit SumideroDecodificador(Decodificador& d) : decodificador(d), bytes(0) {}
+
+    bool escribir(const char* datos, size_t cantidad) override {
+        bytes += static_cast<long long>(cantidad);
+        decodificador.alimentar(datos, cantidad);
+        return true;
+    }
+
+    /**
+     * @brief Bytes del flujo entregados
+     * @return Bytes
+     */
+    long long getBytes() const {
+        return bytes;
+    }
+};
+
+/**
+ * @class SumideroComparador
+ * @brief Compara el mensaje decodificado con la referencia mientras se ensambla
+ */
+class SumideroComparador : public SumideroCarga {
+private:
+    const char* referencia;    ///< Mensaje esperado
+    size_t longitud;           ///< Caracteres del mensaje esperado
+    size_t posicion;           ///< Caracteres recibidos
+    size_t primeraDiferencia;  ///< Primera posición distinta (longitud si no hay)
+
+public:
+    /**
+     * @brief Constructor
+     * @param r Mensaje esperado
+     * @param n Caracteres del mensaje esperado
+     */
+    SumideroComparador(const char* r, size_t n) : referencia(r), longitud(n), posicion(0), primeraDiferencia(n) {}
+
+    bool escribir(const char* datos, size_t cantidad) override {
+        if (primeraDiferencia == longitud) {
+            size_t comparables = posicion < longitud ? longitud - posicion : 0;
+            if (comparables > cantidad) comparables = cantidad;
+
+            // Los caracteres que sobren después de la referencia se notan en getPosicion()
+            if (memcmp(datos, referencia + posicion, comparables) != 0) {
+                size_t k = 0;
+                while (datos[k] == referencia[posicion + k]) k++;
+                primeraDiferencia = posicion + k;
+            }
+        }
+        posicion += cantidad;
+        return true;
+    }
+
+    /**
+     * @brief Caracteres recibidos
+     * @return Caracteres
+     */
+    size_t getPosicion() const {
+        return posicion;
+    }
+
+    /**
+     * @brief Primera posición en que el mensaje recibido difiere
+     * @return Posición, o la longitud de la referencia si todo lo recibido coincide
+     */
+    size_t getPrimeraDiferencia() const {
+        return primeraDiferencia;
+    }
+};
+
+ResultadoVerificacion verificarIdaVuelta(const char* mensaje, size_t longitud, FormatoTramas formato,
+                                         int rotores, bool avance, int intervaloMapeo, unsigned semilla) {
+    // Caracteres que el decodificador retiene: el resto sólo pasa por el comparador
+    static const size_t VENTANA = 4096;
+
+    long long inicio = relojMonotonicoNs();
+
+    SumideroComparador comparador(mensaje, longitud);
+    Decodificador decodificador(DETALLE_SILENCIOSO);
+    decodificador.setFormato(formato);
+    if (rotores > 1 || avance) {
+        decodificador.configurarRotores(rotores, avance);
+    }
+    decodificador.getCarga().configurarSalida(&comparador, VENTANA, false);
+
+    SumideroDecodificador entrada(decodificador);
+    CodificadorTramas codificador(formato, entrada);
+    if (rotores > 1 || avance) {
+        codificador.configurarRotores(rotores, avance);
+    }
+    codificador.setIntervaloMapeo(intervaloMapeo, semilla);
+    codificador.codificar(mensaje, longitud);
+    codificador.finalizar();
+    decodificador.finalizar();
+
+    ResultadoVerificacion r;
+    r.longitud = longitud;
+    r.decodificados = comparador.getPosicion();
+    r.primeraDiferencia = comparador.getPrimeraDiferencia() < comparador.getPosicion()
+                              ? comparador.getPrimeraDiferencia()
+                              : comparador.getPosicion();
+    r.coincide = r.decodificados == longitud && comparador.getPrimeraDiferencia() == longitud &&
+                 decodificador.haTerminado();
+    r.bytesFlujo = entrada.getBytes();
+    r.tramas = codificador.getTramas();
+    r.noRepresentables = codificador.getNoRepresentables();
+    r.tramasMalformadas = decodificador.getTramasMalformadas();
+    r.nanosegundos = relojMonotonicoNs() - inicio;
+    return r;
+}
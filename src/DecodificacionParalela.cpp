@@ -0,0 +1,244 @@
+/**
+ * @file DecodificacionParalela.cpp
+ * @brief Implementación de la decodificación en paralelo por suma de prefijos
+ */
+
+#include "prt7/DecodificacionParalela.h"
+#include "prt7/AnalizadorTramas.h"
+#include "prt7/MapeoVectorial.h"
+#include "prt7/Metricas.h"
+
+#include <thread>
+
+/// Tamaño mínimo de un tramo; por debajo no conviene crear más hilos
+static const size_t TRAMO_MINIMO = 1 << 20;
+
+/**
+ * @struct TramoCaptura
+ * @brief Porción de la captura que procesa un hilo
+ */
+struct TramoCaptura {
+    const char* inicio;          ///< Primer byte del tramo (inicio de línea)
+    const char* fin;             ///< Posición tras el último byte del tramo
+    int rotacionNeta;            ///< Suma de las rotaciones del tramo, módulo 26
+    long long cargas;            ///< Tramas LOAD antes de END
+    long long recibidas;         ///< Tramas válidas hasta END inclusive
+    long long malformadas;       ///< Líneas descartadas antes de END
+    bool contieneFin;            ///< true si el tramo contiene END
+    int desplazamientoInicial;   ///< Desplazamiento del rotor al empezar el tramo
+    long long posicionSalida;    ///< Posición del tramo en el buffer de salida
+};
+
+/**
+ * @brief Reduce una rotación al rango [0, 26)
+ * @param n Rotación con signo
+ * @return Rotación equivalente
+ */
+static int reducirRotacion(long long n) {
+    int r = static_cast<int>(n % RotorDeMapeo::TAMANO_ANILLO);
+    return r < 0 ? r + RotorDeMapeo::TAMANO_ANILLO : r;
+}
+
+/**
+ * @brief Recorre las líneas de un tramo hasta END
+ * @param tramo Tramo a recorrer
+ * @param accion Objeto con operator()(const Trama&) a aplicar a cada trama válida
+ *
+ * Separa las líneas igual que Decodificador::alimentar(): por '\n' o '\r',
+ * ignorando líneas vacías; la última línea puede no tener fin de línea.
+ */
+template <typename Accion>
+static void recorrerTramo(TramoCaptura& tramo, Accion& accion) {
+    const char* inicioLinea = tramo.inicio;
+    Trama trama;
+
+    for (const char* p = tramo.inicio; p <= tramo.fin; p++) {
+        if (p < tramo.fin && *p != '\n' && *p != '\r') {
+            continue;
+        }
+        if (p > inicioLinea) {
+            ErrorTrama resultado = analizarTrama(inicioLinea, static_cast<int>(p - inicioLinea), trama);
+            if (resultado == TRAMA_COMENTARIO) {
+                // Ni trama ni error (ej. marca de tiempo de una captura grabada)
+            } else if (resultado != TRAMA_VALIDA || trama.rotor != 0) {
+                // Con el rotor único, M,<rotor>,<n> sólo es válida para el rotor 0
+                tramo.malformadas++;
+            } else {
+                tramo.recibidas++;
+                if (trama.tipo == TRAMA_FIN) {
+                    tramo.contieneFin = true;
+                    return;
+                }
+                accion(trama);
+            }
+        }
+        inicioLinea = p + 1;
+    }
+}
+
+/**
+ * @struct Resumen
+ * @brief Primera pasada: acumula rotación neta y cargas
+ */
+struct Resumen {
+    TramoCaptura& tramo;  ///< Tramo que se resume
+    long long neta;       ///< Rotación acumulada sin reducir
+
+    void operator()(const Trama& trama) {
+        if (trama.tipo == TRAMA_LOAD) {
+            tramo.cargas++;
+        } else {
+            neta += reducirRotacion(trama.rotacion);
+        }
+    }
+};
+
+/**
+ * @struct Decodificacion
+ * @brief Segunda pasada: decodifica las cargas con el desplazamiento del tramo
+ *
+ * Los caracteres se copian crudos y cada racha entre dos MAP se mapea en su
+ * lugar con mapearBloqueCesar().
+ */
+struct Decodificacion {
+    int desplazamiento;  ///< Desplazamiento del rotor en la racha actual
+    char* racha;         ///< Inicio de la racha actual en el buffer común
+    char* salida;        ///< Siguiente posición del buffer común
+
+    void operator()(const Trama& trama) {
+        if (trama.tipo == TRAMA_LOAD) {
+            *salida++ = trama.caracter;
+        } else {
+            cerrarRacha();
+            desplazamiento = (desplazamiento + reducirRotacion(trama.rotacion)) % RotorDeMapeo::TAMANO_ANILLO;
+        }
+    }
+
+    void cerrarRacha() {
+        mapearBloqueCesar(racha, racha, static_cast<size_t>(salida - racha), desplazamiento);
+        racha = salida;
+    }
+};
+
+/**
+ * @brief Cuerpo de la primera pasada
+ * @param tramo Tramo a resumir
+ */
+static void resumirTramo(TramoCaptura* tramo) {
+    Resumen resumen = {*tramo, 0};
+    recorrerTramo(*tramo, resumen);
+    tramo->rotacionNeta = reducirRotacion(resumen.neta);
+}
+
+/**
+ * @brief Cuerpo de la segunda pasada
+ * @param tramo Tramo a decodificar
+ * @param salida Buffer común de caracteres decodificados
+ */
+static void decodificarTramo(TramoCaptura* tramo, char* salida) {
+    // Los contadores ya se obtuvieron en la primera pasada
+    TramoCaptura copia = *tramo;
+    copia.recibidas = copia.malformadas = 0;
+
+    char* inicio = salida + tramo->posicionSalida;
+    Decodificacion decodificacion = {tramo->desplazamientoInicial, inicio, inicio};
+    recorrerTramo(copia, decodificacion);
+    decodificacion.cerrarRacha();
+}
+
+/**
+ * @brief Ejecuta una pasada con un hilo por tramo
+ * @param tramos Tramos a procesar
+ * @param cantidad Cantidad de tramos
+ * @param salida Buffer común, o nullptr para la primera pasada
+ */
+static void ejecutarPasada(TramoCaptura* tramos, int cantidad, char* salida) {
+    std::thread* grupo = new std::thread[cantidad];
+    for (int k = 0; k < cantidad; k++) {
+        if (salida) {
+            grupo[k] = std::thread(decodificarTramo, &tramos[k], salida);
+        } else {
+            grupo[k] = std::thread(resumirTramo, &tramos[k]);
+        }
+    }
+    for (int k = 0; k < cantidad; k++) {
+        grupo[k].join();
+    }
+    delete[] grupo;
+}
+
+int decodificarEnParalelo(const char* datos, size_t longitud, Decodificador& decodificador, int hilos) {
+    if (decodificador.getSalida().getNivel() != DETALLE_SILENCIOSO || decodificador.haTerminado() ||
+        decodificador.getCadena() || decodificador.getFormato() != FORMATO_TEXTO) {
+        // Los reportes por trama deben salir en orden, el avance de una
+        // cadena de rotores depende de cada carácter anterior, y el formato
+        // binario no tiene fines de línea donde cortar los tramos
+        decodificador.alimentar(datos, longitud);
+        decodificador.finalizar();
+        return 1;
+    }
+
+    int cantidad = hilos > 0 ? hilos : static_cast<int>(std::thread::hardware_concurrency());
+    if (cantidad < 1) cantidad = 1;
+    if (static_cast<size_t>(cantidad) > longitud / TRAMO_MINIMO) {
+        cantidad = static_cast<int>(longitud / TRAMO_MINIMO);
+    }
+    if (cantidad < 1) cantidad = 1;
+
+    // Cortar la captura en fines de línea
+    TramoCaptura* tramos = new TramoCaptura[cantidad];
+    const char* fin = datos + longitud;
+    const char* corte = datos;
+    for (int k = 0; k < cantidad; k++) {
+        TramoCaptura& t = tramos[k];
+        t.inicio = corte;
+        if (k == cantidad - 1) {
+            corte = fin;
+        } else {
+            const char* objetivo = datos + (longitud / cantidad) * (k + 1);
+            if (objetivo > corte) corte = objetivo;
+            while (corte < fin && *corte != '\n' && *corte != '\r') corte++;
+            if (corte < fin) corte++;
+        }
+        t.fin = corte;
+        t.rotacionNeta = 0;
+        t.cargas = t.recibidas = t.malformadas = 0;
+        t.contieneFin = false;
+    }
+
+    // Primera pasada: rotación neta, cargas y END de cada tramo
+    ejecutarPasada(tramos, cantidad, nullptr);
+
+    // Suma de prefijos exclusiva hasta el tramo que contiene END
+    int desplazamiento = decodificador.getRotor().getDesplazamiento();
+    long long posicion = 0;
+    long long recibidas = 0;
+    long long malformadas = 0;
+    bool vistoFin = false;
+    int utiles = 0;
+    for (int k = 0; k < cantidad && !vistoFin; k++) {
+        tramos[k].desplazamientoInicial = desplazamiento;
+        tramos[k].posicionSalida = posicion;
+        desplazamiento = (desplazamiento + tramos[k].rotacionNeta) % RotorDeMapeo::TAMANO_ANILLO;
+        posicion += tramos[k].cargas;
+        recibidas += tramos[k].recibidas;
+        malformadas += tramos[k].malformadas;
+        vistoFin = tramos[k].contieneFin;
+        utiles++;
+    }
+
+    // Segunda pasada: cada tramo decodifica en su lugar
+    char* salida = new char[posicion > 0 ? posicion : 1];
+    ejecutarPasada(tramos, utiles, salida);
+
+    decodificador.getCarga().insertarBloque(salida, static_cast<size_t>(posicion));
+    decodificador.getRotor().rotar(desplazamiento - decodificador.getRotor().getDesplazamiento());
+    decodificador.registrarResultado(recibidas, malformadas, posicion, vistoFin);
+    decodificador.getCarga().vaciarSumidero();
+    decodificador.publicarMetricas();
+    RegistroMetricas::global().sumar(METRICA_BYTES_LEIDOS, longitud);
+
+    delete[] salida;
+    delete[] tramos;
+    return cantidad;
+}
@@ -0,0 +1,462 @@
+/**
+ * @file Decodificador.cpp
+ * @brief Implementación de la sesión de decodificación
+ */
+
+#include "prt7/Decodificador.h"
+#include "prt7/AgrupadorTramas.h"
+#include "prt7/AnalizadorTramas.h"
+#include "prt7/Metricas.h"
+#include "prt7/PuntoControl.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+/// Cantidad máxima de tramas que se analizan antes de despacharlas
+static const int TAMANO_LOTE = 64;
+
+/// Caracteres de una racha de LOAD que se mapean juntos
+static const int TAMANO_BLOQUE = 256;
+
+Decodificador::Decodificador(NivelDetalle nivel)
+    : cadena(nullptr), salida(nivel), tramasRecibidas(0), tramasMalformadas(0), tramasCarga(0),
+      movimientosRotor(0), finTransmision(false), observador(nullptr), formato(FORMATO_TEXTO), usadosPendiente(0),
+      pendienteTruncado(false) {
+    memset(&publicado, 0, sizeof(publicado));
+}
+
+Decodificador::Decodificador(NivelDetalle nivel, std::ostream& flujo)
+    : cadena(nullptr), salida(nivel, flujo), tramasRecibidas(0), tramasMalformadas(0), tramasCarga(0),
+      movimientosRotor(0), finTransmision(false), observador(nullptr), formato(FORMATO_TEXTO), usadosPendiente(0),
+      pendienteTruncado(false) {
+    memset(&publicado, 0, sizeof(publicado));
+}
+
+Decodificador::~Decodificador() {
+    delete cadena;
+}
+
+void Decodificador::configurarRotores(int cantidad, bool avance) {
+    delete cadena;
+    cadena = new RotorCompuesto(cantidad, avance);
+}
+
+void Decodificador::procesarConCadena(const Trama* tramas, int cantidad) {
+    for (int i = 0; i < cantidad && !finTransmision; i++) {
+        const Trama& trama = tramas[i];
+
+        switch (trama.tipo) {
+            case TRAMA_LOAD:
+                procesarCarga(trama.caracter, &carga, &cadena->getCompuesto(), salida);
+                tramasCarga++;
+                if (cadena->tieneAvance()) {
+                    cadena->avanzar();
+                    movimientosRotor++;
+                }
+                break;
+            case TRAMA_MAP:
+                if (salida.getNivel() == DETALLE_SILENCIOSO) {
+                    // Sin reportes, una ráfaga al mismo rotor es un solo movimiento
+                    int neta;
+                    int n = agruparMapeos(tramas + i, cantidad - i, neta);
+                    if (cadena->rotar(trama.rotor, neta)) {
+                        tramasRecibidas += n;
+                        movimientosRotor += n;
+                    } else {
+                        tramasMalformadas += n;
+                    }
+                    i += n - 1;
+                    continue;
+                }
+                if (!cadena->rotar(trama.rotor, trama.rotacion)) {
+                    // El rotor indicado no existe en la cadena
+                    tramasMalformadas++;
+                    continue;
+                }
+                movimientosRotor++;
+                if (salida.getNivel() != DETALLE_SILENCIOSO) {
+                    reportarMapeo(trama.rotacion, salida, trama.rotor);
+                }
+                break;
+            case TRAMA_FIN:
+                finTransmision = true;
+                break;
+        }
+        tramasRecibidas++;
+    }
+}
+
+void Decodificador::procesarTramas(const Trama* tramas, int cantidad) {
+    if (observador && cantidad > 0 && !finTransmision) {
+        // Lo que sigue a END no se aplica: el observador tampoco lo ve
+        int hastaFin = 0;
+        while (hastaFin < cantidad && tramas[hastaFin++].tipo != TRAMA_FIN) {}
+        observador->tramasRecibidas(tramas, hastaFin);
+    }
+
+    if (cadena) {
+        procesarConCadena(tramas, cantidad);
+        return;
+    }
+
+    if (salida.getNivel() != DETALLE_SILENCIOSO) {
+        // Cada trama se reporta: procesarlas de una en una
+        for (int i = 0; i < cantidad && !finTransmision; i++) {
+            if (tramas[i].rotor != 0) {
+                // Con el rotor único sólo existe el rotor 0
+                tramasMalformadas++;
+                continue;
+            }
+            tramasRecibidas++;
+            tramasCarga += tramas[i].tipo == TRAMA_LOAD;
+            movimientosRotor += tramas[i].tipo == TRAMA_MAP;
+            if (!despacharTrama(tramas[i], &carga, &rotor, salida)) {
+                finTransmision = true;
+            }
+        }
+        return;
+    }
+
+    // Sin reportes, una racha de LOAD sin MAP intermedio es un solo
+    // desplazamiento: mapearla en bloque y agregarla de una vez. Las
+    // ráfagas de MAP se suman en una rotación neta y las de un mismo
+    // carácter se agregan con un relleno
+    char bloque[TAMANO_BLOQUE];
+    int i = 0;
+    while (i < cantidad && !finTransmision) {
+        if (tramas[i].tipo != TRAMA_LOAD) {
+            if (tramas[i].rotor != 0) {
+                tramasMalformadas++;
+                i++;
+                continue;
+            }
+            if (tramas[i].tipo == TRAMA_MAP) {
+                int neta;
+                int n = agruparMapeos(tramas + i, cantidad - i, neta);
+                rotor.rotar(neta);
+                tramasRecibidas += n;
+                movimientosRotor += n;
+                i += n;
+                continue;
+            }
+            tramasRecibidas++;
+            finTransmision = true;
+            i++;
+            continue;
+        }
+
+        int n = 0;
+        int repetidos = 0;
+        while (i < cantidad && n < TAMANO_BLOQUE && tramas[i].tipo == TRAMA_LOAD) {
+            if (i + 1 < cantidad && tramas[i + 1].caracter == tramas[i].caracter &&
+                (repetidos = agruparRepetidos(tramas + i, cantidad - i)) >= RACHA_MINIMA_RELLENO) {
+                break;
+            }
+            repetidos = 0;
+            bloque[n++] = tramas[i++].caracter;
+        }
+        if (n > 0) {
+            rotor.mapearBloque(bloque, bloque, n);
+            carga.insertarBloque(bloque, n);
+        }
+        if (repetidos > 0) {
+            carga.rellenar(rotor.getMapeo(tramas[i].caracter), repetidos);
+            i += repetidos;
+            n += repetidos;
+        }
+        tramasRecibidas += n;
+        tramasCarga += n;
+    }
+}
+
+void Decodificador::publicarMetricas() {
+    RegistroMetricas& m = RegistroMetricas::global();
+    bool fin = finTransmision && !publicado.fin;
+
+    m.sumar(METRICA_TRAMAS_LOAD, tramasCarga - publicado.cargas);
+    m.sumar(METRICA_TRAMAS_MAP, (tramasRecibidas - publicado.recibidas) - (tramasCarga - publicado.cargas) - (fin ? 1 : 0));
+    m.sumar(METRICA_TRAMAS_FIN, fin ? 1 : 0);
+    m.sumar(METRICA_TRAMAS_MALFORMADAS, tramasMalformadas - publicado.malformadas);
+    m.sumar(METRICA_ROTACIONES, movimientosRotor - publicado.movimientos);
+
+    publicado.recibidas = tramasRecibidas;
+    publicado.malformadas = tramasMalformadas;
+    publicado.cargas = tramasCarga;
+    publicado.movimientos = movimientosRotor;
+    publicado.fin = finTransmision;
+}
+
+void Decodificador::capturarEstado(InstantaneaSesion& destino) const {
+    destino.tramasRecibidas = tramasRecibidas;
+    destino.tramasMalformadas = tramasMalformadas;
+    destino.tramasCarga = tramasCarga;
+    destino.movimientosRotor = movimientosRotor;
+    destino.finTransmision = finTransmision;
+    destino.formato = formato;
+
+    destino.cantidadRotores = cadena ? cadena->getCantidad() : 0;
+    destino.avance = cadena && cadena->tieneAvance();
+    if (cadena) {
+        for (int i = 0; i < cadena->getCantidad(); i++) {
+            destino.desplazamientos[i] = cadena->getRotor(i).getDesplazamiento();
+        }
+    } else {
+        destino.desplazamientos[0] = rotor.getDesplazamiento();
+    }
+
+    memcpy(destino.linea, pendiente, usadosPendiente);
+    destino.longitudLinea = usadosPendiente;
+    destino.lineaTruncada = pendienteTruncado;
+    binario.capturar(destino.binario);
+}
+
+bool Decodificador::restaurarEstado(const InstantaneaSesion& origen) {
+    int cantidad = cadena ? cadena->getCantidad() : 0;
+    bool avance = cadena && cadena->tieneAvance();
+    if (origen.cantidadRotores != cantidad || origen.avance != avance || origen.formato != formato) {
+        return false;
+    }
+
+    if (cadena) {
+        for (int i = 0; i < cantidad; i++) {
+            cadena->rotar(i, origen.desplazamientos[i] - cadena->getRotor(i).getDesplazamiento());
+        }
+    } else {
+        rotor.rotar(origen.desplazamientos[0] - rotor.getDesplazamiento());
+    }
+
+    tramasRecibidas = origen.tramasRecibidas;
+    tramasMalformadas = origen.tramasMalformadas;
+    tramasCarga = origen.tramasCarga;
+    movimientosRotor = origen.movimientosRotor;
+    finTransmision = origen.finTransmision;
+
+    // Lo restaurado ya se publicó en el proceso que guardó la instantánea
+    publicado.recibidas = tramasRecibidas;
+    publicado.malformadas = tramasMalformadas;
+    publicado.cargas = tramasCarga;
+    publicado.movimientos = movimientosRotor;
+    publicado.fin = finTransmision;
+    return true;
+}
+
+bool Decodificador::restaurarAnalizador(const InstantaneaSesion& origen) {
+    if (origen.longitudLinea < 0 || origen.longitudLinea > LONGITUD_MAXIMA_LINEA) {
+        return false;
+    }
+    memcpy(pendiente, origen.linea, origen.longitudLinea);
+    usadosPendiente = origen.longitudLinea;
+    pendienteTruncado = origen.lineaTruncada;
+    return binario.restaurar(origen.binario);
+}
+
+void Decodificador::procesarLinea(const char* linea, int longitud) {
+    if (finTransmision) return;
+
+    Trama trama;
+    ErrorTrama resultado = analizarTrama(linea, longitud, trama);
+    if (resultado == TRAMA_VALIDA) {
+        procesarTramas(&trama, 1);
+    } else if (resultado != TRAMA_COMENTARIO) {
+        tramasMalformadas++;
+    }
+}
+
+void Decodificador::acumularPendiente(const char* datos, size_t longitud) {
+    size_t libres = LONGITUD_MAXIMA_LINEA - usadosPendiente;
+    if (longitud > libres) {
+        longitud = libres;
+        pendienteTruncado = true;
+    }
+    memcpy(pendiente + usadosPendiente, datos, longitud);
+    usadosPendiente += static_cast<int>(longitud);
+}
+
+void Decodificador::procesarPendiente() {
+    if (pendienteTruncado) {
+        // Ninguna trama válida es tan larga; un comentario sí puede serlo
+        if (pendiente[0] != MARCA_COMENTARIO) {
+            tramasMalformadas++;
+        }
+    } else if (usadosPendiente > 0) {
+        procesarLinea(pendiente, usadosPendiente);
+    }
+    usadosPendiente = 0;
+    pendienteTruncado = false;
+}
+
+bool Decodificador::alimentar(const char* datos, size_t longitud) {
+    if (finTransmision) {
+        return false;
+    }
+    RegistroMetricas::global().sumar(METRICA_BYTES_LEIDOS, longitud);
+
+    if (formato == FORMATO_BINARIO) {
+        alimentarBinario(datos, longitud);
+        salida.vaciar();
+        carga.vaciarSumidero();
+        publicarMetricas();
+        return !finTransmision;
+    }
+
+    size_t i = 0;
+
+    if (usadosPendiente > 0 || pendienteTruncado) {
+        // Completar la línea que quedó partida en el bloque anterior
+        while (i < longitud && datos[i] != '\n' && datos[i] != '\r') {
+            i++;
+        }
+        acumularPendiente(datos, i);
+        if (i == longitud) {
+            return !finTransmision;
+        }
+        procesarPendiente();
+        i++;
+    }
+
+    // Analizar por lotes para que procesarTramas() vea rachas de LOAD
+    Trama lote[TAMANO_LOTE];
+    int enLote = 0;
+    size_t inicio = i;
+    for (; i < longitud && !finTransmision; i++) {
+        if (datos[i] == '\n' || datos[i] == '\r') {
+            if (i > inicio) {
+                Trama& trama = lote[enLote];
+                ErrorTrama resultado = analizarTrama(datos + inicio, static_cast<int>(i - inicio), trama);
+                if (resultado != TRAMA_VALIDA) {
+                    if (resultado != TRAMA_COMENTARIO) tramasMalformadas++;
+                } else if (++enLote == TAMANO_LOTE || trama.tipo == TRAMA_FIN) {
+                    // END se despacha enseguida: lo que sigue ya no cuenta
+                    procesarTramas(lote, enLote);
+                    enLote = 0;
+                }
+            }
+            inicio = i + 1;
+        }
+    }
+    procesarTramas(lote, enLote);
+
+    if (!finTransmision && inicio < longitud) {
+        acumularPendiente(datos + inicio, longitud - inicio);
+    }
+
+    // Vaciar la salida una vez por bloque en lugar de una vez por línea
+    salida.vaciar();
+    carga.vaciarSumidero();
+    publicarMetricas();
+    return !finTransmision;
+}
+
+void Decodificador::alimentarBinario(const char* datos, size_t longitud) {
+    Trama lote[TAMANO_LOTE];
+    size_t posicion = 0;
+
+    while (posicion < longitud && !finTransmision) {
+        size_t consumidos = 0;
+        int malformadas = 0;
+        int cantidad = binario.analizar(datos + posicion, longitud - posicion, consumidos,
+                                        lote, TAMANO_LOTE, malformadas);
+        tramasMalformadas += malformadas;
+        procesarTramas(lote, cantidad);
+        posicion += consumidos;
+    }
+}
+
+void Decodificador::finalizar() {
+    if (!finTransmision && formato == FORMATO_BINARIO) {
+        if (binario.enTrama()) {
+            // El flujo se cerró a mitad de una trama
+            tramasMalformadas++;
+        }
+        binario.reiniciar();
+    } else if (!finTransmision) {
+        procesarPendiente();
+    }
+    usadosPendiente = 0;
+    pendienteTruncado = false;
+    salida.vaciar();
+    carga.vaciarSumidero();
+    publicarMetricas();
+}
+
+void Decodificador::procesarLector(LectorSerial& lector) {
+    Trama lote[TAMANO_LOTE];
+    int malformadas = 0;
+    int cantidad;
+
+    while (!finTransmision && (cantidad = lector.extraerTramas(lote, TAMANO_LOTE, malformadas)) > 0) {
+        procesarTramas(lote, cantidad);
+    }
+    tramasMalformadas += malformadas;
+
+    // Vaciar la salida una vez por lote en lugar de una vez por línea
+    salida.vaciar();
+    carga.vaciarSumidero();
+    publicarMetricas();
+
+    if (lector.getInstanteLectura() != 0) {
+        RegistroMetricas::global().registrarLatencia(relojMonotonicoNs() - lector.getInstanteLectura());
+    }
+}
+
+void Decodificador::esperarPresupuesto() {
+    const std::chrono::milliseconds pausa(static_cast<int>(ESPERA_PRESUPUESTO_MS));
+    while (!carga.aliviarPresupuesto()) {
+        RegistroMetricas::global().sumar(METRICA_ESPERAS_PRESUPUESTO, 1);
+        std::this_thread::sleep_for(pausa);
+    }
+}
+
+void decodificarFlujo(LectorSerial& lector, Decodificador& decodificador, int inactividadMs,
+                      PuntoControl* puntoControl) {
+    PlazoInactividad plazo(inactividadMs);
+    if (puntoControl) {
+        puntoControl->prepararEntrada(decodificador, &lector);
+    }
+    // Lo que el lector ya tenga (ej. lo recibido al detectar el puerto) va primero
+    decodificador.procesarLector(lector);
+
+    while (!decodificador.haTerminado()) {
+        // Sin lugar en memoria para el mensaje, el flujo espera en el puerto
+        if (decodificador.getCarga().excedePresupuesto()) {
+            decodificador.esperarPresupuesto();
+            plazo.registrarActividad();
+        }
+
+        // Esperar (sin dormir) a que llegue el siguiente bloque o venza el plazo
+        int leidos = lector.rellenar(plazo.acotarEspera(-1));
+        if (leidos < 0 || (leidos == 0 && plazo.vencido())) {
+            // Fin de datos o emisor inactivo: guardar antes de procesar una última
+            // línea sin fin de línea, para que una sesión retomada la complete
+            if (puntoControl) {
+                puntoControl->guardar(decodificador, &lector, 0);
+                puntoControl = nullptr;
+            }
+            const char* linea;
+            int longitud;
+            if (lector.extraerResto(linea, longitud)) {
+                decodificador.procesarLinea(linea, longitud);
+            }
+            break;
+        }
+        if (leidos == 0) {
+            continue;
+        }
+        plazo.registrarActividad();
+
+        // Procesar todas las tramas completas del bloque
+        decodificador.procesarLector(lector);
+        if (puntoControl) {
+            puntoControl->guardarSiVence(decodificador, &lector, 0);
+        }
+    }
+
+    decodificador.getSalida().vaciar();
+    decodificador.getCarga().vaciarSumidero();
+    decodificador.publicarMetricas();
+    // Si terminó por END no queda nada a medias
+    if (puntoControl) {
+        puntoControl->guardar(decodificador, &lector, 0);
+    }
+}
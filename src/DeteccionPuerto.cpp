@@ -0,0 +1,230 @@
+/**
+ * @file DeteccionPuerto.cpp
+ * @brief Implementación de la búsqueda del puerto de la transmisión
+ */
+
+#include "prt7/DeteccionPuerto.h"
+#include "prt7/Metricas.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <dirent.h>
+    #include <poll.h>
+    #include <cerrno>
+#endif
+
+#ifdef _WIN32
+/// Puertos COM que se prueban sin prefijo propio
+static const int MAXIMO_COM = 32;
+#else
+/// Prefijos de los adaptadores USB-serie y de las placas con USB CDC (Arduino)
+static const char* const PREFIJOS_POSIX[] = {"/dev/ttyUSB", "/dev/ttyACM"};
+static const int CANTIDAD_PREFIJOS = sizeof(PREFIJOS_POSIX) / sizeof(PREFIJOS_POSIX[0]);
+#endif
+
+DetectorPuertos::DetectorPuertos(const ConfiguracionSerial& base, const char* prefijoNombres)
+    : config(base), prefijo(prefijoNombres), cantidad(0), probados(0) {}
+
+DetectorPuertos::~DetectorPuertos() {
+    while (cantidad > 0) {
+        descartar(cantidad - 1);
+    }
+}
+
+bool DetectorPuertos::estaAbierto(const char* nombre) const {
+    for (int i = 0; i < cantidad; i++) {
+        if (strcmp(candidatos[i].nombre, nombre) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DetectorPuertos::probar(const char* nombre) {
+    if (cantidad == MAXIMO_CANDIDATOS || strlen(nombre) >= static_cast<size_t>(PuertoDetectado::LONGITUD_NOMBRE) ||
+        estaAbierto(nombre)) {
+        return;
+    }
+
+    ConfiguracionSerial c = config;
+    c.puerto = nombre;
+    DescriptorPuerto puerto = abrirPuertoSerial(c);
+    if (puerto == PUERTO_INVALIDO) {
+        // Inexistente, ocupado o aún sin permisos: se reintenta en el próximo recorrido
+        return;
+    }
+
+    Candidato& nuevo = candidatos[cantidad++];
+    strcpy(nuevo.nombre, nombre);
+    nuevo.puerto = puerto;
+    nuevo.lector = new LectorSerial(puerto);
+    nuevo.lector->setFormato(config.formato);
+    probados++;
+}
+
+#ifdef _WIN32
+void DetectorPuertos::recorrerPrefijo(const char* inicioNombre) {
+    char nombre[PuertoDetectado::LONGITUD_NOMBRE];
+    for (int n = 1; n <= MAXIMO_COM; n++) {
+        snprintf(nombre, sizeof(nombre), "%s%d", inicioNombre, n);
+        probar(nombre);
+    }
+}
+
+void DetectorPuertos::reescanear() {
+    recorrerPrefijo(prefijo ? prefijo : "COM");
+}
+#else
+void DetectorPuertos::recorrerPrefijo(const char* ruta) {
+    // Separar el directorio del principio del nombre
+    const char* barra = strrchr(ruta, '/');
+    char directorio[PuertoDetectado::LONGITUD_NOMBRE];
+    size_t largoDirectorio = barra ? static_cast<size_t>(barra - ruta) + 1 : 0;
+    if (largoDirectorio >= sizeof(directorio)) {
+        return;
+    }
+    memcpy(directorio, ruta, largoDirectorio);
+    directorio[largoDirectorio] = '\0';
+    const char* inicioNombre = ruta + largoDirectorio;
+    size_t largoInicio = strlen(inicioNombre);
+
+    DIR* dir = opendir(largoDirectorio > 0 ? directorio : ".");
+    if (!dir) {
+        return;
+    }
+
+    char nombre[PuertoDetectado::LONGITUD_NOMBRE];
+    struct dirent* entrada;
+    while ((entrada = readdir(dir)) != nullptr) {
+        if (entrada->d_name[0] == '.' || strncmp(entrada->d_name, inicioNombre, largoInicio) != 0) {
+            continue;
+        }
+        if (snprintf(nombre, sizeof(nombre), "%s%s", directorio, entrada->d_name) < static_cast<int>(sizeof(nombre))) {
+            probar(nombre);
+        }
+    }
+    closedir(dir);
+}
+
+void DetectorPuertos::reescanear() {
+    if (prefijo) {
+        recorrerPrefijo(prefijo);
+        return;
+    }
+    for (int i = 0; i < CANTIDAD_PREFIJOS; i++) {
+        recorrerPrefijo(PREFIJOS_POSIX[i]);
+    }
+}
+#endif
+
+void DetectorPuertos::descartar(int indice) {
+    Candidato& c = candidatos[indice];
+    cerrarPuertoSerial(c.puerto);
+    delete c.lector;
+
+    // Mantener los candidatos contiguos
+    candidatos[indice] = candidatos[--cantidad];
+}
+
+int DetectorPuertos::atender(int indice, int timeoutMs) {
+    LectorSerial* lector = candidatos[indice].lector;
+    int leidos = lector->rellenar(timeoutMs);
+    if (leidos < 0) {
+        return -1;
+    }
+    if (leidos > 0 && lector->contieneTramaValida()) {
+        return 1;
+    }
+    return 0;
+}
+
+void DetectorPuertos::elegir(int indice, PuertoDetectado& resultado) {
+    Candidato& c = candidatos[indice];
+    strcpy(resultado.nombre, c.nombre);
+    resultado.puerto = c.puerto;
+    resultado.lector = c.lector;
+
+    // El elegido sale de la lista sin cerrarse; el resto se cierra sin esperarlo
+    candidatos[indice] = candidatos[--cantidad];
+    while (cantidad > 0) {
+        descartar(cantidad - 1);
+    }
+}
+
+bool DetectorPuertos::detectar(int limiteMs, PuertoDetectado& resultado) {
+    long long inicio = relojMonotonicoNs();
+    long long ultimoRecorrido = 0;
+    bool recorrido = false;
+
+    for (;;) {
+        long long ahora = relojMonotonicoNs();
+        if (!recorrido || ahora - ultimoRecorrido >= INTERVALO_REESCANEO_MS * 1000000LL) {
+            reescanear();
+            ultimoRecorrido = ahora;
+            recorrido = true;
+        }
+
+        int espera = ESPERA_MS;
+        if (limiteMs > 0) {
+            long long restante = limiteMs - (ahora - inicio) / 1000000;
+            if (restante <= 0) {
+                return false;
+            }
+            if (restante < espera) {
+                espera = static_cast<int>(restante);
+            }
+        }
+
+#ifdef _WIN32
+        // Sin poll() sobre puertos COM: repartir la espera entre los candidatos
+        if (cantidad == 0) {
+            Sleep(espera);
+            continue;
+        }
+        int porPuerto = espera / cantidad;
+        if (porPuerto < 1) porPuerto = 1;
+        for (int i = 0; i < cantidad; i++) {
+            int estado = atender(i, porPuerto);
+            if (estado > 0) {
+                elegir(i, resultado);
+                return true;
+            }
+            if (estado < 0) {
+                descartar(i--);
+            }
+        }
+#else
+        struct pollfd fds[MAXIMO_CANDIDATOS];
+        for (int i = 0; i < cantidad; i++) {
+            fds[i].fd = candidatos[i].puerto;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+
+        // Sin candidatos, poll() sólo espera hasta el próximo recorrido
+        int listos = poll(fds, cantidad, espera);
+        if (listos < 0 && errno != EINTR) {
+            return false;
+        }
+        if (listos <= 0) {
+            continue;
+        }
+
+        for (int i = cantidad - 1; i >= 0; i--) {
+            if (fds[i].revents == 0) continue;
+
+            int estado = atender(i, 0);
+            if (estado > 0) {
+                elegir(i, resultado);
+                return true;
+            }
+            if (estado < 0) {
+                // Desconectado o sin emisor: cerrarlo y reintentarlo en el próximo recorrido
+                descartar(i);
+            }
+        }
+#endif
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file EscritorSalida.cpp
+ * @brief Implementación de la salida con buffer
+ */
+
+#include "prt7/EscritorSalida.h"
+
+#include <iostream>
+
+EscritorSalida::EscritorSalida(NivelDetalle n) : usados(0), nivel(n), destino(&std::cout) {}
+
+EscritorSalida::EscritorSalida(NivelDetalle n, std::ostream& flujo)
+    : usados(0), nivel(n), destino(&flujo) {}
+
+EscritorSalida::~EscritorSalida() {
+    vaciar();
+}
+
+EscritorSalida& EscritorSalida::predeterminado() {
+    static EscritorSalida escritor(DETALLE_TRAZA);
+    return escritor;
+}
+
+void EscritorSalida::escribirDestino(const char* texto, int longitud) {
+    destino->write(texto, longitud);
+}
+
+void EscritorSalida::escribirEntero(long long valor) {
+    char digitos[24];
+    int pos = sizeof(digitos);
+    unsigned long long magnitud = valor < 0 ? 0ULL - static_cast<unsigned long long>(valor)
+                                            : static_cast<unsigned long long>(valor);
+    do {
+        digitos[--pos] = static_cast<char>('0' + magnitud % 10);
+        magnitud /= 10;
+    } while (magnitud > 0);
+    if (valor < 0) {
+        digitos[--pos] = '-';
+    }
+    escribir(digitos + pos, static_cast<int>(sizeof(digitos)) - pos);
+}
+
+void EscritorSalida::vaciar() {
+    if (usados > 0) {
+        escribirDestino(buffer, usados);
+        usados = 0;
+    }
+    destino->flush();
+}
@@ -0,0 +1,235 @@
+/**
+ * @file GrabadorCaptura.cpp
+ * @brief Implementación del grabador de capturas
+ */
+
+#include "prt7/GrabadorCaptura.h"
+#include "prt7/AnalizadorTramas.h"
+#include "prt7/Metricas.h"
+
+#include <chrono>
+#include <cstring>
+
+GrabadorCaptura::GrabadorCaptura(FormatoTramas f)
+    : archivo(nullptr), formato(f), anillo(new char[CAPACIDAD_ANILLO]), cabeza(0), cola(0), grabados(0),
+      perdidos(0), detenido(false), registro(new char[MAXIMO_REGISTRO]), bloque(new char[BLOQUE_ESCRITURA]),
+      usadosBloque(0), enLimite(true), fallo(false) {}
+
+GrabadorCaptura::~GrabadorCaptura() {
+    cerrar();
+    delete[] bloque;
+    delete[] registro;
+    delete[] anillo;
+}
+
+bool GrabadorCaptura::abrir(const char* ruta) {
+    archivo = fopen(ruta, "ab");
+    if (!archivo) {
+        return false;
+    }
+    // Los bloques ya son grandes: el buffer de stdio sólo agregaría una copia
+    setvbuf(archivo, nullptr, _IONBF, 0);
+
+    fseek(archivo, 0, SEEK_END);
+    if (formato == FORMATO_TEXTO && ftell(archivo) > 0) {
+        // La grabación anterior pudo terminar a mitad de una línea
+        agregar("\n", 1);
+    }
+
+    detenido = false;
+    hilo = std::thread(&GrabadorCaptura::ejecutar, this);
+    return true;
+}
+
+void GrabadorCaptura::cerrar() {
+    if (hilo.joinable()) {
+        {
+            std::lock_guard<std::mutex> guardia(cerrojo);
+            detenido = true;
+        }
+        aviso.notify_one();
+        hilo.join();
+    }
+    if (archivo) {
+        escribirBloque();
+        fclose(archivo);
+        archivo = nullptr;
+    }
+}
+
+// ============================================================================
+// LECTOR
+// ============================================================================
+
+void GrabadorCaptura::copiarAlAnillo(size_t posicion, const void* datos, size_t longitud) {
+    size_t desde = posicion & (CAPACIDAD_ANILLO - 1);
+    size_t primera = CAPACIDAD_ANILLO - desde < longitud ? CAPACIDAD_ANILLO - desde : longitud;
+    memcpy(anillo + desde, datos, primera);
+    memcpy(anillo, static_cast<const char*>(datos) + primera, longitud - primera);
+}
+
+void GrabadorCaptura::registrar(const char* datos, size_t longitud, long long instante) {
+    if (!archivo) return;
+
+    while (longitud > 0) {
+        size_t n = longitud < MAXIMO_REGISTRO ? longitud : MAXIMO_REGISTRO;
+        size_t c = cola.load(std::memory_order_relaxed);
+        size_t ocupados = c - cabeza.load(std::memory_order_acquire);
+
+        if (CAPACIDAD_ANILLO - ocupados < sizeof(Cabecera) + n) {
+            // El hilo escritor va atrasado: perder la captura antes que demorar la lectura
+            perdidos.fetch_add(longitud, std::memory_order_relaxed);
+            RegistroMetricas::global().sumar(METRICA_BYTES_SIN_GRABAR, longitud);
+            return;
+        }
+
+        Cabecera cabecera;
+        cabecera.instante = instante;
+        cabecera.longitud = n;
+        copiarAlAnillo(c, &cabecera, sizeof(cabecera));
+        copiarAlAnillo(c + sizeof(cabecera), datos, n);
+        cola.store(c + sizeof(cabecera) + n, std::memory_order_release);
+
+        datos += n;
+        longitud -= n;
+    }
+}
+
+// ============================================================================
+// HILO ESCRITOR
+// ============================================================================
+
+void GrabadorCaptura::copiarDelAnillo(size_t posicion, void* destino, size_t longitud) const {
+    size_t desde = posicion & (CAPACIDAD_ANILLO - 1);
+    size_t primera = CAPACIDAD_ANILLO - desde < longitud ? CAPACIDAD_ANILLO - desde : longitud;
+    memcpy(destino, anillo + desde, primera);
+    memcpy(static_cast<char*>(destino) + primera, anillo, longitud - primera);
+}
+
+size_t GrabadorCaptura::buscarInicioTrama(const char* datos, size_t longitud) {
+    if (formato == FORMATO_TEXTO) {
+        size_t inicio = longitud;
+        if (enLimite) {
+            inicio = 0;
+        } else {
+            for (size_t i = 0; i < longitud; i++) {
+                if (datos[i] == '\n' || datos[i] == '\r') {
+                    inicio = i + 1;
+                    break;
+                }
+            }
+        }
+        enLimite = longitud > 0 && (datos[longitud - 1] == '\n' || datos[longitud - 1] == '\r');
+        return inicio;
+    }
+
+    // En binario sólo el analizador sabe dónde termina cada trama: se le
+    // pide de a una hasta que quede entre dos, y después se lo lleva al final
+    static const int LOTE = 256;
+    Trama tramas[LOTE];
+    int malformadas = 0;
+    size_t posicion = 0;
+    size_t inicio = longitud;
+
+    if (!separador.enTrama()) {
+        inicio = 0;
+    }
+    while (inicio == longitud && posicion < longitud) {
+        size_t consumidos = 0;
+        separador.analizar(datos + posicion, longitud - posicion, consumidos, tramas, 1, malformadas);
+        posicion += consumidos;
+        if (!separador.enTrama()) {
+            inicio = posicion;
+        }
+    }
+    while (posicion < longitud) {
+        size_t consumidos = 0;
+        separador.analizar(datos + posicion, longitud - posicion, consumidos, tramas, LOTE, malformadas);
+        posicion += consumidos;
+    }
+    return inicio;
+}
+
+void GrabadorCaptura::agregar(const char* datos, size_t longitud) {
+    while (longitud > 0 && !fallo) {
+        size_t libres = BLOQUE_ESCRITURA - usadosBloque;
+        size_t n = longitud < libres ? longitud : libres;
+        memcpy(bloque + usadosBloque, datos, n);
+        usadosBloque += n;
+        datos += n;
+        longitud -= n;
+        if (usadosBloque == BLOQUE_ESCRITURA) {
+            escribirBloque();
+        }
+    }
+}
+
+void GrabadorCaptura::agregarMarca(long long instante) {
+    char marca[32];
+    int n;
+
+    if (formato == FORMATO_TEXTO) {
+        n = snprintf(marca, sizeof(marca), "%c%lld\n", MARCA_COMENTARIO, instante);
+    } else {
+        unsigned long long valor = static_cast<unsigned long long>(instante);
+        marca[0] = static_cast<char>(AnalizadorBinario::ETIQUETA_MARCA_TIEMPO);
+        for (int i = 0; i < AnalizadorBinario::BYTES_MARCA_TIEMPO; i++) {
+            marca[1 + i] = static_cast<char>((valor >> (8 * i)) & 0xFF);
+        }
+        n = 1 + AnalizadorBinario::BYTES_MARCA_TIEMPO;
+    }
+    agregar(marca, static_cast<size_t>(n));
+}
+
+void GrabadorCaptura::escribirBloque() {
+    if (usadosBloque == 0 || fallo) {
+        usadosBloque = 0;
+        return;
+    }
+    if (fwrite(bloque, 1, usadosBloque, archivo) != usadosBloque) {
+        fallo = true;
+    }
+    usadosBloque = 0;
+}
+
+void GrabadorCaptura::drenar() {
+    size_t h = cabeza.load(std::memory_order_relaxed);
+    size_t c = cola.load(std::memory_order_acquire);
+
+    while (h != c) {
+        Cabecera cabecera;
+        copiarDelAnillo(h, &cabecera, sizeof(cabecera));
+        copiarDelAnillo(h + sizeof(cabecera), registro, cabecera.longitud);
+        h += sizeof(cabecera) + cabecera.longitud;
+        // Liberar el espacio antes de escribir: el lector ya puede reutilizarlo
+        cabeza.store(h, std::memory_order_release);
+
+        size_t inicio = buscarInicioTrama(registro, cabecera.longitud);
+        agregar(registro, inicio);
+        if (inicio < cabecera.longitud) {
+            agregarMarca(cabecera.instante);
+            agregar(registro + inicio, cabecera.longitud - inicio);
+        }
+        grabados.fetch_add(cabecera.longitud, std::memory_order_relaxed);
+        RegistroMetricas::global().sumar(METRICA_BYTES_GRABADOS, cabecera.longitud);
+
+        if (h == c) {
+            c = cola.load(std::memory_order_acquire);
+        }
+    }
+
+    // Lo que llegó en este intervalo va al archivo ya, por si el proceso termina mal
+    escribirBloque();
+}
+
+void GrabadorCaptura::ejecutar() {
+    const std::chrono::milliseconds intervalo(static_cast<int>(INTERVALO_MS));
+
+    std::unique_lock<std::mutex> guardia(cerrojo);
+    while (!detenido) {
+        aviso.wait_for(guardia, intervalo, [this] { return detenido; });
+        guardia.unlock();
+        drenar();
+        guardia.lock();
+    }
+}
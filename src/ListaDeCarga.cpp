@@ -0,0 +1,296 @@
+/**
+ * @file ListaDeCarga.cpp
+ * @brief Implementación de la lista de carga y de su arena de nodos
+ */
+
+#include "prt7/ListaDeCarga.h"
+#include "prt7/EscritorSalida.h"
+#include "prt7/Metricas.h"
+#include "prt7/SumideroCarga.h"
+
+#include <cstring>
+#include <iostream>
+
+ArenaDeNodos::~ArenaDeNodos() {
+    while (lotes) {
+        Lote* temp = lotes;
+        lotes = lotes->siguiente;
+        delete[] temp->nodos;
+        delete temp;
+    }
+}
+
+NodoCarga* ArenaDeNodos::obtener() {
+    if (libres) {
+        NodoCarga* nodo = libres;
+        libres = nodo->siguiente;
+        nodo->usados = 0;
+        nodo->siguiente = nullptr;
+        nodo->previo = nullptr;
+        return nodo;
+    }
+
+    if (!lotes || entregados == lotes->cantidad) {
+        Lote* nuevo = new Lote;
+        nuevo->cantidad = lotes ? lotes->cantidad * 2 : LOTE_INICIAL;
+        if (nuevo->cantidad > LOTE_MAXIMO) nuevo->cantidad = LOTE_MAXIMO;
+        nuevo->nodos = new NodoCarga[nuevo->cantidad];
+        reservados += sizeof(Lote) + sizeof(NodoCarga) * nuevo->cantidad;
+        RegistroMetricas::global().sumar(METRICA_ASIGNACIONES, 2);
+        RegistroMetricas::global().sumar(METRICA_BYTES_ASIGNADOS, sizeof(Lote) + sizeof(NodoCarga) * nuevo->cantidad);
+        nuevo->siguiente = lotes;
+        lotes = nuevo;
+        entregados = 0;
+    }
+
+    NodoCarga* nodo = &lotes->nodos[entregados++];
+    nodo->usados = 0;
+    nodo->siguiente = nullptr;
+    nodo->previo = nullptr;
+    return nodo;
+}
+
+ListaDeCarga::~ListaDeCarga() {
+    delete[] indice;
+    if (contabilizada) {
+        RegistroMetricas::global().ajustar(INDICADOR_MEMORIA_CARGA, -static_cast<long long>(memoria));
+    }
+}
+
+void ListaDeCarga::soltarCabeza() {
+    NodoCarga* viejo = cabeza;
+    cabeza = viejo->siguiente;
+    if (cabeza) cabeza->previo = nullptr;
+    descartados += viejo->usados;
+    arena.liberar(viejo);
+    nodos--;
+    primerNodo++;
+}
+
+bool ListaDeCarga::derramarCabeza() {
+    // Con sumidero, todo nodo salvo la cola ya se entregó al llenarse
+    if (!sumidero && (!derrame || !derrame->escribir(cabeza->datos, static_cast<size_t>(cabeza->usados)))) {
+        return false;
+    }
+    if (contabilizada) {
+        RegistroMetricas::global().sumar(METRICA_BYTES_DERRAMADOS, static_cast<unsigned long long>(cabeza->usados));
+    }
+    soltarCabeza();
+    return true;
+}
+
+void ListaDeCarga::contabilizarMemoria() {
+    size_t actual = arena.getReservados() + sizeof(NodoCarga*) * static_cast<size_t>(capacidadIndice);
+    if (actual == memoria) return;
+    if (!contabilizada) {
+        memoria = actual;
+        return;
+    }
+
+    RegistroMetricas& metricas = RegistroMetricas::global();
+    metricas.ajustar(INDICADOR_MEMORIA_CARGA, static_cast<long long>(actual) - static_cast<long long>(memoria));
+    metricas.elevar(INDICADOR_MEMORIA_CARGA_MAXIMA, metricas.getIndicador(INDICADOR_MEMORIA_CARGA));
+    memoria = actual;
+}
+
+void ListaDeCarga::entregar(const char* datos, size_t cantidad) {
+    if (sumidero->escribir(datos, cantidad)) return;
+
+    if (sinEntregar == 0) {
+        std::cerr << "Aviso: el sumidero rechazo parte del mensaje; desde aqui se conserva en memoria"
+                  << std::endl;
+    }
+    sinEntregar += static_cast<long long>(cantidad);
+    if (contabilizada) {
+        RegistroMetricas::global().sumar(METRICA_SIN_ENTREGAR, cantidad);
+    }
+}
+
+void ListaDeCarga::agregarNodo() {
+    if (sumidero && cola) {
+        entregar(cola->datos + emitidosEnCola, static_cast<size_t>(cola->usados - emitidosEnCola));
+    }
+    emitidosEnCola = 0;
+
+    // Tras un rechazo del sumidero la ventana ya no retira: sólo la lista tiene lo que sigue
+    if (sumidero && !historial && ventanaNodos > 0 && nodos >= ventanaNodos && sinEntregar == 0) {
+        // La cabeza ya fue entregada completa: reutilizarla como nodo nuevo
+        soltarCabeza();
+    } else if (limiteNodos > 0 && nodos >= limiteNodos) {
+        // Si el derrame falla, la lista crece y excedePresupuesto() frena la lectura
+        derramarCabeza();
+    }
+
+    NodoCarga* nuevo = arena.obtener();
+    if (primerNodo + nodos == capacidadIndice) {
+        ampliarIndice();
+    }
+    indice[primerNodo + nodos] = nuevo;
+    nodos++;
+
+    if (!cabeza) {
+        cabeza = cola = nuevo;
+    } else {
+        cola->siguiente = nuevo;
+        nuevo->previo = cola;
+        cola = nuevo;
+    }
+    contabilizarMemoria();
+}
+
+void ListaDeCarga::ampliarIndice() {
+    if (primerNodo > 0 && nodos <= capacidadIndice / 2) {
+        // La ventana retiró nodos del principio: reutilizar ese espacio
+        memmove(indice, indice + primerNodo, sizeof(NodoCarga*) * nodos);
+        primerNodo = 0;
+        return;
+    }
+
+    int capacidad = capacidadIndice > 0 ? capacidadIndice * 2 : 16;
+    NodoCarga** nuevo = new NodoCarga*[capacidad];
+    if (nodos > 0) {
+        memcpy(nuevo, indice + primerNodo, sizeof(NodoCarga*) * nodos);
+    }
+    delete[] indice;
+    indice = nuevo;
+    capacidadIndice = capacidad;
+    primerNodo = 0;
+    RegistroMetricas::global().sumar(METRICA_ASIGNACIONES, 1);
+    RegistroMetricas::global().sumar(METRICA_BYTES_ASIGNADOS, sizeof(NodoCarga*) * capacidad);
+}
+
+size_t ListaDeCarga::copiar(size_t desde, char* destino, size_t cantidad) const {
+    size_t longitud = getLongitud();
+    if (desde >= longitud) {
+        return 0;
+    }
+    if (cantidad > longitud - desde) {
+        cantidad = longitud - desde;
+    }
+
+    size_t copiados = 0;
+    int bloque = static_cast<int>(desde / NodoCarga::CAPACIDAD);
+    size_t desplazamiento = desde % NodoCarga::CAPACIDAD;
+    while (copiados < cantidad) {
+        const NodoCarga* nodo = indice[primerNodo + bloque++];
+        size_t n = static_cast<size_t>(nodo->usados) - desplazamiento;
+        if (n > cantidad - copiados) n = cantidad - copiados;
+        memcpy(destino + copiados, nodo->datos + desplazamiento, n);
+        copiados += n;
+        desplazamiento = 0;
+    }
+    return copiados;
+}
+
+void ListaDeCarga::configurarSalida(SumideroCarga* destino, size_t ventanaCaracteres, bool conservarHistorial) {
+    sumidero = destino;
+    historial = conservarHistorial;
+    emitidosEnCola = cola ? cola->usados : 0;
+
+    // Un nodo más que los necesarios para cubrir la ventana: el de la cola
+    // puede estar casi vacío
+    size_t porNodo = NodoCarga::CAPACIDAD;
+    ventanaNodos = ventanaCaracteres == 0 ? 0 : static_cast<int>((ventanaCaracteres + porNodo - 1) / porNodo) + 1;
+}
+
+void ListaDeCarga::configurarPresupuesto(size_t bytes, SumideroCarga* destinoDerrame) {
+    derrame = destinoDerrame;
+
+    // El índice se compacta al llegar a la mitad: hasta cuatro posiciones por nodo retenido
+    size_t porNodo = sizeof(NodoCarga) + 4 * sizeof(NodoCarga*);
+    size_t lote = sizeof(NodoCarga) * ArenaDeNodos::LOTE_MAXIMO;
+    limiteNodos = bytes == 0 ? 0 : static_cast<int>((bytes > lote ? bytes - lote : 0) / porNodo);
+    if (bytes > 0 && limiteNodos < 2) {
+        // La cabeza que se retira nunca es la cola que se está llenando
+        limiteNodos = 2;
+    }
+}
+
+void ListaDeCarga::imitarRetencion(const ListaDeCarga& original, SumideroCarga* descarte) {
+    sumidero = original.sumidero ? descarte : nullptr;
+    historial = original.historial;
+    ventanaNodos = original.ventanaNodos;
+    derrame = original.derrame ? descarte : nullptr;
+    limiteNodos = original.limiteNodos;
+}
+
+bool ListaDeCarga::aliviarPresupuesto() {
+    while (excedePresupuesto() && derramarCabeza()) {
+    }
+    if (derrame) {
+        derrame->vaciar();
+    }
+    return !excedePresupuesto();
+}
+
+void ListaDeCarga::vaciarSumidero() {
+    if (derrame) {
+        derrame->vaciar();
+    }
+    if (!sumidero) return;
+
+    if (cola && cola->usados > emitidosEnCola) {
+        entregar(cola->datos + emitidosEnCola, static_cast<size_t>(cola->usados - emitidosEnCola));
+        emitidosEnCola = cola->usados;
+    }
+    sumidero->vaciar();
+}
+
+void ListaDeCarga::insertarBloque(const char* datos, size_t cantidad) {
+    while (cantidad > 0) {
+        if (!cola || cola->usados == NodoCarga::CAPACIDAD) {
+            agregarNodo();
+        }
+
+        size_t libres = NodoCarga::CAPACIDAD - cola->usados;
+        size_t n = cantidad < libres ? cantidad : libres;
+        memcpy(cola->datos + cola->usados, datos, n);
+        cola->usados += static_cast<int>(n);
+        datos += n;
+        cantidad -= n;
+    }
+}
+
+void ListaDeCarga::rellenar(char caracter, size_t cantidad) {
+    while (cantidad > 0) {
+        if (!cola || cola->usados == NodoCarga::CAPACIDAD) {
+            agregarNodo();
+        }
+
+        size_t libres = NodoCarga::CAPACIDAD - cola->usados;
+        size_t n = cantidad < libres ? cantidad : libres;
+        memset(cola->datos + cola->usados, caracter, n);
+        cola->usados += static_cast<int>(n);
+        cantidad -= n;
+    }
+}
+
+void ListaDeCarga::imprimirMensaje() {
+    NodoCarga* actual = cabeza;
+    while (actual) {
+        std::cout.write(actual->datos, actual->usados);
+        actual = actual->siguiente;
+    }
+    std::cout << std::endl;
+}
+
+void ListaDeCarga::imprimirConFormato() {
+    NodoCarga* actual = cabeza;
+    while (actual) {
+        for (int i = 0; i < actual->usados; i++) {
+            std::cout << "[" << actual->datos[i] << "]";
+        }
+        actual = actual->siguiente;
+    }
+}
+
+void ListaDeCarga::imprimirConFormato(EscritorSalida& salida) {
+    NodoCarga* actual = cabeza;
+    while (actual) {
+        for (int i = 0; i < actual->usados; i++) {
+            char celda[3] = { '[', actual->datos[i], ']' };
+            salida.escribir(celda, 3);
+        }
+        actual = actual->siguiente;
+    }
+}
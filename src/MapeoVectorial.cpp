@@ -0,0 +1,154 @@
+/**
+ * @file MapeoVectorial.cpp
+ * @brief Núcleos vectoriales y escalar del desplazamiento César
+ */
+
+#include "prt7/MapeoVectorial.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PRT7_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+/**
+ * @brief Versión escalar, usada para los bytes que no llenan un registro
+ */
+static void mapearEscalar(const char* entrada, char* salida, size_t cantidad, int desplazamiento) {
+    for (size_t i = 0; i < cantidad; i++) {
+        unsigned char c = static_cast<unsigned char>(entrada[i]);
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<unsigned char>(c - ('a' - 'A'));
+        }
+        if (c >= 'A' && c <= 'Z') {
+            int pos = c - 'A' + desplazamiento;
+            if (pos >= 26) pos -= 26;
+            salida[i] = static_cast<char>('A' + pos);
+        } else {
+            salida[i] = entrada[i];
+        }
+    }
+}
+
+#if defined(__AVX2__)
+
+const char* nucleoMapeoVectorial() {
+    return "avx2";
+}
+
+void mapearBloqueCesar(const char* entrada, char* salida, size_t cantidad, int desplazamiento) {
+    // Comparaciones con signo: los bytes >= 128 quedan fuera de ambos rangos
+    const __m256i antesMinuscula = _mm256_set1_epi8('a' - 1);
+    const __m256i despuesMinuscula = _mm256_set1_epi8('z' + 1);
+    const __m256i antesMayuscula = _mm256_set1_epi8('A' - 1);
+    const __m256i despuesMayuscula = _mm256_set1_epi8('Z' + 1);
+    const __m256i diferencia = _mm256_set1_epi8('a' - 'A');
+    const __m256i ultima = _mm256_set1_epi8('Z');
+    const __m256i vuelta = _mm256_set1_epi8(26);
+    const __m256i paso = _mm256_set1_epi8(static_cast<char>(desplazamiento));
+
+    size_t i = 0;
+    for (; i + 32 <= cantidad; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(entrada + i));
+
+        __m256i minuscula = _mm256_and_si256(_mm256_cmpgt_epi8(x, antesMinuscula),
+                                             _mm256_cmpgt_epi8(despuesMinuscula, x));
+        __m256i mayuscula = _mm256_sub_epi8(x, _mm256_and_si256(minuscula, diferencia));
+        __m256i letra = _mm256_and_si256(_mm256_cmpgt_epi8(mayuscula, antesMayuscula),
+                                         _mm256_cmpgt_epi8(despuesMayuscula, mayuscula));
+
+        __m256i desplazada = _mm256_add_epi8(mayuscula, paso);
+        desplazada = _mm256_sub_epi8(desplazada, _mm256_and_si256(_mm256_cmpgt_epi8(desplazada, ultima), vuelta));
+
+        __m256i r = _mm256_blendv_epi8(x, desplazada, letra);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i), r);
+    }
+
+    mapearEscalar(entrada + i, salida + i, cantidad - i, desplazamiento);
+}
+
+#elif defined(PRT7_SSE2)
+
+const char* nucleoMapeoVectorial() {
+    return "sse2";
+}
+
+void mapearBloqueCesar(const char* entrada, char* salida, size_t cantidad, int desplazamiento) {
+    // Comparaciones con signo: los bytes >= 128 quedan fuera de ambos rangos
+    const __m128i antesMinuscula = _mm_set1_epi8('a' - 1);
+    const __m128i despuesMinuscula = _mm_set1_epi8('z' + 1);
+    const __m128i antesMayuscula = _mm_set1_epi8('A' - 1);
+    const __m128i despuesMayuscula = _mm_set1_epi8('Z' + 1);
+    const __m128i diferencia = _mm_set1_epi8('a' - 'A');
+    const __m128i ultima = _mm_set1_epi8('Z');
+    const __m128i vuelta = _mm_set1_epi8(26);
+    const __m128i paso = _mm_set1_epi8(static_cast<char>(desplazamiento));
+
+    size_t i = 0;
+    for (; i + 16 <= cantidad; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(entrada + i));
+
+        __m128i minuscula = _mm_and_si128(_mm_cmpgt_epi8(x, antesMinuscula),
+                                          _mm_cmplt_epi8(x, despuesMinuscula));
+        __m128i mayuscula = _mm_sub_epi8(x, _mm_and_si128(minuscula, diferencia));
+        __m128i letra = _mm_and_si128(_mm_cmpgt_epi8(mayuscula, antesMayuscula),
+                                      _mm_cmplt_epi8(mayuscula, despuesMayuscula));
+
+        __m128i desplazada = _mm_add_epi8(mayuscula, paso);
+        desplazada = _mm_sub_epi8(desplazada, _mm_and_si128(_mm_cmpgt_epi8(desplazada, ultima), vuelta));
+
+        // Sin blendv en SSE2: combinar con máscaras
+        __m128i r = _mm_or_si128(_mm_and_si128(letra, desplazada), _mm_andnot_si128(letra, x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i), r);
+    }
+
+    mapearEscalar(entrada + i, salida + i, cantidad - i, desplazamiento);
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+const char* nucleoMapeoVectorial() {
+    return "neon";
+}
+
+void mapearBloqueCesar(const char* entrada, char* salida, size_t cantidad, int desplazamiento) {
+    const uint8x16_t primeraMinuscula = vdupq_n_u8('a');
+    const uint8x16_t letrasMenos1 = vdupq_n_u8(25);
+    const uint8x16_t diferencia = vdupq_n_u8('a' - 'A');
+    const uint8x16_t primeraMayuscula = vdupq_n_u8('A');
+    const uint8x16_t ultima = vdupq_n_u8('Z');
+    const uint8x16_t vuelta = vdupq_n_u8(26);
+    const uint8x16_t paso = vdupq_n_u8(static_cast<uint8_t>(desplazamiento));
+
+    size_t i = 0;
+    for (; i + 16 <= cantidad; i += 16) {
+        uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(entrada + i));
+
+        // Rango [inicio, inicio + 25] con una resta sin signo y una comparación
+        uint8x16_t minuscula = vcleq_u8(vsubq_u8(x, primeraMinuscula), letrasMenos1);
+        uint8x16_t mayuscula = vsubq_u8(x, vandq_u8(minuscula, diferencia));
+        uint8x16_t letra = vcleq_u8(vsubq_u8(mayuscula, primeraMayuscula), letrasMenos1);
+
+        uint8x16_t desplazada = vaddq_u8(mayuscula, paso);
+        desplazada = vsubq_u8(desplazada, vandq_u8(vcgtq_u8(desplazada, ultima), vuelta));
+
+        vst1q_u8(reinterpret_cast<uint8_t*>(salida + i), vbslq_u8(letra, desplazada, x));
+    }
+
+    mapearEscalar(entrada + i, salida + i, cantidad - i, desplazamiento);
+}
+
+#else
+
+const char* nucleoMapeoVectorial() {
+    return "escalar";
+}
+
+void mapearBloqueCesar(const char* entrada, char* salida, size_t cantidad, int desplazamiento) {
+    mapearEscalar(entrada, salida, cantidad, desplazamiento);
+}
+
+#endif
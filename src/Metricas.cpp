@@ -0,0 +1,240 @@
+/**
+ * @file Metricas.cpp
+ * @brief Implementación del registro de métricas y de su exportación
+ */
+
+#include "prt7/Metricas.h"
+
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <windows.h>
+#endif
+
+/**
+ * @brief Nombre, ayuda y tipo de cada contador en la exportación Prometheus
+ */
+static const char* const NOMBRES_CONTADORES[TOTAL_CONTADORES][2] = {
+    { "prt7_bytes_leidos_total",        "Bytes que entraron al decodificador" },
+    { "prt7_lecturas_total",            "Lecturas con datos del puerto o de la entrada" },
+    { "prt7_tramas_load_total",         "Tramas LOAD procesadas" },
+    { "prt7_tramas_map_total",          "Tramas MAP procesadas" },
+    { "prt7_tramas_fin_total",          "Tramas END procesadas" },
+    { "prt7_tramas_malformadas_total",  "Lineas descartadas por mal formadas" },
+    { "prt7_rotaciones_total",          "Movimientos de rotor aplicados" },
+    { "prt7_asignaciones_total",        "Reservas de memoria del camino critico" },
+    { "prt7_bytes_asignados_total",     "Bytes reservados en el camino critico" },
+    { "prt7_bytes_grabados_total",      "Bytes recibidos escritos en la captura" },
+    { "prt7_bytes_sin_grabar_total",    "Bytes recibidos que la captura descarto por ir atrasada" },
+    { "prt7_bytes_derramados_total",    "Caracteres retirados de memoria por el presupuesto de la carga" },
+    { "prt7_esperas_presupuesto_total", "Pausas de la lectura por carga sobre el presupuesto" },
+    { "prt7_caracteres_sin_entregar_total", "Caracteres que el sumidero no acepto" },
+};
+
+/**
+ * @brief Nombre y ayuda de cada indicador en la exportación Prometheus
+ */
+static const char* const NOMBRES_INDICADORES[TOTAL_INDICADORES][2] = {
+    { "prt7_cola_tramas_lotes",    "Lotes en la cola lector a decodificador" },
+    { "prt7_cola_eventos_lotes",   "Lotes en la cola decodificador a escritor" },
+    { "prt7_sesiones_abiertas",    "Sesiones multipuerto abiertas" },
+    { "prt7_memoria_carga_bytes",  "Bytes reservados por las listas de carga" },
+    { "prt7_memoria_carga_maxima_bytes", "Maximo de bytes reservados por las listas de carga" },
+};
+
+long long relojMonotonicoNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// HISTOGRAMA
+// ============================================================================
+
+HistogramaLog2::HistogramaLog2() : suma(0) {
+    for (int k = 0; k < CUBETAS; k++) {
+        cubetas[k].store(0, std::memory_order_relaxed);
+    }
+}
+
+unsigned long long HistogramaLog2::getTotal() const {
+    unsigned long long total = 0;
+    for (int k = 0; k < CUBETAS; k++) {
+        total += getCuenta(k);
+    }
+    return total;
+}
+
+unsigned long long HistogramaLog2::percentil(double fraccion) const {
+    unsigned long long total = getTotal();
+    if (total == 0) {
+        return 0;
+    }
+
+    // Primer cubeta cuya cuenta acumulada alcanza el percentil
+    unsigned long long objetivo = static_cast<unsigned long long>(fraccion * total);
+    if (objetivo == 0) objetivo = 1;
+
+    unsigned long long acumulado = 0;
+    for (int k = 0; k < CUBETAS; k++) {
+        acumulado += getCuenta(k);
+        if (acumulado >= objetivo) {
+            return limite(k);
+        }
+    }
+    return limite(CUBETAS - 1);
+}
+
+// ============================================================================
+// REGISTRO
+// ============================================================================
+
+RegistroMetricas::RegistroMetricas() {
+    for (int i = 0; i < TOTAL_CONTADORES; i++) {
+        contadores[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < TOTAL_INDICADORES; i++) {
+        indicadores[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+RegistroMetricas& RegistroMetricas::global() {
+    static RegistroMetricas registro;
+    return registro;
+}
+
+int RegistroMetricas::formatearLinea(char* buffer, size_t tamano) const {
+    int n = snprintf(buffer, tamano,
+                     "metricas: bytes=%llu lecturas=%llu load=%llu map=%llu fin=%llu malformadas=%llu "
+                     "rotaciones=%llu latencia_p50=%lluus latencia_p99=%lluus cola_tramas=%lld "
+                     "cola_eventos=%lld sesiones=%lld asignaciones=%llu (%llu bytes) memoria_carga=%lld "
+                     "(max %lld) derramados=%llu esperas_presupuesto=%llu sin_entregar=%llu",
+                     getContador(METRICA_BYTES_LEIDOS), getContador(METRICA_LECTURAS),
+                     getContador(METRICA_TRAMAS_LOAD), getContador(METRICA_TRAMAS_MAP),
+                     getContador(METRICA_TRAMAS_FIN), getContador(METRICA_TRAMAS_MALFORMADAS),
+                     getContador(METRICA_ROTACIONES),
+                     latencia.percentil(0.50) / 1000, latencia.percentil(0.99) / 1000,
+                     getIndicador(INDICADOR_COLA_TRAMAS), getIndicador(INDICADOR_COLA_EVENTOS),
+                     getIndicador(INDICADOR_SESIONES),
+                     getContador(METRICA_ASIGNACIONES), getContador(METRICA_BYTES_ASIGNADOS),
+                     getIndicador(INDICADOR_MEMORIA_CARGA), getIndicador(INDICADOR_MEMORIA_CARGA_MAXIMA),
+                     getContador(METRICA_BYTES_DERRAMADOS), getContador(METRICA_ESPERAS_PRESUPUESTO),
+                     getContador(METRICA_SIN_ENTREGAR));
+    if (n < 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return n < static_cast<int>(tamano) ? n : static_cast<int>(tamano) - 1;
+}
+
+void RegistroMetricas::escribirPrometheus(FILE* archivo) const {
+    for (int i = 0; i < TOTAL_CONTADORES; i++) {
+        fprintf(archivo, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+                NOMBRES_CONTADORES[i][0], NOMBRES_CONTADORES[i][1], NOMBRES_CONTADORES[i][0],
+                NOMBRES_CONTADORES[i][0], getContador(static_cast<ContadorMetrica>(i)));
+    }
+    for (int i = 0; i < TOTAL_INDICADORES; i++) {
+        fprintf(archivo, "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n",
+                NOMBRES_INDICADORES[i][0], NOMBRES_INDICADORES[i][1], NOMBRES_INDICADORES[i][0],
+                NOMBRES_INDICADORES[i][0], getIndicador(static_cast<IndicadorMetrica>(i)));
+    }
+
+    // Histograma acumulado: las cubetas vacías del final no se escriben
+    const char* nombre = "prt7_latencia_lectura_decodificacion_segundos";
+    fprintf(archivo, "# HELP %s Latencia entre la lectura de un bloque y su decodificacion\n"
+                     "# TYPE %s histogram\n", nombre, nombre);
+
+    int ultima = 0;
+    for (int k = 0; k < HistogramaLog2::CUBETAS; k++) {
+        if (latencia.getCuenta(k) > 0) ultima = k;
+    }
+    unsigned long long acumulado = 0;
+    for (int k = 0; k <= ultima; k++) {
+        acumulado += latencia.getCuenta(k);
+        fprintf(archivo, "%s_bucket{le=\"%.9g\"} %llu\n", nombre,
+                static_cast<double>(HistogramaLog2::limite(k)) / 1e9, acumulado);
+    }
+    fprintf(archivo, "%s_bucket{le=\"+Inf\"} %llu\n", nombre, latencia.getTotal());
+    fprintf(archivo, "%s_sum %.9f\n%s_count %llu\n", nombre,
+            static_cast<double>(latencia.getSuma()) / 1e9, nombre, latencia.getTotal());
+}
+
+bool RegistroMetricas::exportarPrometheus(const char* ruta) const {
+    char temporal[1024];
+    int n = snprintf(temporal, sizeof(temporal), "%s.tmp", ruta);
+    if (n < 0 || n >= static_cast<int>(sizeof(temporal))) {
+        return false;
+    }
+
+    FILE* archivo = fopen(temporal, "w");
+    if (!archivo) {
+        return false;
+    }
+    escribirPrometheus(archivo);
+    bool correcto = fflush(archivo) == 0;
+    correcto = fclose(archivo) == 0 && correcto;
+    if (!correcto) {
+        remove(temporal);
+        return false;
+    }
+
+#ifdef _WIN32
+    // rename() de Windows no reemplaza un archivo existente
+    return MoveFileExA(temporal, ruta, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(temporal, ruta) == 0;
+#endif
+}
+
+// ============================================================================
+// INFORME PERIÓDICO
+// ============================================================================
+
+InformePeriodico::~InformePeriodico() {
+    if (hilo.joinable()) {
+        detener();
+    }
+}
+
+void InformePeriodico::iniciar() {
+    detenido = false;
+    hilo = std::thread(&InformePeriodico::ejecutar, this);
+}
+
+void InformePeriodico::detener() {
+    {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        detenido = true;
+    }
+    aviso.notify_one();
+    if (hilo.joinable()) {
+        hilo.join();
+    }
+    informar();
+}
+
+void InformePeriodico::informar() {
+    if (lineas) {
+        char linea[1024];
+        RegistroMetricas::global().formatearLinea(linea, sizeof(linea));
+        fprintf(lineas, "%s\n", linea);
+        fflush(lineas);
+    }
+    if (rutaPrometheus) {
+        RegistroMetricas::global().exportarPrometheus(rutaPrometheus);
+    }
+}
+
+void InformePeriodico::ejecutar() {
+    std::unique_lock<std::mutex> guardia(cerrojo);
+    while (!detenido) {
+        if (aviso.wait_for(guardia, std::chrono::milliseconds(intervaloMs), [this] { return detenido; })) {
+            break;
+        }
+        guardia.unlock();
+        informar();
+        guardia.lock();
+    }
+}
@@ -0,0 +1,224 @@
+/**
+ * @file Multipuerto.cpp
+ * @brief Implementación de la decodificación concurrente de varios puertos
+ */
+
+#include "prt7/Multipuerto.h"
+#include "prt7/Metricas.h"
+
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#ifndef _WIN32
+    #include <poll.h>
+    #include <cerrno>
+#endif
+
+// ============================================================================
+// COLECTOR DE MENSAJES
+// ============================================================================
+
+ColectorMensajes::ColectorMensajes(int cantidad)
+    : mensajes(new MensajeRecolectado[cantidad]), capacidad(cantidad), entregados(0) {
+    memset(mensajes, 0, sizeof(MensajeRecolectado) * cantidad);
+}
+
+ColectorMensajes::~ColectorMensajes() {
+    for (int i = 0; i < capacidad; i++) {
+        delete[] mensajes[i].texto;
+    }
+    delete[] mensajes;
+}
+
+void ColectorMensajes::entregar(int indice, const char* puerto, Decodificador* decodificador) {
+    // Copiar el mensaje fuera del lock: la lista es propiedad de la sesión
+    char* texto = nullptr;
+    size_t longitud = 0;
+
+    if (decodificador) {
+        const ListaDeCarga& carga = decodificador->getCarga();
+        longitud = carga.getLongitud();
+        texto = new char[longitud + 1];
+        carga.copiar(0, texto, longitud);
+        texto[longitud] = '\0';
+    }
+
+    std::lock_guard<std::mutex> guardia(cerrojo);
+    MensajeRecolectado& m = mensajes[indice];
+    m.puerto = puerto;
+    m.texto = texto;
+    m.longitud = longitud;
+    m.abierto = decodificador != nullptr;
+    m.tramasRecibidas = decodificador ? decodificador->getTramasRecibidas() : 0;
+    m.tramasMalformadas = decodificador ? decodificador->getTramasMalformadas() : 0;
+    m.completo = decodificador && decodificador->haTerminado();
+    m.entregado = true;
+    entregados++;
+}
+
+int ColectorMensajes::getEntregados() const {
+    std::lock_guard<std::mutex> guardia(cerrojo);
+    return entregados;
+}
+
+// ============================================================================
+// DECODIFICADOR MULTIPUERTO
+// ============================================================================
+
+bool DecodificadorMultipuerto::agregarPuerto(const ConfiguracionSerial& config) {
+    if (cantidad == MAXIMO_PUERTOS) {
+        return false;
+    }
+
+    Sesion& s = sesiones[cantidad++];
+    s.config = config;
+    s.puerto = PUERTO_INVALIDO;
+    s.lector = nullptr;
+    s.decodificador = nullptr;
+    s.activa = false;
+    return true;
+}
+
+void DecodificadorMultipuerto::terminar(int indice, ColectorMensajes& colector, bool finDatos) {
+    Sesion& s = sesiones[indice];
+
+    if (finDatos && !s.decodificador->haTerminado()) {
+        const char* linea;
+        int longitud;
+        if (s.lector->extraerResto(linea, longitud)) {
+            s.decodificador->procesarLinea(linea, longitud);
+        }
+    }
+    s.decodificador->finalizar();
+    colector.entregar(indice, s.config.puerto, s.decodificador);
+
+    cerrarPuertoSerial(s.puerto);
+    delete s.lector;
+    delete s.decodificador;
+    s.puerto = PUERTO_INVALIDO;
+    s.lector = nullptr;
+    s.decodificador = nullptr;
+    s.activa = false;
+    RegistroMetricas::global().ajustar(INDICADOR_SESIONES, -1);
+}
+
+void DecodificadorMultipuerto::atender(int primera, int paso, ColectorMensajes& colector, int timeoutMs) {
+    int activas = 0;
+
+    for (int i = primera; i < cantidad; i += paso) {
+        Sesion& s = sesiones[i];
+        s.puerto = abrirPuertoSerial(s.config);
+        if (s.puerto == PUERTO_INVALIDO) {
+            colector.entregar(i, s.config.puerto, nullptr);
+            continue;
+        }
+        s.lector = new LectorSerial(s.puerto);
+        s.lector->setFormato(s.config.formato);
+        s.decodificador = new Decodificador(DETALLE_SILENCIOSO);
+        s.decodificador->setFormato(s.config.formato);
+        s.plazo = PlazoInactividad(inactividadMs);
+        s.activa = true;
+        activas++;
+        RegistroMetricas::global().ajustar(INDICADOR_SESIONES, 1);
+    }
+
+#ifdef _WIN32
+    // Sin poll() sobre puertos COM: recorrer los puertos con esperas cortas
+    while (activas > 0) {
+        int espera = timeoutMs / activas;
+        if (espera < 1) espera = 1;
+
+        for (int i = primera; i < cantidad; i += paso) {
+            Sesion& s = sesiones[i];
+            if (!s.activa) continue;
+
+            int leidos = s.lector->rellenar(s.plazo.acotarEspera(espera));
+            if (leidos > 0) {
+                s.plazo.registrarActividad();
+                s.decodificador->procesarLector(*s.lector);
+            }
+            bool inactiva = leidos == 0 && s.plazo.vencido();
+            if (leidos < 0 || inactiva || s.decodificador->haTerminado()) {
+                terminar(i, colector, leidos < 0 || inactiva);
+                activas--;
+            }
+        }
+    }
+#else
+    struct pollfd fds[MAXIMO_PUERTOS];
+    int indices[MAXIMO_PUERTOS];
+
+    while (activas > 0) {
+        int n = 0;
+        int espera = timeoutMs;
+        for (int i = primera; i < cantidad; i += paso) {
+            if (!sesiones[i].activa) continue;
+            fds[n].fd = sesiones[i].puerto;
+            fds[n].events = POLLIN;
+            fds[n].revents = 0;
+            indices[n++] = i;
+            // Despertar a tiempo para el plazo más próximo
+            espera = sesiones[i].plazo.acotarEspera(espera);
+        }
+
+        int listos = poll(fds, n, espera);
+        if (listos < 0 && errno != EINTR) {
+            // Error del propio poll: cerrar todas las sesiones del hilo
+            for (int k = 0; k < n; k++) {
+                terminar(indices[k], colector, true);
+            }
+            return;
+        }
+
+        for (int k = 0; k < n; k++) {
+            Sesion& s = sesiones[indices[k]];
+            if (fds[k].revents == 0) {
+                if (s.plazo.vencido()) {
+                    // Sin datos durante todo el plazo: el emisor dejó de transmitir
+                    terminar(indices[k], colector, true);
+                    activas--;
+                }
+                continue;
+            }
+
+            int leidos = s.lector->rellenar(0);
+            if (leidos > 0) {
+                s.plazo.registrarActividad();
+                s.decodificador->procesarLector(*s.lector);
+            }
+            if (leidos < 0 || s.decodificador->haTerminado()) {
+                terminar(indices[k], colector, leidos < 0);
+                activas--;
+            }
+        }
+    }
+#endif
+}
+
+int DecodificadorMultipuerto::ejecutar(ColectorMensajes& colector, int timeoutMs) {
+    if (cantidad == 0) {
+        return 0;
+    }
+
+    int total = hilos > 0 ? hilos : static_cast<int>(std::thread::hardware_concurrency());
+    if (total < 1) total = 1;
+    if (total > cantidad) total = cantidad;
+
+    if (total == 1) {
+        atender(0, 1, colector, timeoutMs);
+        return 1;
+    }
+
+    std::thread* grupo = new std::thread[total];
+    for (int h = 0; h < total; h++) {
+        grupo[h] = std::thread(&DecodificadorMultipuerto::atender, this, h, total,
+                               std::ref(colector), timeoutMs);
+    }
+    for (int h = 0; h < total; h++) {
+        grupo[h].join();
+    }
+    delete[] grupo;
+
+    return total;
+}
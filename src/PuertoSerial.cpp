@@ -0,0 +1,446 @@
+/**
+ * @file PuertoSerial.cpp
+ * @brief Apertura del puerto serial y lector por bloques
+ */
+
+#include "prt7/PuertoSerial.h"
+#include "prt7/AnalizadorTramas.h"
+#include "prt7/GrabadorCaptura.h"
+#include "prt7/Metricas.h"
+#include "prt7/PuntoControl.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <termios.h>
+    #include <poll.h>
+    #include <cerrno>
+#endif
+
+// ============================================================================
+// FUNCIONES DE COMUNICACIÓN SERIAL
+// ============================================================================
+
+#ifdef _WIN32
+DescriptorPuerto abrirPuertoSerial(const ConfiguracionSerial& config) {
+    // Los puertos COM10 en adelante sólo se abren con el prefijo "\\.\"
+    char ruta[64];
+    if (strncmp(config.puerto, "\\\\.\\", 4) == 0) {
+        strncpy(ruta, config.puerto, sizeof(ruta) - 1);
+        ruta[sizeof(ruta) - 1] = '\0';
+    } else {
+        snprintf(ruta, sizeof(ruta), "\\\\.\\%s", config.puerto);
+    }
+
+    HANDLE hSerial = CreateFileA(ruta, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (hSerial == INVALID_HANDLE_VALUE) {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    // Buffers del driver grandes para absorber ráfagas a alta velocidad
+    SetupComm(hSerial, config.bufferEntrada, config.bufferSalida);
+
+    DCB dcbSerialParams = {0};
+    dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
+
+    if (!GetCommState(hSerial, &dcbSerialParams)) {
+        CloseHandle(hSerial);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    dcbSerialParams.BaudRate = static_cast<DWORD>(config.baudios);
+    dcbSerialParams.ByteSize = 8;
+    dcbSerialParams.StopBits = ONESTOPBIT;
+    dcbSerialParams.Parity = NOPARITY;
+    dcbSerialParams.fBinary = TRUE;
+    dcbSerialParams.fOutxCtsFlow = config.controlFlujo ? TRUE : FALSE;
+    dcbSerialParams.fRtsControl = config.controlFlujo ? RTS_CONTROL_HANDSHAKE : RTS_CONTROL_ENABLE;
+
+    if (!SetCommState(hSerial, &dcbSerialParams)) {
+        CloseHandle(hSerial);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    COMMTIMEOUTS timeouts = {0};
+    timeouts.ReadIntervalTimeout = 50;
+    timeouts.ReadTotalTimeoutConstant = 50;
+    timeouts.ReadTotalTimeoutMultiplier = 10;
+
+    SetCommTimeouts(hSerial, &timeouts);
+    PurgeComm(hSerial, PURGE_RXCLEAR | PURGE_TXCLEAR);
+
+    return hSerial;
+}
+
+
+void cerrarPuertoSerial(DescriptorPuerto puerto) {
+    CloseHandle(puerto);
+}
+
+#else
+/**
+ * @brief Traduce una velocidad numérica a la constante de termios
+ * @param baudios Velocidad en baudios
+ * @param velocidad Constante Bxxxx correspondiente
+ * @return true si la velocidad está soportada por el sistema
+ */
+static bool convertirBaudios(long baudios, speed_t& velocidad) {
+    switch (baudios) {
+        case 9600:    velocidad = B9600;    return true;
+        case 19200:   velocidad = B19200;   return true;
+        case 38400:   velocidad = B38400;   return true;
+        case 57600:   velocidad = B57600;   return true;
+        case 115200:  velocidad = B115200;  return true;
+        case 230400:  velocidad = B230400;  return true;
+        #ifdef B460800
+        case 460800:  velocidad = B460800;  return true;
+        #endif
+        #ifdef B500000
+        case 500000:  velocidad = B500000;  return true;
+        #endif
+        #ifdef B921600
+        case 921600:  velocidad = B921600;  return true;
+        #endif
+        #ifdef B1000000
+        case 1000000: velocidad = B1000000; return true;
+        #endif
+        #ifdef B1500000
+        case 1500000: velocidad = B1500000; return true;
+        #endif
+        #ifdef B2000000
+        case 2000000: velocidad = B2000000; return true;
+        #endif
+        default:      return false;
+    }
+}
+
+DescriptorPuerto abrirPuertoSerial(const ConfiguracionSerial& config) {
+    speed_t velocidad;
+    if (!convertirBaudios(config.baudios, velocidad)) {
+        return -1;
+    }
+
+    // O_NONBLOCK sólo para que open() no espere la línea DCD; las lecturas
+    // se sincronizan con poll() en LectorSerial
+    int fd = open(config.puerto, O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct termios options;
+    if (tcgetattr(fd, &options) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    if (config.modoCrudo) {
+        // Sin modo canónico, eco, señales ni traducción de fin de línea
+        cfmakeraw(&options);
+    }
+
+    cfsetispeed(&options, velocidad);
+    cfsetospeed(&options, velocidad);
+
+    options.c_cflag |= (CLOCAL | CREAD);
+    options.c_cflag &= ~PARENB;
+    options.c_cflag &= ~CSTOPB;
+    options.c_cflag &= ~CSIZE;
+    options.c_cflag |= CS8;
+
+    if (config.controlFlujo) {
+        options.c_cflag |= CRTSCTS;
+    } else {
+        options.c_cflag &= ~CRTSCTS;
+    }
+
+    options.c_cc[VMIN] = static_cast<cc_t>(config.vmin);
+    options.c_cc[VTIME] = static_cast<cc_t>(config.vtime);
+
+    if (tcsetattr(fd, TCSANOW, &options) != 0) {
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIFLUSH);
+
+    return fd;
+}
+
+void cerrarPuertoSerial(DescriptorPuerto puerto) {
+    close(puerto);
+}
+
+#endif
+
+// ============================================================================
+// LECTOR SERIAL POR BLOQUES
+// ============================================================================
+
+void LectorSerial::compactar() {
+    if (inicio == 0) return;
+
+    int pendientes = fin - inicio;
+    memmove(datos, datos + inicio, pendientes);
+    escaneado -= inicio;
+    inicio = 0;
+    fin = pendientes;
+}
+
+void LectorSerial::descartarExceso(int desde) {
+    for (int i = desde; i < fin; i++) {
+        if (datos[i] == '\n' || datos[i] == '\r') {
+            memmove(datos + desde, datos + i, fin - i);
+            fin -= (i - desde);
+            truncando = false;
+            return;
+        }
+    }
+    fin = desde;
+}
+
+PlazoInactividad::PlazoInactividad(int milisegundos)
+    : limiteNs(milisegundos > 0 ? milisegundos * 1000000LL : 0), ultimaActividad(relojMonotonicoNs()) {}
+
+void PlazoInactividad::registrarActividad() {
+    ultimaActividad = relojMonotonicoNs();
+}
+
+bool PlazoInactividad::vencido() const {
+    return limiteNs > 0 && relojMonotonicoNs() - ultimaActividad >= limiteNs;
+}
+
+int PlazoInactividad::acotarEspera(int esperaMs) const {
+    if (limiteNs == 0) {
+        return esperaMs;
+    }
+
+    long long restante = limiteNs - (relojMonotonicoNs() - ultimaActividad);
+    if (restante <= 0) {
+        return 0;
+    }
+    // Redondear hacia arriba: con una espera menor el plazo no habría vencido al volver
+    long long restanteMs = (restante + 999999) / 1000000;
+    if (esperaMs >= 0 && esperaMs < restanteMs) {
+        return esperaMs;
+    }
+    return static_cast<int>(restanteMs);
+}
+
+int LectorSerial::rellenar(int timeoutMs) {
+    compactar();
+
+    if (fin == CAPACIDAD && formato == FORMATO_TEXTO) {
+        // Ninguna línea cabe en el buffer: conservar el principio y descartar el
+        // resto. Se guarda un byte de más para que la línea se rechace por larga
+        fin = inicio + LONGITUD_MAXIMA + 1;
+        escaneado = fin;
+        truncando = true;
+    }
+
+    int libres = CAPACIDAD - fin;
+
+#ifdef _WIN32
+    // Los tiempos límite sólo existen en un puerto; un archivo o una tubería no los admite
+    if (dispositivo && timeoutMs != timeoutConfigurado) {
+        // ReadFile regresa en cuanto llega al menos un byte o al agotarse el tiempo
+        COMMTIMEOUTS timeouts = {0};
+        timeouts.ReadIntervalTimeout = MAXDWORD;
+        timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+        // Una espera indefinida se aproxima con el mayor plazo que admite la API
+        timeouts.ReadTotalTimeoutConstant = timeoutMs < 0 ? MAXDWORD - 1 : (timeoutMs > 0 ? timeoutMs : 1);
+        SetCommTimeouts(puerto, &timeouts);
+        timeoutConfigurado = timeoutMs;
+    }
+
+    DWORD bytesLeidos = 0;
+    if (!ReadFile(puerto, datos + fin, libres, &bytesLeidos, NULL)) {
+        return -1;
+    }
+    int n = static_cast<int>(bytesLeidos);
+    if (n == 0 && !dispositivo) {
+        // Sin tiempo límite, 0 bytes es el fin de un archivo (ej. stdin redirigido)
+        return -1;
+    }
+#else
+    struct pollfd pfd;
+    pfd.fd = puerto;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int listo = poll(&pfd, 1, timeoutMs);
+    if (listo == 0) {
+        return 0;
+    }
+    if (listo < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (pfd.revents & (POLLERR | POLLNVAL)) {
+        return -1;
+    }
+    if ((pfd.revents & POLLHUP) && !(pfd.revents & POLLIN)) {
+        // El otro extremo colgó y no queda nada por leer
+        return -1;
+    }
+
+    int n = read(puerto, datos + fin, libres);
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+    }
+    if (n == 0) {
+        // poll indicó datos pero no hay ninguno: el dispositivo se desconectó
+        return -1;
+    }
+#endif
+
+    if (n > 0) {
+        instanteLectura = relojMonotonicoNs();
+        RegistroMetricas& metricas = RegistroMetricas::global();
+        metricas.sumar(METRICA_BYTES_LEIDOS, n);
+        metricas.sumar(METRICA_LECTURAS, 1);
+        if (grabador) {
+            // Los bytes tal como llegaron, antes de descartar el exceso de una línea larga
+            grabador->registrar(datos + fin, n, instanteLectura);
+        }
+    }
+
+    int desde = fin;
+    fin += n;
+    if (truncando) {
+        descartarExceso(desde);
+    }
+    return n;
+}
+
+void LectorSerial::setGrabador(GrabadorCaptura* g) {
+    grabador = g;
+    if (grabador && fin > inicio) {
+        grabador->registrar(datos + inicio, fin - inicio, instanteLectura);
+    }
+}
+
+bool LectorSerial::extraerLinea(const char*& linea, int& longitud) {
+    if (formato == FORMATO_BINARIO) {
+        return false;
+    }
+
+    while (escaneado < fin) {
+        char c = datos[escaneado];
+
+        if (c == '\n' || c == '\r') {
+            longitud = escaneado - inicio;
+            linea = datos + inicio;
+            escaneado++;
+            inicio = escaneado;
+
+            if (longitud == 0) {
+                // Línea vacía o segundo carácter de "\r\n"
+                continue;
+            }
+            return true;
+        }
+
+        escaneado++;
+    }
+
+    return false;
+}
+
+bool LectorSerial::extraerResto(const char*& linea, int& longitud) {
+    if (inicio == fin || formato == FORMATO_BINARIO) {
+        return false;
+    }
+
+    linea = datos + inicio;
+    longitud = fin - inicio;
+    inicio = escaneado = fin;
+    return true;
+}
+
+int LectorSerial::extraerTramas(Trama* tramas, int maximo, int& malformadas) {
+    if (formato == FORMATO_BINARIO) {
+        // El analizador guarda la trama partida: todo lo analizado se consume
+        size_t consumidos = 0;
+        int cantidad = binario.analizar(datos + inicio, fin - inicio, consumidos, tramas, maximo, malformadas);
+        inicio += static_cast<int>(consumidos);
+        escaneado = inicio;
+        return cantidad;
+    }
+
+    int cantidad = 0;
+    const char* linea;
+    int longitud;
+
+    while (cantidad < maximo && extraerLinea(linea, longitud)) {
+        ErrorTrama resultado = analizarTrama(linea, longitud, tramas[cantidad]);
+        if (resultado != TRAMA_VALIDA) {
+            if (resultado != TRAMA_COMENTARIO) malformadas++;
+        } else if (tramas[cantidad++].tipo == TRAMA_FIN) {
+            // Como en binario: lo que sigue a END no se analiza ni se cuenta
+            break;
+        }
+    }
+
+    return cantidad;
+}
+
+bool LectorSerial::contieneTramaValida() const {
+    Trama trama;
+
+    if (formato == FORMATO_BINARIO) {
+        // Analizar con una copia para no avanzar el estado propio
+        AnalizadorBinario copia = binario;
+        size_t consumidos = 0;
+        int malformadas = 0;
+        return copia.analizar(datos + inicio, fin - inicio, consumidos, &trama, 1, malformadas) > 0;
+    }
+
+    int desde = inicio;
+    for (int i = inicio; i < fin; i++) {
+        if (datos[i] == '\n' || datos[i] == '\r') {
+            if (i > desde && analizarTrama(datos + desde, i - desde, trama) == TRAMA_VALIDA) {
+                return true;
+            }
+            desde = i + 1;
+        }
+    }
+    return false;
+}
+
+void LectorSerial::capturarAnalizador(InstantaneaSesion& destino) const {
+    int pendientes = formato == FORMATO_TEXTO ? fin - inicio : 0;
+    int conservados = pendientes < InstantaneaSesion::LONGITUD_LINEA ? pendientes : InstantaneaSesion::LONGITUD_LINEA;
+
+    memcpy(destino.linea, datos + inicio, conservados);
+    destino.longitudLinea = conservados;
+    destino.lineaTruncada = truncando || conservados < pendientes;
+    binario.capturar(destino.binario);
+}
+
+bool LectorSerial::restaurarAnalizador(const InstantaneaSesion& origen) {
+    if (formato == FORMATO_BINARIO) {
+        return binario.restaurar(origen.binario);
+    }
+
+    int longitud = origen.longitudLinea <= LONGITUD_MAXIMA ? origen.longitudLinea : LONGITUD_MAXIMA + 1;
+    compactar();
+    if (longitud < 0 || fin + longitud > CAPACIDAD) {
+        return false;
+    }
+
+    // La línea restaurada va delante de lo que ya se haya leído
+    memmove(datos + longitud, datos, fin);
+    memcpy(datos, origen.linea, longitud);
+    fin += longitud;
+    escaneado = 0;
+    if (origen.lineaTruncada || longitud < origen.longitudLinea) {
+        // El resto de una línea demasiado larga se descarta hasta su fin de línea
+        truncando = true;
+        descartarExceso(longitud);
+    }
+    return true;
+}
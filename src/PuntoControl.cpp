@@ -0,0 +1,463 @@
+/**
+ * @file PuntoControl.cpp
+ * @brief Implementación del guardado y la restauración de sesiones
+ */
+
+#include "prt7/PuntoControl.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+/// Identificador al principio de cada instantánea (sin el '\0')
+static const char MAGICO[] = "PRT7PC";
+static const int LONGITUD_MAGICO = 6;
+
+/// Tamaño máximo de una instantánea serializada
+static const int TAMANO_MAXIMO_INSTANTANEA = 512;
+
+/// Caracteres que se copian de la lista por cada escritura del mensaje
+static const size_t TAMANO_BLOQUE_CARGA = 64 * 1024;
+
+/// Bytes de la captura que se alimentan entre dos oportunidades de guardar
+static const size_t BLOQUE_REPRODUCCION = 1 << 20;
+
+// ============================================================================
+// SERIALIZACIÓN
+// ============================================================================
+
+/**
+ * @struct Cursor
+ * @brief Posición de lectura o escritura dentro de una instantánea
+ */
+struct Cursor {
+    unsigned char* datos;  ///< Inicio del buffer
+    int posicion;          ///< Siguiente byte
+    int limite;            ///< Bytes utilizables
+    bool desbordado;       ///< true si se intentó pasar del límite
+};
+
+/**
+ * @brief Escribe un entero little-endian
+ * @param c Cursor de escritura
+ * @param valor Valor a escribir
+ * @param bytes Bytes del campo
+ */
+static void escribirEntero(Cursor& c, unsigned long long valor, int bytes) {
+    if (c.posicion + bytes > c.limite) {
+        c.desbordado = true;
+        return;
+    }
+    for (int i = 0; i < bytes; i++) {
+        c.datos[c.posicion++] = static_cast<unsigned char>(valor >> (8 * i));
+    }
+}
+
+/**
+ * @brief Lee un entero little-endian
+ * @param c Cursor de lectura
+ * @param bytes Bytes del campo
+ * @return Valor leído (0 si no quedaban bytes)
+ */
+static unsigned long long leerEntero(Cursor& c, int bytes) {
+    if (c.posicion + bytes > c.limite) {
+        c.desbordado = true;
+        return 0;
+    }
+    unsigned long long valor = 0;
+    for (int i = 0; i < bytes; i++) {
+        valor |= static_cast<unsigned long long>(c.datos[c.posicion++]) << (8 * i);
+    }
+    return valor;
+}
+
+/**
+ * @brief Escribe bytes sin convertir
+ * @param c Cursor de escritura
+ * @param origen Bytes a copiar
+ * @param cantidad Cantidad de bytes
+ */
+static void escribirBytes(Cursor& c, const void* origen, int cantidad) {
+    if (c.posicion + cantidad > c.limite) {
+        c.desbordado = true;
+        return;
+    }
+    memcpy(c.datos + c.posicion, origen, cantidad);
+    c.posicion += cantidad;
+}
+
+/**
+ * @brief Lee bytes sin convertir
+ * @param c Cursor de lectura
+ * @param destino Buffer de destino
+ * @param cantidad Cantidad de bytes
+ */
+static void leerBytes(Cursor& c, void* destino, int cantidad) {
+    if (c.posicion + cantidad > c.limite) {
+        c.desbordado = true;
+        return;
+    }
+    memcpy(destino, c.datos + c.posicion, cantidad);
+    c.posicion += cantidad;
+}
+
+/**
+ * @brief Hash FNV-1a de 32 bits
+ * @param datos Bytes a resumir
+ * @param cantidad Cantidad de bytes
+ * @return Hash de los bytes
+ */
+static unsigned int hashFnv(const unsigned char* datos, int cantidad) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; i < cantidad; i++) {
+        h = (h ^ datos[i]) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Serializa una instantánea
+ * @param inst Instantánea de la sesión
+ * @param bytesCarga Bytes válidos del archivo del mensaje
+ * @param posicion Bytes de la captura ya alimentados
+ * @param destino Buffer de TAMANO_MAXIMO_INSTANTANEA bytes
+ * @return Bytes escritos
+ */
+static int serializar(const InstantaneaSesion& inst, long long bytesCarga, long long posicion,
+                      unsigned char* destino) {
+    Cursor c = {destino, 0, TAMANO_MAXIMO_INSTANTANEA - 4, false};
+
+    escribirBytes(c, MAGICO, LONGITUD_MAGICO);
+    escribirEntero(c, PuntoControl::VERSION, 1);
+    escribirEntero(c, inst.formato, 1);
+    escribirEntero(c, inst.tramasRecibidas, 8);
+    escribirEntero(c, inst.tramasMalformadas, 8);
+    escribirEntero(c, inst.tramasCarga, 8);
+    escribirEntero(c, inst.movimientosRotor, 8);
+    escribirEntero(c, inst.finTransmision, 1);
+    escribirEntero(c, inst.cantidadRotores, 1);
+    escribirEntero(c, inst.avance, 1);
+    int rotores = inst.cantidadRotores > 0 ? inst.cantidadRotores : 1;
+    for (int i = 0; i < rotores; i++) {
+        escribirEntero(c, inst.desplazamientos[i], 1);
+    }
+    escribirEntero(c, bytesCarga, 8);
+    escribirEntero(c, posicion, 8);
+
+    escribirEntero(c, inst.longitudLinea, 2);
+    escribirEntero(c, inst.lineaTruncada, 1);
+    escribirBytes(c, inst.linea, inst.longitudLinea);
+
+    escribirEntero(c, inst.binario.estado, 1);
+    escribirEntero(c, inst.binario.acumulado, 8);
+    escribirEntero(c, inst.binario.bytesVarint, 1);
+    escribirEntero(c, inst.binario.rotor, 1);
+    escribirEntero(c, inst.binario.restantes, 8);
+
+    c.limite = TAMANO_MAXIMO_INSTANTANEA;
+    escribirEntero(c, hashFnv(destino, c.posicion), 4);
+    return c.posicion;
+}
+
+/**
+ * @brief Interpreta una instantánea serializada
+ * @param datos Bytes leídos del archivo
+ * @param cantidad Cantidad de bytes
+ * @param inst Instantánea a completar
+ * @param bytesCarga Bytes válidos del archivo del mensaje
+ * @param posicion Bytes de la captura ya alimentados
+ * @return false si los bytes no son una instantánea válida de esta versión
+ */
+static bool deserializar(unsigned char* datos, int cantidad, InstantaneaSesion& inst,
+                         long long& bytesCarga, long long& posicion) {
+    if (cantidad < LONGITUD_MAGICO + 4) {
+        return false;
+    }
+    Cursor pie = {datos, cantidad - 4, cantidad, false};
+    if (leerEntero(pie, 4) != hashFnv(datos, cantidad - 4)) {
+        return false;
+    }
+
+    Cursor c = {datos, 0, cantidad - 4, false};
+    char magico[LONGITUD_MAGICO];
+    leerBytes(c, magico, LONGITUD_MAGICO);
+    if (memcmp(magico, MAGICO, LONGITUD_MAGICO) != 0 || leerEntero(c, 1) != PuntoControl::VERSION) {
+        return false;
+    }
+
+    inst.formato = leerEntero(c, 1) == FORMATO_BINARIO ? FORMATO_BINARIO : FORMATO_TEXTO;
+    inst.tramasRecibidas = static_cast<long long>(leerEntero(c, 8));
+    inst.tramasMalformadas = static_cast<long long>(leerEntero(c, 8));
+    inst.tramasCarga = static_cast<long long>(leerEntero(c, 8));
+    inst.movimientosRotor = static_cast<long long>(leerEntero(c, 8));
+    inst.finTransmision = leerEntero(c, 1) != 0;
+    inst.cantidadRotores = static_cast<int>(leerEntero(c, 1));
+    inst.avance = leerEntero(c, 1) != 0;
+    if (inst.cantidadRotores > RotorCompuesto::MAXIMO_ROTORES) {
+        return false;
+    }
+    int rotores = inst.cantidadRotores > 0 ? inst.cantidadRotores : 1;
+    for (int i = 0; i < rotores; i++) {
+        inst.desplazamientos[i] = static_cast<int>(leerEntero(c, 1));
+    }
+    bytesCarga = static_cast<long long>(leerEntero(c, 8));
+    posicion = static_cast<long long>(leerEntero(c, 8));
+
+    inst.longitudLinea = static_cast<int>(leerEntero(c, 2));
+    inst.lineaTruncada = leerEntero(c, 1) != 0;
+    if (inst.longitudLinea > InstantaneaSesion::LONGITUD_LINEA) {
+        return false;
+    }
+    leerBytes(c, inst.linea, inst.longitudLinea);
+
+    inst.binario.estado = static_cast<int>(leerEntero(c, 1));
+    inst.binario.acumulado = leerEntero(c, 8);
+    inst.binario.bytesVarint = static_cast<int>(leerEntero(c, 1));
+    inst.binario.rotor = static_cast<int>(leerEntero(c, 1));
+    inst.binario.restantes = leerEntero(c, 8);
+
+    return !c.desbordado && c.posicion == c.limite && bytesCarga >= 0 && posicion >= 0;
+}
+
+/**
+ * @brief Copia una ruta agregándole un sufijo
+ * @param ruta Ruta base
+ * @param sufijo Sufijo a agregar
+ * @return Cadena nueva (se libera con delete[])
+ */
+static char* concatenarRuta(const char* ruta, const char* sufijo) {
+    size_t a = strlen(ruta);
+    size_t b = strlen(sufijo);
+    char* resultado = new char[a + b + 1];
+    memcpy(resultado, ruta, a);
+    memcpy(resultado + a, sufijo, b + 1);
+    return resultado;
+}
+
+/**
+ * @brief Lleva al disco lo escrito en un archivo
+ * @param archivo Archivo abierto
+ * @return true si el sistema confirmó la escritura
+ */
+static bool sincronizar(FILE* archivo) {
+    if (fflush(archivo) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(archivo)) == 0;
+#else
+    return fsync(fileno(archivo)) == 0;
+#endif
+}
+
+// ============================================================================
+// PUNTO DE CONTROL
+// ============================================================================
+
+PuntoControl::PuntoControl(const char* ruta, int intervaloMs)
+    : rutaEstado(concatenarRuta(ruta, "")), rutaTemporal(concatenarRuta(ruta, ".tmp")),
+      rutaCarga(concatenarRuta(ruta, ".carga")), archivoCarga(nullptr), bytesCarga(0), persistidos(0),
+      posicionEntrada(0), intervaloNs(intervaloMs * 1000000LL), ultimoGuardado(relojMonotonicoNs()),
+      fallos(0), hayRestaurada(false) {
+    memset(&restaurada, 0, sizeof(restaurada));
+}
+
+PuntoControl::~PuntoControl() {
+    if (archivoCarga) {
+        fclose(archivoCarga);
+    }
+    delete[] rutaEstado;
+    delete[] rutaTemporal;
+    delete[] rutaCarga;
+}
+
+bool PuntoControl::abrirCarga(long long conservar) {
+    if (archivoCarga) {
+        fclose(archivoCarga);
+    }
+    archivoCarga = fopen(rutaCarga, conservar > 0 ? "r+b" : "wb");
+    if (!archivoCarga) {
+        return false;
+    }
+    if (conservar > 0) {
+        // Lo que siga a los bytes válidos se escribió después del último guardado
+        fflush(archivoCarga);
+#ifdef _WIN32
+        bool truncado = _chsize_s(_fileno(archivoCarga), conservar) == 0;
+#else
+        bool truncado = ftruncate(fileno(archivoCarga), static_cast<off_t>(conservar)) == 0;
+#endif
+        if (!truncado || fseek(archivoCarga, 0, SEEK_END) != 0) {
+            fclose(archivoCarga);
+            archivoCarga = nullptr;
+            return false;
+        }
+    }
+    bytesCarga = conservar;
+    return true;
+}
+
+ResultadoPuntoControl PuntoControl::cargar(Decodificador& decodificador) {
+    FILE* archivo = fopen(rutaEstado, "rb");
+    if (!archivo) {
+        return abrirCarga(0) ? PUNTO_CONTROL_AUSENTE : PUNTO_CONTROL_INVALIDO;
+    }
+
+    unsigned char datos[TAMANO_MAXIMO_INSTANTANEA];
+    int cantidad = static_cast<int>(fread(datos, 1, sizeof(datos), archivo));
+    fclose(archivo);
+
+    InstantaneaSesion inst;
+    long long carga = 0;
+    long long posicion = 0;
+    if (!deserializar(datos, cantidad, inst, carga, posicion) || !decodificador.restaurarEstado(inst)) {
+        return PUNTO_CONTROL_INVALIDO;
+    }
+
+    // Reconstruir el mensaje con los bytes válidos del archivo de carga
+    FILE* mensaje = fopen(rutaCarga, "rb");
+    if (!mensaje && carga > 0) {
+        return PUNTO_CONTROL_INVALIDO;
+    }
+    ListaDeCarga& lista = decodificador.getCarga();
+    char bloque[TAMANO_BLOQUE_CARGA];
+    long long restantes = carga;
+    while (restantes > 0) {
+        size_t pedir = restantes < static_cast<long long>(sizeof(bloque)) ? static_cast<size_t>(restantes) : sizeof(bloque);
+        size_t leidos = fread(bloque, 1, pedir, mensaje);
+        if (leidos == 0) {
+            break;
+        }
+        lista.insertarBloque(bloque, leidos);
+        restantes -= static_cast<long long>(leidos);
+    }
+    if (mensaje) {
+        fclose(mensaje);
+    }
+    if (restantes > 0 || !abrirCarga(carga)) {
+        // El archivo de carga es más corto de lo que indica la instantánea
+        return PUNTO_CONTROL_INVALIDO;
+    }
+
+    persistidos = lista.getDescartados() + static_cast<long long>(lista.getLongitud());
+    posicionEntrada = posicion;
+    restaurada = inst;
+    hayRestaurada = true;
+    return PUNTO_CONTROL_RESTAURADO;
+}
+
+void PuntoControl::prepararEntrada(Decodificador& decodificador, LectorSerial* lector) {
+    if (!hayRestaurada) {
+        return;
+    }
+    if (lector) {
+        lector->restaurarAnalizador(restaurada);
+    } else {
+        decodificador.restaurarAnalizador(restaurada);
+    }
+    hayRestaurada = false;
+}
+
+bool PuntoControl::agregarCarga(const ListaDeCarga& carga) {
+    long long descartados = carga.getDescartados();
+    long long total = descartados + static_cast<long long>(carga.getLongitud());
+    // Lo que la ventana ya retiró se entregó al sumidero: seguir desde lo retenido
+    long long desde = persistidos > descartados ? persistidos : descartados;
+    // Último estado que está entero en disco, para volver a él si algo falla
+    long long bytesValidos = bytesCarga;
+    long long persistidosValidos = persistidos;
+
+    char bloque[TAMANO_BLOQUE_CARGA];
+    bool correcto = true;
+    while (correcto && desde < total) {
+        long long faltan = total - desde;
+        size_t n = faltan < static_cast<long long>(sizeof(bloque)) ? static_cast<size_t>(faltan) : sizeof(bloque);
+        carga.copiar(static_cast<size_t>(desde - descartados), bloque, n);
+        correcto = fwrite(bloque, 1, n, archivoCarga) == n;
+        if (correcto) {
+            desde += static_cast<long long>(n);
+            bytesCarga += static_cast<long long>(n);
+            persistidos = desde;
+        }
+    }
+    if (correcto && sincronizar(archivoCarga)) {
+        return true;
+    }
+
+    // Un bloque a medias o sin sincronizar no debe quedar detrás de los bytes
+    // válidos: el próximo guardado los vuelve a escribir desde ahí
+    persistidos = persistidosValidos;
+    bytesCarga = bytesValidos;
+    abrirCarga(bytesValidos);
+    return false;
+}
+
+bool PuntoControl::guardar(Decodificador& decodificador, const LectorSerial* lector, long long posicion) {
+    ultimoGuardado = relojMonotonicoNs();
+    if (hayRestaurada) {
+        // La línea restaurada aún no se entregó a nadie: guardarla tal cual
+        prepararEntrada(decodificador, nullptr);
+    }
+
+    // Primero el mensaje: la instantánea nunca apunta a bytes que no estén en disco.
+    // Si un fallo anterior no pudo reabrir el archivo, se reintenta aquí
+    if ((!archivoCarga && !abrirCarga(bytesCarga)) || !agregarCarga(decodificador.getCarga())) {
+        fallos++;
+        return false;
+    }
+
+    InstantaneaSesion inst;
+    decodificador.capturarEstado(inst);
+    if (lector) {
+        lector->capturarAnalizador(inst);
+    }
+
+    unsigned char datos[TAMANO_MAXIMO_INSTANTANEA];
+    int cantidad = serializar(inst, bytesCarga, posicion, datos);
+
+    FILE* archivo = fopen(rutaTemporal, "wb");
+    bool correcto = archivo && fwrite(datos, 1, cantidad, archivo) == static_cast<size_t>(cantidad);
+    if (archivo) {
+        correcto = sincronizar(archivo) && correcto;
+        correcto = fclose(archivo) == 0 && correcto;
+    }
+#ifdef _WIN32
+    // rename() de Windows no reemplaza un archivo existente
+    correcto = correcto && MoveFileExA(rutaTemporal, rutaEstado, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    correcto = correcto && rename(rutaTemporal, rutaEstado) == 0;
+#endif
+
+    if (!correcto) {
+        fallos++;
+    }
+    return correcto;
+}
+
+// ============================================================================
+// REPRODUCCIÓN
+// ============================================================================
+
+void reproducirConPuntoControl(const char* datos, size_t tamano, Decodificador& decodificador,
+                               PuntoControl& puntoControl) {
+    size_t posicion = static_cast<size_t>(puntoControl.getPosicionEntrada());
+    if (posicion > tamano) {
+        posicion = tamano;
+    }
+
+    puntoControl.prepararEntrada(decodificador, nullptr);
+    while (posicion < tamano && !decodificador.haTerminado()) {
+        size_t n = tamano - posicion < BLOQUE_REPRODUCCION ? tamano - posicion : BLOQUE_REPRODUCCION;
+        decodificador.alimentar(datos + posicion, n);
+        posicion += n;
+        puntoControl.guardarSiVence(decodificador, nullptr, static_cast<long long>(posicion));
+    }
+    // Guardar antes de cerrar la línea o trama a medias del final
+    puntoControl.guardar(decodificador, nullptr, static_cast<long long>(posicion));
+    decodificador.finalizar();
+}
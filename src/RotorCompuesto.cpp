@@ -0,0 +1,35 @@
+/**
+ * @file RotorCompuesto.cpp
+ * @brief Implementación de la cadena de rotores
+ */
+
+#include "prt7/RotorCompuesto.h"
+
+RotorCompuesto::RotorCompuesto(int rotoresEnUso, bool conAvance)
+    : cantidad(rotoresEnUso), avance(conAvance) {
+    if (cantidad < 1) cantidad = 1;
+    if (cantidad > MAXIMO_ROTORES) cantidad = MAXIMO_ROTORES;
+}
+
+bool RotorCompuesto::rotar(int indice, int n) {
+    if (indice < 0 || indice >= cantidad) {
+        return false;
+    }
+
+    rotores[indice].rotar(n);
+    compuesto.rotar(n);
+    return true;
+}
+
+void RotorCompuesto::avanzar() {
+    int movidos = 0;
+    for (int i = 0; i < cantidad; i++) {
+        rotores[i].rotar(1);
+        movidos++;
+        if (rotores[i].getDesplazamiento() != 0) {
+            // Sin vuelta completa: no hay acarreo al siguiente rotor
+            break;
+        }
+    }
+    compuesto.rotar(movidos);
+}
@@ -0,0 +1,42 @@
+/**
+ * @file RotorDeMapeo.cpp
+ * @brief Implementación del rotor de mapeo
+ */
+
+#include "prt7/RotorDeMapeo.h"
+
+RotorDeMapeo::RotorDeMapeo()
+    : desplazamiento(0), tabla(RotorAlfabeto<AlfabetoLatino>::tabla(0)),
+      inversa(RotorAlfabeto<AlfabetoLatino>::tablaInversa(0)) {
+    // Enlazar el anillo A-Z en un círculo
+    for (int i = 0; i < TAMANO_ANILLO; i++) {
+        anillo[i].dato = AlfabetoLatino::simbolo(i);
+        anillo[i].siguiente = &anillo[(i + 1) % TAMANO_ANILLO];
+        anillo[i].previo = &anillo[(i + TAMANO_ANILLO - 1) % TAMANO_ANILLO];
+    }
+    cabeza = &anillo[0];
+}
+
+void RotorDeMapeo::rotar(int n) {
+    int pasos = n % TAMANO_ANILLO;
+    if (pasos < 0) {
+        pasos += TAMANO_ANILLO;
+    }
+    if (pasos == 0) {
+        return;
+    }
+
+    if (pasos <= TAMANO_ANILLO / 2) {
+        for (int i = 0; i < pasos; i++) {
+            cabeza = cabeza->siguiente;
+        }
+    } else {
+        for (int i = pasos; i < TAMANO_ANILLO; i++) {
+            cabeza = cabeza->previo;
+        }
+    }
+
+    desplazamiento = (desplazamiento + pasos) % TAMANO_ANILLO;
+    tabla = RotorAlfabeto<AlfabetoLatino>::tabla(desplazamiento);
+    inversa = RotorAlfabeto<AlfabetoLatino>::tablaInversa(desplazamiento);
+}
@@ -0,0 +1,175 @@
+/**
+ * @file SesionAsincrona.cpp
+ * @brief Implementación de la sesión movida por el bucle de eventos
+ */
+
+#include "prt7/SesionAsincrona.h"
+#include "prt7/Metricas.h"
+
+SesionAsincrona::SesionAsincrona(Decodificador& d, DescriptorPuerto puerto, bool guardarTramas)
+    : decodificador(d), lector(nullptr), observador(nullptr), conCola(guardarTramas),
+      terminada(d.haTerminado()), cola(nullptr), capacidadCola(0), primeraCola(0), usadosCola(0) {
+    esperaTrama.funcion = nullptr;
+    esperaTrama.contexto = nullptr;
+    esperaMensaje = esperaTrama;
+
+    if (puerto != PUERTO_INVALIDO) {
+        lector = new LectorSerial(puerto);
+        lector->setFormato(d.getFormato());
+    }
+    if (conCola) {
+        capacidadCola = CAPACIDAD_INICIAL_COLA;
+        cola = new Trama[capacidadCola];
+        decodificador.setObservador(this);
+    }
+}
+
+SesionAsincrona::~SesionAsincrona() {
+    decodificador.setObservador(nullptr);
+    delete lector;
+    delete[] cola;
+}
+
+void SesionAsincrona::setObservador(ObservadorSesion* o) {
+    observador = o;
+    // Sin cola ni observador, el decodificador no paga nada por trama
+    decodificador.setObservador(conCola || observador ? this : nullptr);
+}
+
+void SesionAsincrona::agrandarCola() {
+    int nuevaCapacidad = capacidadCola * 2;
+    Trama* nueva = new Trama[nuevaCapacidad];
+    for (int i = 0; i < usadosCola; i++) {
+        nueva[i] = cola[(primeraCola + i) % capacidadCola];
+    }
+    delete[] cola;
+    cola = nueva;
+    capacidadCola = nuevaCapacidad;
+    primeraCola = 0;
+}
+
+void SesionAsincrona::tramasRecibidas(const Trama* tramas, int cantidad) {
+    if (conCola) {
+        // La cola sólo crece si la aplicación no extrae al ritmo de llegada
+        while (usadosCola + cantidad > capacidadCola) {
+            agrandarCola();
+        }
+        for (int i = 0; i < cantidad; i++) {
+            cola[(primeraCola + usadosCola + i) % capacidadCola] = tramas[i];
+        }
+        usadosCola += cantidad;
+    }
+    if (observador) {
+        observador->tramasRecibidas(tramas, cantidad);
+    }
+}
+
+void SesionAsincrona::terminar() {
+    if (terminada) return;
+    terminada = true;
+
+    decodificador.getSalida().vaciar();
+    decodificador.getCarga().vaciarSumidero();
+    decodificador.publicarMetricas();
+    if (observador) {
+        observador->sesionTerminada(decodificador);
+    }
+}
+
+void SesionAsincrona::despertar() {
+    // Copiar y borrar antes de llamar: la continuación puede volver a esperar
+    if (esperaTrama.funcion && (usadosCola > 0 || terminada)) {
+        Continuacion c = esperaTrama;
+        esperaTrama.funcion = nullptr;
+        c.funcion(c.contexto);
+    }
+    if (esperaMensaje.funcion && terminada) {
+        Continuacion c = esperaMensaje;
+        esperaMensaje.funcion = nullptr;
+        c.funcion(c.contexto);
+    }
+}
+
+bool SesionAsincrona::atenderLectura() {
+    if (terminada || !lector) {
+        return false;
+    }
+
+    // Sin lugar en memoria para el mensaje, los bytes esperan en el puerto al próximo aviso
+    ListaDeCarga& carga = decodificador.getCarga();
+    if (carga.excedePresupuesto() && !carga.aliviarPresupuesto()) {
+        RegistroMetricas::global().sumar(METRICA_ESPERAS_PRESUPUESTO, 1);
+        return true;
+    }
+
+    int leidos = lector->rellenar(0);
+    if (leidos < 0) {
+        // El puerto se cerró: procesar una última línea sin fin de línea
+        const char* linea;
+        int longitud;
+        if (lector->extraerResto(linea, longitud)) {
+            decodificador.procesarLinea(linea, longitud);
+        }
+        terminar();
+    } else if (leidos > 0) {
+        decodificador.procesarLector(*lector);
+        if (decodificador.haTerminado()) {
+            terminar();
+        }
+    }
+
+    despertar();
+    return !terminada;
+}
+
+bool SesionAsincrona::alimentar(const char* datos, size_t longitud) {
+    if (terminada) {
+        return false;
+    }
+    if (!decodificador.alimentar(datos, longitud)) {
+        terminar();
+    }
+    despertar();
+    return !terminada;
+}
+
+void SesionAsincrona::cerrar() {
+    if (!terminada) {
+        if (lector) {
+            const char* linea;
+            int longitud;
+            if (lector->extraerResto(linea, longitud)) {
+                decodificador.procesarLinea(linea, longitud);
+            }
+        }
+        decodificador.finalizar();
+        terminar();
+    }
+    despertar();
+}
+
+bool SesionAsincrona::extraerTrama(Trama& destino) {
+    if (usadosCola == 0) {
+        return false;
+    }
+    destino = cola[primeraCola];
+    primeraCola = (primeraCola + 1) % capacidadCola;
+    usadosCola--;
+    return true;
+}
+
+bool SesionAsincrona::esperarTrama(Continuacion c) {
+    if (usadosCola > 0 || terminada) {
+        return false;
+    }
+    esperaTrama = c;
+    return true;
+}
+
+bool SesionAsincrona::esperarMensaje(Continuacion c) {
+    if (terminada) {
+        return false;
+    }
+    esperaMensaje = c;
+    return true;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file SumideroCarga.cpp
+ * @brief Implementación de los sumideros de archivo y de socket
+ */
+
+#include "prt7/SumideroCarga.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+    #include <ws2tcpip.h>
+#else
+    #include <netdb.h>
+    #include <sys/socket.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+#endif
+
+// ============================================================================
+// SUMIDERO DE ARCHIVO
+// ============================================================================
+
+SumideroArchivo::~SumideroArchivo() {
+    if (!archivo) return;
+
+    fflush(archivo);
+    if (propio) {
+        fclose(archivo);
+    }
+}
+
+bool SumideroArchivo::abrir(const char* ruta, bool agregar) {
+    if (strcmp(ruta, "-") == 0) {
+        archivo = stdout;
+        propio = false;
+    } else {
+        archivo = fopen(ruta, agregar ? "ab" : "wb");
+        propio = true;
+    }
+    return archivo != nullptr;
+}
+
+bool SumideroArchivo::escribir(const char* datos, size_t cantidad) {
+    if (!archivo) {
+        return false;
+    }
+    // Con buffer, un error de escritura puede llegar sólo como ferror()
+    bool correcto = fwrite(datos, 1, cantidad, archivo) == cantidad && !ferror(archivo);
+    // Limpiarlo para que un reintento (ej. disco con lugar otra vez) pueda funcionar
+    clearerr(archivo);
+    return correcto;
+}
+
+void SumideroArchivo::vaciar() {
+    if (archivo) {
+        fflush(archivo);
+    }
+}
+
+// ============================================================================
+// SUMIDERO DE SOCKET
+// ============================================================================
+
+#ifdef _WIN32
+
+SumideroSocket::SumideroSocket() : conexion(INVALID_SOCKET) {}
+
+SumideroSocket::~SumideroSocket() {
+    if (conexion != INVALID_SOCKET) {
+        closesocket(conexion);
+        WSACleanup();
+    }
+}
+
+bool SumideroSocket::conectar(const char* host, const char* puerto) {
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+        return false;
+    }
+
+    struct addrinfo pistas;
+    memset(&pistas, 0, sizeof(pistas));
+    pistas.ai_family = AF_UNSPEC;
+    pistas.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* direcciones = nullptr;
+    if (getaddrinfo(host, puerto, &pistas, &direcciones) != 0) {
+        WSACleanup();
+        return false;
+    }
+
+    for (struct addrinfo* d = direcciones; d && conexion == INVALID_SOCKET; d = d->ai_next) {
+        conexion = socket(d->ai_family, d->ai_socktype, d->ai_protocol);
+        if (conexion != INVALID_SOCKET && connect(conexion, d->ai_addr, static_cast<int>(d->ai_addrlen)) != 0) {
+            closesocket(conexion);
+            conexion = INVALID_SOCKET;
+        }
+    }
+    freeaddrinfo(direcciones);
+
+    if (conexion == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+    return true;
+}
+
+bool SumideroSocket::escribir(const char* datos, size_t cantidad) {
+    while (cantidad > 0 && conexion != INVALID_SOCKET) {
+        int enviados = send(conexion, datos, static_cast<int>(cantidad), 0);
+        if (enviados <= 0) {
+            return false;
+        }
+        datos += enviados;
+        cantidad -= enviados;
+    }
+    return cantidad == 0;
+}
+
+#else
+
+SumideroSocket::SumideroSocket() : conexion(-1) {}
+
+SumideroSocket::~SumideroSocket() {
+    if (conexion >= 0) {
+        close(conexion);
+    }
+}
+
+bool SumideroSocket::conectar(const char* host, const char* puerto) {
+    struct addrinfo pistas;
+    memset(&pistas, 0, sizeof(pistas));
+    pistas.ai_family = AF_UNSPEC;
+    pistas.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* direcciones = nullptr;
+    if (getaddrinfo(host, puerto, &pistas, &direcciones) != 0) {
+        return false;
+    }
+
+    for (struct addrinfo* d = direcciones; d && conexion < 0; d = d->ai_next) {
+        conexion = socket(d->ai_family, d->ai_socktype, d->ai_protocol);
+        if (conexion >= 0 && connect(conexion, d->ai_addr, d->ai_addrlen) != 0) {
+            close(conexion);
+            conexion = -1;
+        }
+    }
+    freeaddrinfo(direcciones);
+
+    return conexion >= 0;
+}
+
+bool SumideroSocket::escribir(const char* datos, size_t cantidad) {
+    #ifdef MSG_NOSIGNAL
+        const int banderas = MSG_NOSIGNAL;  // Sin SIGPIPE si el receptor se desconecta
+    #else
+        const int banderas = 0;
+    #endif
+
+    while (cantidad > 0 && conexion >= 0) {
+        ssize_t enviados = send(conexion, datos, cantidad, banderas);
+        if (enviados <= 0) {
+            return false;
+        }
+        datos += enviados;
+        cantidad -= static_cast<size_t>(enviados);
+    }
+    return cantidad == 0;
+}
+
+#endif
+
+// ============================================================================
+// FÁBRICA
+// ============================================================================
+
+SumideroCarga* crearSumidero(const char* especificacion) {
+    if (strcmp(especificacion, "stdout") == 0) {
+        SumideroArchivo* s = new SumideroArchivo();
+        s->abrir("-", true);
+        return s;
+    }
+
+    if (strncmp(especificacion, "file:", 5) == 0 && especificacion[5] != '\0') {
+        SumideroArchivo* s = new SumideroArchivo();
+        if (!s->abrir(especificacion + 5, true)) {
+            delete s;
+            return nullptr;
+        }
+        return s;
+    }
+
+    if (strncmp(especificacion, "tcp:", 4) == 0) {
+        // tcp:<host>:<puerto>; el último ':' separa el puerto
+        const char* host = especificacion + 4;
+        const char* separador = strrchr(host, ':');
+        if (!separador || separador == host || separador[1] == '\0') {
+            return nullptr;
+        }
+
+        char nombre[256];
+        size_t largo = static_cast<size_t>(separador - host);
+        if (largo >= sizeof(nombre)) {
+            return nullptr;
+        }
+        memcpy(nombre, host, largo);
+        nombre[largo] = '\0';
+
+        SumideroSocket* s = new SumideroSocket();
+        if (!s->conectar(nombre, separador + 1)) {
+            delete s;
+            return nullptr;
+        }
+        return s;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file Trama.cpp
+ * @brief Reportes de tramas y tramas polimórficas LOAD/MAP
+ */
+
+#include "prt7/Trama.h"
+
+void reportarCarga(char caracter, char decodificado, ListaDeCarga* carga, EscritorSalida& salida) {
+    salida.escribir("Trama recibida: [L,");
+    salida.escribirCaracter(caracter);
+    salida.escribir("] -> Procesando... -> Fragmento '");
+    salida.escribirCaracter(caracter);
+    salida.escribir("' decodificado como '");
+    salida.escribirCaracter(decodificado);
+
+    if (salida.getNivel() == DETALLE_TRAZA) {
+        salida.escribir("'. Mensaje: ");
+        carga->imprimirConFormato(salida);
+        salida.escribirCaracter('\n');
+    } else {
+        salida.escribir("'.\n");
+    }
+}
+
+void reportarMapeo(int rotacion, EscritorSalida& salida, int rotor) {
+    salida.escribir("\nTrama recibida: [M,");
+    if (rotor != 0) {
+        salida.escribirEntero(rotor);
+        salida.escribirCaracter(',');
+    }
+    salida.escribirEntero(rotacion);
+    salida.escribir("] -> Procesando... -> ROTANDO ROTOR ");
+    if (rotor != 0) {
+        salida.escribirEntero(rotor);
+        salida.escribirCaracter(' ');
+    }
+    if (rotacion >= 0) {
+        salida.escribirCaracter('+');
+    }
+    salida.escribirEntero(rotacion);
+    salida.escribir(".\n\n");
+}
+
+void TramaLoad::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
+    procesarCarga(caracter, carga, rotor, EscritorSalida::predeterminado());
+}
+
+void TramaMap::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
+    (void)carga;
+    procesarMapeo(rotacion, rotor, EscritorSalida::predeterminado());
+}
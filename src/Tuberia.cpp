@@ -0,0 +1,264 @@
+/**
+ * @file Tuberia.cpp
+ * @brief Implementación de la decodificación en tres etapas
+ */
+
+#include "prt7/Tuberia.h"
+#include "prt7/AnalizadorTramas.h"
+#include "prt7/ColaSPSC.h"
+#include "prt7/Metricas.h"
+#include "prt7/SumideroCarga.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+/// Tramas por lote entre etapas
+static const int TAMANO_LOTE = 64;
+
+/// Lotes que caben en cada cola
+static const int LOTES_POR_COLA = 256;
+
+/**
+ * @struct LoteTramas
+ * @brief Tramas analizadas por el lector
+ */
+struct LoteTramas {
+    Trama tramas[TAMANO_LOTE];  ///< Tramas válidas en orden
+    int cantidad;               ///< Tramas ocupadas (-1 marca el fin del flujo)
+    int malformadas;            ///< Líneas descartadas al armar el lote
+    long long instante;         ///< Lectura de la que salió el lote (relojMonotonicoNs())
+};
+
+/**
+ * @struct EventoTrama
+ * @brief Trama ya procesada, con lo necesario para reportarla
+ */
+struct EventoTrama {
+    Trama trama;        ///< Trama procesada
+    char decodificado;  ///< Carácter que produjo una trama LOAD
+};
+
+/**
+ * @struct LoteEventos
+ * @brief Eventos pendientes de reportar
+ */
+struct LoteEventos {
+    EventoTrama eventos[TAMANO_LOTE];  ///< Eventos en orden
+    int cantidad;                      ///< Eventos ocupados (-1 marca el fin del flujo)
+};
+
+typedef ColaSPSC<LoteTramas, LOTES_POR_COLA> ColaTramas;    ///< Lector -> decodificador
+typedef ColaSPSC<LoteEventos, LOTES_POR_COLA> ColaEventos;  ///< Decodificador -> escritor
+
+/**
+ * @brief Etapa 1: vacía el lector en lotes de tramas
+ */
+static void etapaLector(LectorSerial& lector, int timeoutMs, int inactividadMs, ColaTramas& salida,
+                        std::atomic<bool>& detener, unsigned long long& lotes) {
+    LoteTramas lote;
+    PlazoInactividad plazo(inactividadMs);
+
+    while (!detener.load(std::memory_order_relaxed)) {
+        int leidos = lector.rellenar(plazo.acotarEspera(timeoutMs));
+        if (leidos > 0) {
+            plazo.registrarActividad();
+        }
+        if (leidos < 0 || (leidos == 0 && plazo.vencido())) {
+            // Fin de datos o emisor inactivo: entregar una última línea sin fin de línea
+            const char* linea;
+            int longitud;
+            lote.cantidad = 0;
+            lote.malformadas = 0;
+            lote.instante = lector.getInstanteLectura();
+            if (lector.extraerResto(linea, longitud)) {
+                ErrorTrama resultado = analizarTrama(linea, longitud, lote.tramas[0]);
+                if (resultado == TRAMA_VALIDA) {
+                    lote.cantidad = 1;
+                } else if (resultado != TRAMA_COMENTARIO) {
+                    lote.malformadas = 1;
+                }
+                salida.encolar(lote);
+                lotes++;
+            }
+            break;
+        }
+
+        for (;;) {
+            lote.malformadas = 0;
+            lote.cantidad = lector.extraerTramas(lote.tramas, TAMANO_LOTE, lote.malformadas);
+            lote.instante = lector.getInstanteLectura();
+            if (lote.cantidad == 0 && lote.malformadas == 0) {
+                break;
+            }
+            salida.encolar(lote);
+            lotes++;
+        }
+    }
+
+    lote.cantidad = -1;
+    lote.malformadas = 0;
+    lote.instante = 0;
+    salida.encolar(lote);
+}
+
+/**
+ * @brief Etapa 2: aplica el rotor y la lista de carga a cada trama
+ */
+static void etapaDecodificador(Decodificador& decodificador, bool reportar, ColaTramas& entrada,
+                               ColaEventos& salida, std::atomic<bool>& detener) {
+    LoteTramas lote;
+    LoteEventos eventos;
+    eventos.cantidad = 0;
+
+    for (;;) {
+        // Mientras la carga no vuelva a su presupuesto la cola se llena y el lector espera
+        if (decodificador.getCarga().excedePresupuesto()) {
+            decodificador.esperarPresupuesto();
+        }
+        entrada.desencolar(lote);
+        if (lote.cantidad < 0) {
+            break;
+        }
+        decodificador.contarMalformadas(lote.malformadas);
+
+        if (!reportar) {
+            // Sin reportes el lote entero va de una vez por el camino en bloque
+            // (mapearBloque, rotaciones netas, rellenos), igual que en alimentar()
+            decodificador.procesarTramas(lote.tramas, lote.cantidad);
+        }
+        for (int i = 0; reportar && i < lote.cantidad && !decodificador.haTerminado(); i++) {
+            const Trama& trama = lote.tramas[i];
+            EventoTrama& evento = eventos.eventos[eventos.cantidad];
+            evento.trama = trama;
+            evento.decodificado = trama.tipo == TRAMA_LOAD ? decodificador.getRotor().getMapeo(trama.caracter) : 0;
+
+            long long antes = decodificador.getTramasRecibidas();
+            decodificador.procesarTramas(&trama, 1);
+            if (decodificador.getTramasRecibidas() == antes) {
+                // Trama rechazada (rotor inexistente): no se reporta
+                continue;
+            }
+
+            if (reportar && ++eventos.cantidad == TAMANO_LOTE) {
+                salida.encolar(eventos);
+                eventos.cantidad = 0;
+            }
+        }
+
+        if (eventos.cantidad > 0) {
+            salida.encolar(eventos);
+            eventos.cantidad = 0;
+        }
+
+        RegistroMetricas& metricas = RegistroMetricas::global();
+        decodificador.publicarMetricas();
+        if (lote.instante != 0) {
+            metricas.registrarLatencia(relojMonotonicoNs() - lote.instante);
+        }
+        metricas.fijar(INDICADOR_COLA_TRAMAS, static_cast<long long>(entrada.getOcupacion()));
+        metricas.fijar(INDICADOR_COLA_EVENTOS, static_cast<long long>(salida.getOcupacion()));
+
+        if (decodificador.haTerminado()) {
+            // El lector deja de leer; se siguen drenando sus lotes hasta el fin
+            detener.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    eventos.cantidad = -1;
+    salida.encolar(eventos);
+}
+
+/**
+ * @class SumideroDescarte
+ * @brief Acepta y olvida lo que la copia del escritor retira de la memoria
+ */
+class SumideroDescarte : public SumideroCarga {
+public:
+    bool escribir(const char*, size_t) override {
+        return true;
+    }
+};
+
+/**
+ * @brief Etapa 3: da formato a los reportes
+ * @param salida Escritor de los reportes
+ * @param entrada Eventos del decodificador
+ * @param espejo Copia de la lista de carga para el nivel de traza
+ *
+ * El nivel de traza imprime el mensaje acumulado en cada trama; el escritor
+ * mantiene su propia copia de la lista para no tocar la del decodificador.
+ */
+static void etapaEscritor(EscritorSalida& salida, ColaEventos& entrada, ListaDeCarga& espejo) {
+    LoteEventos lote;
+
+    for (;;) {
+        if (!entrada.intentarDesencolar(lote)) {
+            // Cola vacía: mostrar lo acumulado antes de esperar
+            salida.vaciar();
+            entrada.desencolar(lote);
+        }
+        if (lote.cantidad < 0) {
+            break;
+        }
+
+        for (int i = 0; i < lote.cantidad; i++) {
+            const EventoTrama& evento = lote.eventos[i];
+            if (evento.trama.tipo == TRAMA_LOAD) {
+                if (salida.getNivel() == DETALLE_TRAZA) {
+                    espejo.insertarAlFinal(evento.decodificado);
+                }
+                reportarCarga(evento.trama.caracter, evento.decodificado, &espejo, salida);
+            } else if (evento.trama.tipo == TRAMA_MAP) {
+                reportarMapeo(evento.trama.rotacion, salida, evento.trama.rotor);
+            }
+        }
+    }
+
+    salida.vaciar();
+}
+
+void decodificarEnTuberia(LectorSerial& lector, Decodificador& decodificador, int timeoutMs,
+                          int inactividadMs, EstadisticasTuberia& estadisticas) {
+    // El decodificador deja de reportar; lo hace la etapa de escritura
+    EscritorSalida& salidaOriginal = decodificador.getSalida();
+    NivelDetalle nivel = salidaOriginal.getNivel();
+    salidaOriginal.vaciar();
+    salidaOriginal.setNivel(DETALLE_SILENCIOSO);
+
+    ColaTramas* tramas = new ColaTramas();
+    ColaEventos* eventos = new ColaEventos();
+    RegistroMetricas::global().sumar(METRICA_ASIGNACIONES, 2);
+    RegistroMetricas::global().sumar(METRICA_BYTES_ASIGNADOS, sizeof(ColaTramas) + sizeof(ColaEventos));
+    EscritorSalida* escritor = new EscritorSalida(nivel, salidaOriginal.getDestino());
+    std::atomic<bool> detener(false);
+    unsigned long long lotes = 0;
+
+    std::thread lectorHilo(etapaLector, std::ref(lector), timeoutMs, inactividadMs, std::ref(*tramas),
+                           std::ref(detener), std::ref(lotes));
+    // La copia del escritor retira los mismos nodos que la lista real (--window,
+    // --memory-budget), así que la traza no crece sin límite; no cuenta en las métricas
+    SumideroDescarte descarte;
+    ListaDeCarga espejo;
+    espejo.setContabilizada(false);
+    espejo.imitarRetencion(decodificador.getCarga(), &descarte);
+    std::thread escritorHilo(etapaEscritor, std::ref(*escritor), std::ref(*eventos), std::ref(espejo));
+
+    etapaDecodificador(decodificador, nivel != DETALLE_SILENCIOSO, *tramas, *eventos, detener);
+
+    lectorHilo.join();
+    escritorHilo.join();
+    decodificador.getCarga().vaciarSumidero();
+
+    estadisticas.lotesLeidos += lotes;
+    estadisticas.esperasLector += tramas->getEsperasLlena();
+    estadisticas.esperasDecodificador += eventos->getEsperasLlena();
+    estadisticas.esperasEscritor += eventos->getEsperasVacia();
+
+    delete escritor;
+    delete eventos;
+    delete tramas;
+    RegistroMetricas::global().fijar(INDICADOR_COLA_TRAMAS, 0);
+    RegistroMetricas::global().fijar(INDICADOR_COLA_EVENTOS, 0);
+    salidaOriginal.setNivel(nivel);
+}